@@ -28,6 +28,17 @@
 #define CLAY_WASM_EXPORT(null)
 #endif
 
+// Each thread has its own current Clay_Context, define CLAY_DISABLE_THREAD_LOCAL on platforms without thread local storage
+#if defined(CLAY_WASM) || defined(CLAY_DISABLE_THREAD_LOCAL)
+#define CLAY__THREAD_LOCAL
+#elif defined(__cplusplus)
+#define CLAY__THREAD_LOCAL thread_local
+#elif defined(_MSC_VER)
+#define CLAY__THREAD_LOCAL __declspec(thread)
+#else
+#define CLAY__THREAD_LOCAL _Thread_local
+#endif
+
 // Public Macro API ------------------------
 
 #ifdef __cplusplus
@@ -85,13 +96,13 @@
 
 #define CLAY_ID_LOCAL(label) CLAY_IDI_LOCAL(label, 0)
 
-#define CLAY_IDI_LOCAL(label, index) Clay__AttachId(Clay__HashString(CLAY_STRING(label), Clay_LayoutElementArray_Get(&Clay__layoutElements, Clay__int32_tArray_Get(&Clay__openLayoutElementStack, Clay__openLayoutElementStack.length - 2))->children.length + 1, Clay__GetOpenLayoutElement()->id))
+#define CLAY_IDI_LOCAL(label, index) Clay__AttachId(Clay__HashString(CLAY_STRING(label), Clay__GetParentElementChildCount() + 1, Clay__GetOpenLayoutElementId()))
 
 #define CLAY__STRING_LENGTH(s) ((sizeof(s) / sizeof((s)[0])) - sizeof((s)[0]))
 
 #define CLAY_STRING(string) CLAY__INIT(Clay_String) { .length = CLAY__STRING_LENGTH(string), .chars = (string) }
 
-static int CLAY__ELEMENT_DEFINITION_LATCH = 0;
+static CLAY__THREAD_LOCAL int CLAY__ELEMENT_DEFINITION_LATCH = 0;
 
 #define CLAY__ELEMENT_INTERNAL(...) \
 	for (\
@@ -279,11 +290,31 @@ typedef struct
     uint16_t letterSpacing;
     uint16_t lineHeight;
     Clay_TextElementConfigWrapMode wrapMode;
+    bool hashStringContents; // Cache measurements by the contents of the string rather than its address, for text that is rebuilt in a new buffer every frame
     #ifdef CLAY_EXTEND_CONFIG_TEXT
     CLAY_EXTEND_CONFIG_TEXT
     #endif
 } Clay_TextElementConfig;
 
+typedef struct
+{
+    uint32_t first;
+    uint32_t second;
+    float adjustment; // Added to the advance of the first codepoint when it is followed by the second
+} Clay_FontKerningPair;
+
+// All sizes are in the units of a font rendered at baseSize, and are scaled to the fontSize of each text element
+typedef struct
+{
+    float baseSize;
+    float lineHeight;
+    const float *advances; // Advance width of every codepoint from 0 to advanceCount - 1
+    uint32_t advanceCount;
+    float fallbackAdvance; // Used for codepoints outside the advance table
+    const Clay_FontKerningPair *kerningPairs; // Must be sorted by first, then by second
+    uint32_t kerningPairCount;
+} Clay_FontMetrics;
+
 // Image
 typedef struct
 {
@@ -393,6 +424,39 @@ typedef struct
     bool found;
 } Clay_ScrollContainerData;
 
+typedef struct
+{
+    uint32_t itemCount;
+    // The size of every item along the scroll axis. When itemExtentFunction is provided, this is only used as an estimate for the items that haven't been scrolled past yet.
+    float itemExtent;
+    // Optional, for items of different sizes. An item's extent shouldn't change while its list is declared.
+    float (*itemExtentFunction)(uint32_t itemIndex, uintptr_t userData);
+    uintptr_t userData;
+    uint32_t overscan; // Items to declare on each side of the visible ones, so that fast scrolling doesn't reveal gaps before the next layout
+} Clay_VirtualListConfig;
+
+typedef struct
+{
+    uint32_t startIndex;
+    uint32_t endIndex; // One past the last item to declare
+} Clay_VirtualListRange;
+
+typedef struct
+{
+    uint32_t length;
+    Clay_ElementId *internalArray;
+} Clay_ElementIdArraySlice;
+
+typedef struct
+{
+    Clay_Vector2 position;
+    // Every element under the point, in the same order as Clay_SetPointerState would find them.
+    // Points into memory owned by clay, which is reused by the next call to Clay_HitTestPoints or Clay_BeginLayout.
+    Clay_ElementIdArraySlice pointerOverIds;
+    // The floating element that captured the point with CLAY_POINTER_CAPTURE_MODE_CAPTURE, or an id of 0 if no element captured it.
+    Clay_ElementId capturingElementId;
+} Clay_PointHitTestResult;
+
 typedef enum {
     CLAY_RENDER_COMMAND_TYPE_NONE,
     CLAY_RENDER_COMMAND_TYPE_RECTANGLE,
@@ -411,6 +475,7 @@ typedef struct
     Clay_String text; // TODO I wish there was a way to avoid having to have this on every render command
     uint32_t id;
     Clay_RenderCommandType commandType;
+    uint32_t zIndex; // The zIndex of the floating container the command belongs to, or 0 for the main layout. Render commands are ordered by zIndex
 } Clay_RenderCommand;
 
 typedef struct
@@ -420,6 +485,77 @@ typedef struct
 	Clay_RenderCommand *internalArray;
 } Clay_RenderCommandArray;
 
+typedef union
+{
+    Clay_ElementConfigUnion config; // Every command type except CLAY_RENDER_COMMAND_TYPE_TEXT
+    uint32_t textIndex; // CLAY_RENDER_COMMAND_TYPE_TEXT, an index into Clay_CompactRenderCommands.texts
+} Clay_CompactRenderCommandPayload;
+
+// The same information as Clay_RenderCommand, without the text field that only text commands use
+typedef struct
+{
+    Clay_BoundingBox boundingBox;
+    Clay_CompactRenderCommandPayload payload;
+    uint32_t id;
+    uint16_t commandType; // Clay_RenderCommandType
+    uint16_t zIndex;
+} Clay_CompactRenderCommand;
+
+typedef struct
+{
+    Clay_String text;
+    Clay_TextElementConfig *config;
+} Clay_CompactRenderCommandText;
+
+typedef struct
+{
+	uint32_t capacity;
+	uint32_t length;
+	Clay_CompactRenderCommand *internalArray;
+} Clay_CompactRenderCommandArray;
+
+typedef struct
+{
+	uint32_t capacity;
+	uint32_t length;
+	Clay_CompactRenderCommandText *internalArray;
+} Clay_CompactRenderCommandTextArray;
+
+typedef struct
+{
+    Clay_CompactRenderCommandArray commands;
+    Clay_CompactRenderCommandTextArray texts;
+} Clay_CompactRenderCommands;
+
+typedef enum {
+    CLAY_RENDER_COMMAND_DELTA_ADDED,
+    CLAY_RENDER_COMMAND_DELTA_MODIFIED,
+    CLAY_RENDER_COMMAND_DELTA_REMOVED,
+} Clay_RenderCommandDeltaType;
+
+typedef struct
+{
+    Clay_RenderCommandDeltaType deltaType;
+    Clay_RenderCommandType commandType;
+    uint32_t id;
+    int32_t renderCommandIndex; // Index of the command in this frame's render commands, or -1 if it was removed
+    Clay_BoundingBox previousBoundingBox; // The command's bounding box last frame, if it was modified or removed
+} Clay_RenderCommandDelta;
+
+typedef struct
+{
+	uint32_t capacity;
+	uint32_t length;
+	Clay_RenderCommandDelta *internalArray;
+} Clay_RenderCommandDeltaArray;
+
+typedef struct
+{
+	uint32_t capacity;
+	uint32_t length;
+	Clay_BoundingBox *internalArray;
+} Clay_DamageRectArray;
+
 typedef enum
 {
     CLAY_POINTER_DATA_PRESSED_THIS_FRAME,
@@ -441,6 +577,7 @@ typedef enum {
     CLAY_ERROR_TYPE_TEXT_MEASUREMENT_CAPACITY_EXCEEDED,
     CLAY_ERROR_TYPE_DUPLICATE_ID,
     CLAY_ERROR_TYPE_FLOATING_CONTAINER_PARENT_NOT_FOUND,
+    CLAY_ERROR_TYPE_VIRTUAL_LIST_PARENT_NOT_SCROLLING,
     CLAY_ERROR_TYPE_INTERNAL_ERROR,
 } Clay_ErrorType;
 
@@ -457,12 +594,117 @@ typedef struct
     uintptr_t userData;
 } Clay_ErrorHandler;
 
+typedef struct
+{
+    uint32_t hitCount; // Words this frame whose dimensions were already known
+    uint32_t missCount; // Words this frame that had to be measured by the MeasureText function
+} Clay_MeasureWordCacheStats;
+
+typedef struct
+{
+    uint32_t capacity;
+    uint32_t length; // Items in use at the end of the most recent layout
+    uint32_t peakLength; // The most items in use at the end of any layout since the context was created
+} Clay_ArrayMemoryStats;
+
+typedef struct
+{
+    uint32_t bucketCount;
+    uint32_t usedBucketCount;
+    uint32_t itemCount;
+    uint32_t maxChainLength;
+    float averageChainLength; // Average length of the chains in used buckets
+} Clay_HashMapMemoryStats;
+
+typedef struct
+{
+    // Counted since the context was created
+    uint64_t hitCount;
+    uint64_t missCount;
+    uint64_t evictionCount;
+} Clay_CacheMemoryStats;
+
+typedef struct
+{
+    uintptr_t arenaCapacity;
+    uintptr_t arenaUsed; // Bytes allocated from the arena, including ephemeral memory
+    uintptr_t persistentMemorySize; // Bytes that are kept between frames, at the start of arenaUsed
+    // Ephemeral arrays, reset every frame
+    Clay_ArrayMemoryStats layoutElements;
+    Clay_ArrayMemoryStats renderCommands;
+    Clay_ArrayMemoryStats wrappedTextLines;
+    Clay_ArrayMemoryStats layoutConfigs;
+    Clay_ArrayMemoryStats elementConfigs;
+    Clay_ArrayMemoryStats textElementData;
+    Clay_ArrayMemoryStats layoutElementIdStrings;
+    Clay_ArrayMemoryStats dynamicStringData;
+    Clay_ArrayMemoryStats renderCommandDeltas;
+    Clay_ArrayMemoryStats warnings;
+    // Persistent arrays
+    Clay_ArrayMemoryStats layoutElementsHashMapInternal;
+    Clay_ArrayMemoryStats measureTextHashMapInternal;
+    Clay_ArrayMemoryStats measuredWords;
+    Clay_ArrayMemoryStats measureWordHashMapInternal;
+    Clay_ArrayMemoryStats wrappedLineCache;
+    Clay_ArrayMemoryStats scrollContainerDatas;
+    Clay_HashMapMemoryStats layoutElementsHashMap;
+    Clay_HashMapMemoryStats measureTextHashMap;
+    Clay_HashMapMemoryStats measureWordHashMap;
+    uint64_t layoutElementsHashMapEvictionCount; // Entries for elements that stopped being declared, recycled since the context was created
+    Clay_CacheMemoryStats measureTextCache;
+    Clay_CacheMemoryStats measureWordCache;
+} Clay_MemoryStats;
+
+typedef struct
+{
+    // Must call jobFunction(jobData, jobIndex) exactly once for every jobIndex in [0, jobCount), from any number of threads,
+    // and may only return once every call has completed.
+    void (*parallelForFunction)(void (*jobFunction)(void *jobData, int32_t jobIndex), void *jobData, int32_t jobCount, uintptr_t userData);
+    uintptr_t userData;
+} Clay_ParallelLayoutHandler;
+
+typedef struct
+{
+    // Called before clay uses the first `size` bytes of its arena, which must be made readable and writable (e.g. by committing
+    // pages of a reserved virtual address range). Return false if the memory can't be provided.
+    bool (*commitFunction)(void *memory, uintptr_t size, uintptr_t userData);
+    uintptr_t userData;
+} Clay_ArenaCommitHandler;
+
+// Capacities of the per-frame arrays that rarely need a slot for every element. A value of 0 means the max element count.
+typedef struct
+{
+    uint32_t rectangleElementConfigs;
+    uint32_t textElementConfigs;
+    uint32_t imageElementConfigs;
+    uint32_t floatingElementConfigs;
+    uint32_t scrollElementConfigs;
+    uint32_t customElementConfigs;
+    uint32_t borderElementConfigs;
+    uint32_t imageElementPointers;
+    uint32_t textElementData;
+    uint32_t wrappedTextLines;
+    uint32_t layoutElementTreeRoots;
+    uint32_t dynamicStringData; // Bytes, mostly used by the debug view
+    uint32_t measureTextBatchWords; // Only allocated while a batch measure text function is set
+    // Resize the arrays above at the start of each frame based on how full they were in the previous frame. They never
+    // shrink below the capacities above, and only grow into space that is left over at the end of the arena.
+    bool adaptive;
+} Clay_EphemeralCapacities;
+
+// Holds all of the state for one layout. Contexts are independent of each other, so separate contexts can be used from separate threads concurrently.
+typedef struct Clay_Context Clay_Context;
+
 // Function Forward Declarations ---------------------------------
 // Public API functions ---
 uint32_t Clay_MinMemorySize(void);
 Clay_Arena Clay_CreateArenaWithCapacityAndMemory(uint32_t capacity, void *offset);
 void Clay_SetPointerState(Clay_Vector2 position, bool pointerDown);
-void Clay_Initialize(Clay_Arena arena, Clay_Dimensions layoutDimensions, Clay_ErrorHandler errorHandler);
+void Clay_HitTestPoints(Clay_Vector2 *points, int32_t count, Clay_PointHitTestResult *results);
+Clay_Context* Clay_Initialize(Clay_Arena arena, Clay_Dimensions layoutDimensions, Clay_ErrorHandler errorHandler);
+Clay_Context* Clay_CreateContext(Clay_Arena arena, Clay_Dimensions layoutDimensions, Clay_ErrorHandler errorHandler);
+Clay_Context* Clay_GetCurrentContext(void);
+void Clay_SetCurrentContext(Clay_Context* context);
 void Clay_UpdateScrollContainers(bool enableDragScrolling, Clay_Vector2 scrollDelta, float deltaTime);
 void Clay_SetLayoutDimensions(Clay_Dimensions dimensions);
 void Clay_BeginLayout(void);
@@ -472,13 +714,36 @@ Clay_ElementId Clay_GetElementIdWithIndex(Clay_String idString, uint32_t index);
 bool Clay_Hovered(void);
 void Clay_OnHover(void (*onHoverFunction)(Clay_ElementId elementId, Clay_PointerData pointerData, intptr_t userData), intptr_t userData);
 bool Clay_PointerOver(Clay_ElementId elementId);
+Clay_ElementIdArraySlice Clay_GetPointerOverIds(void);
 Clay_ScrollContainerData Clay_GetScrollContainerData(Clay_ElementId id);
+Clay_VirtualListRange Clay_VirtualList(Clay_VirtualListConfig config);
+Clay_ElementId * Clay_ElementIdArraySlice_Get(Clay_ElementIdArraySlice* slice, int32_t index);
 void Clay_SetMeasureTextFunction(Clay_Dimensions (*measureTextFunction)(Clay_String *text, Clay_TextElementConfig *config));
+void Clay_SetMeasureTextBatchFunction(void (*measureTextBatchFunction)(Clay_String *words, Clay_TextElementConfig **configs, Clay_Dimensions *outDimensions, uint32_t count));
 void Clay_SetQueryScrollOffsetFunction(Clay_Vector2 (*queryScrollOffsetFunction)(uint32_t elementId));
+void Clay_RegisterFontMetrics(uint16_t fontId, Clay_FontMetrics metrics);
 Clay_RenderCommand * Clay_RenderCommandArray_Get(Clay_RenderCommandArray* array, int32_t index);
+Clay_RenderCommandDelta * Clay_RenderCommandDeltaArray_Get(Clay_RenderCommandDeltaArray* array, int32_t index);
+Clay_RenderCommandDeltaArray Clay_GetRenderCommandDeltas(void);
+Clay_CompactRenderCommand * Clay_CompactRenderCommandArray_Get(Clay_CompactRenderCommandArray* array, int32_t index);
+Clay_CompactRenderCommandText * Clay_CompactRenderCommandTextArray_Get(Clay_CompactRenderCommandTextArray* array, int32_t index);
+Clay_CompactRenderCommands Clay_GetCompactRenderCommands(void);
+void Clay_SetCompactRenderCommandsEnabled(bool enabled);
+void Clay_SetPointerHitGridEnabled(bool enabled);
+Clay_DamageRectArray Clay_GetDamageRects(void);
+void Clay_SetRenderCommandDeltasEnabled(bool enabled);
+void Clay_SetIdleFrameSkippingEnabled(bool enabled);
+bool Clay_LayoutUnchanged(void);
 void Clay_SetDebugModeEnabled(bool enabled);
 void Clay_SetCullingEnabled(bool enabled);
+void Clay_SetParallelLayoutHandler(Clay_ParallelLayoutHandler handler);
+void Clay_SetArenaCommitHandler(Clay_ArenaCommitHandler handler);
+void Clay_SetEphemeralCapacities(Clay_EphemeralCapacities capacities);
+Clay_MeasureWordCacheStats Clay_GetMeasureWordCacheStats(void);
+Clay_MemoryStats Clay_GetMemoryStats(void);
+uint32_t Clay_GetMaxElementCount(void);
 void Clay_SetMaxElementCount(uint32_t maxElementCount);
+uint32_t Clay_GetMaxMeasureTextCacheWordCount(void);
 void Clay_SetMaxMeasureTextCacheWordCount(uint32_t maxMeasureTextCacheWordCount);
 
 // Internal API functions required by macros
@@ -499,6 +764,8 @@ Clay_BorderElementConfig * Clay__StoreBorderElementConfig(Clay_BorderElementConf
 Clay_ElementId Clay__HashString(Clay_String key, uint32_t offset, uint32_t seed);
 void Clay__Noop(void);
 void Clay__OpenTextElement(Clay_String text, Clay_TextElementConfig *textConfig);
+uint32_t Clay__GetParentElementChildCount(void);
+uint32_t Clay__GetOpenLayoutElementId(void);
 
 extern Clay_Color Clay__debugViewHighlightColor;
 extern uint32_t Clay__debugViewWidth;
@@ -523,11 +790,16 @@ extern uint32_t Clay__debugViewWidth;
 #define CLAY__MAXFLOAT 3.40282346638528859812e+38F
 #endif
 
-bool Clay__warningsEnabled = true;
-uint32_t Clay__maxElementCount = 8192;
-uint32_t Clay__maxMeasureTextCacheWordCount = 16384;
+uint32_t Clay__defaultMaxElementCount = 8192;
+uint32_t Clay__defaultMaxMeasureTextCacheWordCount = 16384;
+// Grows when more scroll containers are declared than there's room for
+uint32_t Clay__defaultMaxScrollContainerCount = 32;
+Clay_ArenaCommitHandler Clay__defaultArenaCommitHandler = CLAY__INIT(Clay_ArenaCommitHandler) {};
+bool Clay__defaultCompactRenderCommandsEnabled = false;
+bool Clay__defaultRenderCommandDeltasEnabled = false;
+bool Clay__defaultPointerHitGridEnabled = false;
+Clay_EphemeralCapacities Clay__defaultEphemeralCapacities = CLAY__INIT(Clay_EphemeralCapacities) {};
 void Clay__ErrorHandlerFunctionDefault(Clay_ErrorData errorText) {}
-Clay_ErrorHandler Clay__errorHandler = CLAY__INIT(Clay_ErrorHandler) { .errorHandlerFunction = Clay__ErrorHandlerFunctionDefault };
 
 void Clay__Noop(void) {}
 
@@ -539,10 +811,9 @@ typedef struct
     bool maxElementsExceeded;
     bool maxRenderCommandsExceeded;
     bool maxTextMeasureCacheExceeded;
+    bool arrayCapacityExceeded;
 } Clay_BooleanWarnings;
 
-Clay_BooleanWarnings Clay__booleanWarnings;
-
 typedef struct
 {
     Clay_String baseMessage;
@@ -551,7 +822,9 @@ typedef struct
 
 Clay__Warning CLAY__WARNING_DEFAULT = CLAY__INIT(Clay__Warning) {};
 
+#ifdef _MSC_VER
 #pragma region generated
+#endif
 typedef struct
 {
 	uint32_t capacity;
@@ -559,27 +832,6 @@ typedef struct
 	Clay__Warning *internalArray;
 } Clay__WarningArray;
 
-Clay__WarningArray Clay__WarningArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    size_t totalSizeBytes = capacity * sizeof(Clay_String);
-    Clay__WarningArray array = CLAY__INIT(Clay__WarningArray){.capacity = capacity, .length = 0};
-    uintptr_t nextAllocAddress = arena->nextAllocation + (uintptr_t)arena->memory;
-    uintptr_t arenaOffsetAligned = nextAllocAddress + (CLAY__ALIGNMENT(Clay_String) - (nextAllocAddress % CLAY__ALIGNMENT(Clay_String)));
-    arenaOffsetAligned -= (uintptr_t)arena->memory;
-    if (arenaOffsetAligned + totalSizeBytes <= arena->capacity) {
-        array.internalArray = (Clay__Warning*)((uintptr_t)arena->memory + (uintptr_t)arenaOffsetAligned);
-        arena->nextAllocation = arenaOffsetAligned + totalSizeBytes;
-    }
-    else {
-        Clay__errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
-            .errorType = CLAY_ERROR_TYPE_ARENA_CAPACITY_EXCEEDED,
-            .errorText = CLAY_STRING("Clay attempted to allocate memory in its arena, but ran out of capacity. Try increasing the capacity of the arena passed to Clay_Initialize()"),
-            .userData = Clay__errorHandler.userData });
-    }
-    return array;
-}
-
-Clay__WarningArray Clay_warnings = CLAY__INIT(Clay__WarningArray) {};
-
 Clay__Warning *Clay__WarningArray_Add(Clay__WarningArray *array, Clay__Warning item)
 {
     if (array->length < array->capacity) {
@@ -589,53 +841,18 @@ Clay__Warning *Clay__WarningArray_Add(Clay__WarningArray *array, Clay__Warning i
     return &CLAY__WARNING_DEFAULT;
 }
 
-void* Clay__Array_Allocate_Arena(uint32_t capacity, uint32_t itemSize, uint32_t alignment, Clay_Arena *arena)
-{
-    size_t totalSizeBytes = capacity * itemSize;
-    uintptr_t nextAllocAddress = arena->nextAllocation + (uintptr_t)arena->memory;
-    uintptr_t arenaOffsetAligned = nextAllocAddress + (alignment - (nextAllocAddress % alignment));
-    arenaOffsetAligned -= (uintptr_t)arena->memory;
-    if (arenaOffsetAligned + totalSizeBytes <= arena->capacity) {
-        arena->nextAllocation = arenaOffsetAligned + totalSizeBytes;
-        return (void*)((uintptr_t)arena->memory + (uintptr_t)arenaOffsetAligned);
-    }
-    else {
-        Clay__errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
-                .errorType = CLAY_ERROR_TYPE_ARENA_CAPACITY_EXCEEDED,
-                .errorText = CLAY_STRING("Clay attempted to allocate memory in its arena, but ran out of capacity. Try increasing the capacity of the arena passed to Clay_Initialize()"),
-                .userData = Clay__errorHandler.userData });
-    }
-    return CLAY__NULL;
-}
-
-bool Clay__Array_RangeCheck(int index, uint32_t length)
-{
-    if (index < length && index >= 0) {
-        return true;
-    }
-    Clay__errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
-            .errorType = CLAY_ERROR_TYPE_INTERNAL_ERROR,
-            .errorText = CLAY_STRING("Clay attempted to make an out of bounds array access. This is an internal error and is likely a bug."),
-            .userData = Clay__errorHandler.userData });
-    return false;
-}
-
-bool Clay__Array_AddCapacityCheck(uint32_t length, uint32_t capacity)
-{
-    if (length < capacity) {
-        return true;
-    }
-    Clay__errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
-        .errorType = CLAY_ERROR_TYPE_INTERNAL_ERROR,
-        .errorText = CLAY_STRING("Clay attempted to make an out of bounds array access. This is an internal error and is likely a bug."),
-        .userData = Clay__errorHandler.userData });
-    return false;
-}
+Clay__WarningArray Clay__WarningArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena);
+void* Clay__Array_Allocate_Arena(uint32_t capacity, uint32_t itemSize, uint32_t alignment, Clay_Arena *arena);
+bool Clay__Array_RangeCheck(int index, uint32_t length);
+bool Clay__Array_AddCapacityCheck(uint32_t length, uint32_t capacity);
+bool Clay__EphemeralMemoryFits(Clay_Context *settings, Clay_String errorText);
 
 bool CLAY__BOOL_DEFAULT = false;
 
 // __GENERATED__ template array_define,array_allocate TYPE=bool NAME=Clay__BoolArray
+#ifdef _MSC_VER
 #pragma region generated
+#endif
 typedef struct
 {
 	uint32_t capacity;
@@ -643,15 +860,23 @@ typedef struct
 	bool *internalArray;
 } Clay__BoolArray;
 Clay__BoolArray Clay__BoolArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT(Clay__BoolArray){.capacity = capacity, .length = 0, .internalArray = (bool *)Clay__Array_Allocate_Arena(capacity, sizeof(bool), CLAY__ALIGNMENT(bool), arena)};
+    Clay__BoolArray array = CLAY__INIT(Clay__BoolArray){.capacity = capacity, .length = 0, .internalArray = (bool *)Clay__Array_Allocate_Arena(capacity, sizeof(bool), CLAY__ALIGNMENT(bool), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
 }
+#ifdef _MSC_VER
 #pragma endregion
+#endif
 // __GENERATED__ template
 
 Clay_ElementId CLAY__ELEMENT_ID_DEFAULT = CLAY__INIT(Clay_ElementId) {};
 
 // __GENERATED__ template array_define,array_allocate,array_get,array_add TYPE=Clay_ElementId NAME=Clay__ElementIdArray DEFAULT_VALUE=&CLAY__ELEMENT_ID_DEFAULT
+#ifdef _MSC_VER
 #pragma region generated
+#endif
 typedef struct
 {
 	uint32_t capacity;
@@ -659,7 +884,11 @@ typedef struct
 	Clay_ElementId *internalArray;
 } Clay__ElementIdArray;
 Clay__ElementIdArray Clay__ElementIdArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT(Clay__ElementIdArray){.capacity = capacity, .length = 0, .internalArray = (Clay_ElementId *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_ElementId), CLAY__ALIGNMENT(Clay_ElementId), arena)};
+    Clay__ElementIdArray array = CLAY__INIT(Clay__ElementIdArray){.capacity = capacity, .length = 0, .internalArray = (Clay_ElementId *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_ElementId), CLAY__ALIGNMENT(Clay_ElementId), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
 }
 Clay_ElementId *Clay__ElementIdArray_Get(Clay__ElementIdArray *array, int index) {
     return Clay__Array_RangeCheck(index, array->length) ? &array->internalArray[index] : &CLAY__ELEMENT_ID_DEFAULT;
@@ -671,13 +900,29 @@ Clay_ElementId *Clay__ElementIdArray_Add(Clay__ElementIdArray *array, Clay_Eleme
 	}
 	return &CLAY__ELEMENT_ID_DEFAULT;
 }
+#ifdef _MSC_VER
+#pragma endregion
+#endif
+// __GENERATED__ template
+
+// __GENERATED__ template array_get_slice TYPE=Clay_ElementId NAME=Clay_ElementIdArray DEFAULT_VALUE=&CLAY__ELEMENT_ID_DEFAULT
+#ifdef _MSC_VER
+#pragma region generated
+#endif
+Clay_ElementId *Clay_ElementIdArraySlice_Get(Clay_ElementIdArraySlice *slice, int index) {
+    return Clay__Array_RangeCheck(index, slice->length) ? &slice->internalArray[index] : &CLAY__ELEMENT_ID_DEFAULT;
+}
+#ifdef _MSC_VER
 #pragma endregion
+#endif
 // __GENERATED__ template
 
 Clay_ElementConfig CLAY__ELEMENT_CONFIG_DEFAULT = CLAY__INIT(Clay_ElementConfig) {};
 
 // __GENERATED__ template array_define,array_define_slice,array_allocate,array_get,array_add,array_get_slice TYPE=Clay_ElementConfig NAME=Clay__ElementConfigArray DEFAULT_VALUE=&CLAY__ELEMENT_CONFIG_DEFAULT
+#ifdef _MSC_VER
 #pragma region generated
+#endif
 typedef struct
 {
 	uint32_t capacity;
@@ -690,7 +935,11 @@ typedef struct
 	Clay_ElementConfig *internalArray;
 } Clay__ElementConfigArraySlice;
 Clay__ElementConfigArray Clay__ElementConfigArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT(Clay__ElementConfigArray){.capacity = capacity, .length = 0, .internalArray = (Clay_ElementConfig *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_ElementConfig), CLAY__ALIGNMENT(Clay_ElementConfig), arena)};
+    Clay__ElementConfigArray array = CLAY__INIT(Clay__ElementConfigArray){.capacity = capacity, .length = 0, .internalArray = (Clay_ElementConfig *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_ElementConfig), CLAY__ALIGNMENT(Clay_ElementConfig), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
 }
 Clay_ElementConfig *Clay__ElementConfigArray_Get(Clay__ElementConfigArray *array, int index) {
     return Clay__Array_RangeCheck(index, array->length) ? &array->internalArray[index] : &CLAY__ELEMENT_CONFIG_DEFAULT;
@@ -705,13 +954,17 @@ Clay_ElementConfig *Clay__ElementConfigArray_Add(Clay__ElementConfigArray *array
 Clay_ElementConfig *Clay__ElementConfigArraySlice_Get(Clay__ElementConfigArraySlice *slice, int index) {
     return Clay__Array_RangeCheck(index, slice->length) ? &slice->internalArray[index] : &CLAY__ELEMENT_CONFIG_DEFAULT;
 }
+#ifdef _MSC_VER
 #pragma endregion
+#endif
 // __GENERATED__ template
 
 Clay_LayoutConfig CLAY_LAYOUT_DEFAULT = CLAY__INIT(Clay_LayoutConfig){ .sizing = { .width = { .size = { .minMax = {0, CLAY__MAXFLOAT } }, .type = CLAY__SIZING_TYPE_FIT }, .height = { .size = { .minMax = {0, CLAY__MAXFLOAT } }, .type = CLAY__SIZING_TYPE_FIT } } };
 
 // __GENERATED__ template array_define,array_allocate,array_add TYPE=Clay_LayoutConfig NAME=Clay__LayoutConfigArray DEFAULT_VALUE=&CLAY_LAYOUT_DEFAULT
+#ifdef _MSC_VER
 #pragma region generated
+#endif
 typedef struct
 {
 	uint32_t capacity;
@@ -719,7 +972,11 @@ typedef struct
 	Clay_LayoutConfig *internalArray;
 } Clay__LayoutConfigArray;
 Clay__LayoutConfigArray Clay__LayoutConfigArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT(Clay__LayoutConfigArray){.capacity = capacity, .length = 0, .internalArray = (Clay_LayoutConfig *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_LayoutConfig), CLAY__ALIGNMENT(Clay_LayoutConfig), arena)};
+    Clay__LayoutConfigArray array = CLAY__INIT(Clay__LayoutConfigArray){.capacity = capacity, .length = 0, .internalArray = (Clay_LayoutConfig *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_LayoutConfig), CLAY__ALIGNMENT(Clay_LayoutConfig), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
 }
 Clay_LayoutConfig *Clay__LayoutConfigArray_Add(Clay__LayoutConfigArray *array, Clay_LayoutConfig item) {
 	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
@@ -728,13 +985,17 @@ Clay_LayoutConfig *Clay__LayoutConfigArray_Add(Clay__LayoutConfigArray *array, C
 	}
 	return &CLAY_LAYOUT_DEFAULT;
 }
+#ifdef _MSC_VER
 #pragma endregion
+#endif
 // __GENERATED__ template
 
 Clay_RectangleElementConfig CLAY__RECTANGLE_ELEMENT_CONFIG_DEFAULT = CLAY__INIT(Clay_RectangleElementConfig){{0}};
 
 // __GENERATED__ template array_define,array_allocate,array_add TYPE=Clay_RectangleElementConfig NAME=Clay__RectangleElementConfigArray DEFAULT_VALUE=&CLAY__RECTANGLE_ELEMENT_CONFIG_DEFAULT
+#ifdef _MSC_VER
 #pragma region generated
+#endif
 typedef struct
 {
 	uint32_t capacity;
@@ -742,7 +1003,11 @@ typedef struct
 	Clay_RectangleElementConfig *internalArray;
 } Clay__RectangleElementConfigArray;
 Clay__RectangleElementConfigArray Clay__RectangleElementConfigArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT(Clay__RectangleElementConfigArray){.capacity = capacity, .length = 0, .internalArray = (Clay_RectangleElementConfig *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_RectangleElementConfig), CLAY__ALIGNMENT(Clay_RectangleElementConfig), arena)};
+    Clay__RectangleElementConfigArray array = CLAY__INIT(Clay__RectangleElementConfigArray){.capacity = capacity, .length = 0, .internalArray = (Clay_RectangleElementConfig *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_RectangleElementConfig), CLAY__ALIGNMENT(Clay_RectangleElementConfig), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
 }
 Clay_RectangleElementConfig *Clay__RectangleElementConfigArray_Add(Clay__RectangleElementConfigArray *array, Clay_RectangleElementConfig item) {
 	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
@@ -751,13 +1016,17 @@ Clay_RectangleElementConfig *Clay__RectangleElementConfigArray_Add(Clay__Rectang
 	}
 	return &CLAY__RECTANGLE_ELEMENT_CONFIG_DEFAULT;
 }
+#ifdef _MSC_VER
 #pragma endregion
+#endif
 // __GENERATED__ template
 
 Clay_TextElementConfig CLAY__TEXT_ELEMENT_CONFIG_DEFAULT = CLAY__INIT(Clay_TextElementConfig) {};
 
 // __GENERATED__ template array_define,array_allocate,array_add TYPE=Clay_TextElementConfig NAME=Clay__TextElementConfigArray DEFAULT_VALUE=&CLAY__TEXT_ELEMENT_CONFIG_DEFAULT
+#ifdef _MSC_VER
 #pragma region generated
+#endif
 typedef struct
 {
 	uint32_t capacity;
@@ -765,7 +1034,11 @@ typedef struct
 	Clay_TextElementConfig *internalArray;
 } Clay__TextElementConfigArray;
 Clay__TextElementConfigArray Clay__TextElementConfigArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT(Clay__TextElementConfigArray){.capacity = capacity, .length = 0, .internalArray = (Clay_TextElementConfig *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_TextElementConfig), CLAY__ALIGNMENT(Clay_TextElementConfig), arena)};
+    Clay__TextElementConfigArray array = CLAY__INIT(Clay__TextElementConfigArray){.capacity = capacity, .length = 0, .internalArray = (Clay_TextElementConfig *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_TextElementConfig), CLAY__ALIGNMENT(Clay_TextElementConfig), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
 }
 Clay_TextElementConfig *Clay__TextElementConfigArray_Add(Clay__TextElementConfigArray *array, Clay_TextElementConfig item) {
 	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
@@ -774,13 +1047,17 @@ Clay_TextElementConfig *Clay__TextElementConfigArray_Add(Clay__TextElementConfig
 	}
 	return &CLAY__TEXT_ELEMENT_CONFIG_DEFAULT;
 }
+#ifdef _MSC_VER
 #pragma endregion
+#endif
 // __GENERATED__ template
 
 Clay_ImageElementConfig CLAY__IMAGE_ELEMENT_CONFIG_DEFAULT = CLAY__INIT(Clay_ImageElementConfig) {};
 
 // __GENERATED__ template array_define,array_allocate,array_add TYPE=Clay_ImageElementConfig NAME=Clay__ImageElementConfigArray DEFAULT_VALUE=&CLAY__IMAGE_ELEMENT_CONFIG_DEFAULT
+#ifdef _MSC_VER
 #pragma region generated
+#endif
 typedef struct
 {
 	uint32_t capacity;
@@ -788,7 +1065,11 @@ typedef struct
 	Clay_ImageElementConfig *internalArray;
 } Clay__ImageElementConfigArray;
 Clay__ImageElementConfigArray Clay__ImageElementConfigArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT(Clay__ImageElementConfigArray){.capacity = capacity, .length = 0, .internalArray = (Clay_ImageElementConfig *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_ImageElementConfig), CLAY__ALIGNMENT(Clay_ImageElementConfig), arena)};
+    Clay__ImageElementConfigArray array = CLAY__INIT(Clay__ImageElementConfigArray){.capacity = capacity, .length = 0, .internalArray = (Clay_ImageElementConfig *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_ImageElementConfig), CLAY__ALIGNMENT(Clay_ImageElementConfig), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
 }
 Clay_ImageElementConfig *Clay__ImageElementConfigArray_Add(Clay__ImageElementConfigArray *array, Clay_ImageElementConfig item) {
 	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
@@ -797,13 +1078,17 @@ Clay_ImageElementConfig *Clay__ImageElementConfigArray_Add(Clay__ImageElementCon
 	}
 	return &CLAY__IMAGE_ELEMENT_CONFIG_DEFAULT;
 }
+#ifdef _MSC_VER
 #pragma endregion
+#endif
 // __GENERATED__ template
 
 Clay_FloatingElementConfig CLAY__FLOATING_ELEMENT_CONFIG_DEFAULT = CLAY__INIT(Clay_FloatingElementConfig) {};
 
 // __GENERATED__ template array_define,array_allocate,array_add TYPE=Clay_FloatingElementConfig NAME=Clay__FloatingElementConfigArray DEFAULT_VALUE=&CLAY__FLOATING_ELEMENT_CONFIG_DEFAULT
+#ifdef _MSC_VER
 #pragma region generated
+#endif
 typedef struct
 {
 	uint32_t capacity;
@@ -811,7 +1096,11 @@ typedef struct
 	Clay_FloatingElementConfig *internalArray;
 } Clay__FloatingElementConfigArray;
 Clay__FloatingElementConfigArray Clay__FloatingElementConfigArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT(Clay__FloatingElementConfigArray){.capacity = capacity, .length = 0, .internalArray = (Clay_FloatingElementConfig *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_FloatingElementConfig), CLAY__ALIGNMENT(Clay_FloatingElementConfig), arena)};
+    Clay__FloatingElementConfigArray array = CLAY__INIT(Clay__FloatingElementConfigArray){.capacity = capacity, .length = 0, .internalArray = (Clay_FloatingElementConfig *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_FloatingElementConfig), CLAY__ALIGNMENT(Clay_FloatingElementConfig), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
 }
 Clay_FloatingElementConfig *Clay__FloatingElementConfigArray_Add(Clay__FloatingElementConfigArray *array, Clay_FloatingElementConfig item) {
 	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
@@ -820,13 +1109,17 @@ Clay_FloatingElementConfig *Clay__FloatingElementConfigArray_Add(Clay__FloatingE
 	}
 	return &CLAY__FLOATING_ELEMENT_CONFIG_DEFAULT;
 }
+#ifdef _MSC_VER
 #pragma endregion
+#endif
 // __GENERATED__ template
 
 Clay_CustomElementConfig CLAY__CUSTOM_ELEMENT_CONFIG_DEFAULT = CLAY__INIT(Clay_CustomElementConfig) {};
 
 // __GENERATED__ template array_define,array_allocate,array_add TYPE=Clay_CustomElementConfig NAME=Clay__CustomElementConfigArray DEFAULT_VALUE=&CLAY__CUSTOM_ELEMENT_CONFIG_DEFAULT
+#ifdef _MSC_VER
 #pragma region generated
+#endif
 typedef struct
 {
 	uint32_t capacity;
@@ -834,7 +1127,11 @@ typedef struct
 	Clay_CustomElementConfig *internalArray;
 } Clay__CustomElementConfigArray;
 Clay__CustomElementConfigArray Clay__CustomElementConfigArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT(Clay__CustomElementConfigArray){.capacity = capacity, .length = 0, .internalArray = (Clay_CustomElementConfig *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_CustomElementConfig), CLAY__ALIGNMENT(Clay_CustomElementConfig), arena)};
+    Clay__CustomElementConfigArray array = CLAY__INIT(Clay__CustomElementConfigArray){.capacity = capacity, .length = 0, .internalArray = (Clay_CustomElementConfig *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_CustomElementConfig), CLAY__ALIGNMENT(Clay_CustomElementConfig), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
 }
 Clay_CustomElementConfig *Clay__CustomElementConfigArray_Add(Clay__CustomElementConfigArray *array, Clay_CustomElementConfig item) {
 	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
@@ -843,13 +1140,17 @@ Clay_CustomElementConfig *Clay__CustomElementConfigArray_Add(Clay__CustomElement
 	}
 	return &CLAY__CUSTOM_ELEMENT_CONFIG_DEFAULT;
 }
+#ifdef _MSC_VER
 #pragma endregion
+#endif
 // __GENERATED__ template
 
 Clay_ScrollElementConfig CLAY__SCROLL_ELEMENT_CONFIG_DEFAULT = CLAY__INIT(Clay_ScrollElementConfig ) {};
 
 // __GENERATED__ template array_define,array_allocate,array_add TYPE=Clay_ScrollElementConfig NAME=Clay__ScrollElementConfigArray DEFAULT_VALUE=&CLAY__SCROLL_ELEMENT_CONFIG_DEFAULT
+#ifdef _MSC_VER
 #pragma region generated
+#endif
 typedef struct
 {
 	uint32_t capacity;
@@ -857,7 +1158,11 @@ typedef struct
 	Clay_ScrollElementConfig *internalArray;
 } Clay__ScrollElementConfigArray;
 Clay__ScrollElementConfigArray Clay__ScrollElementConfigArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT(Clay__ScrollElementConfigArray){.capacity = capacity, .length = 0, .internalArray = (Clay_ScrollElementConfig *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_ScrollElementConfig), CLAY__ALIGNMENT(Clay_ScrollElementConfig), arena)};
+    Clay__ScrollElementConfigArray array = CLAY__INIT(Clay__ScrollElementConfigArray){.capacity = capacity, .length = 0, .internalArray = (Clay_ScrollElementConfig *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_ScrollElementConfig), CLAY__ALIGNMENT(Clay_ScrollElementConfig), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
 }
 Clay_ScrollElementConfig *Clay__ScrollElementConfigArray_Add(Clay__ScrollElementConfigArray *array, Clay_ScrollElementConfig item) {
 	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
@@ -866,18 +1171,26 @@ Clay_ScrollElementConfig *Clay__ScrollElementConfigArray_Add(Clay__ScrollElement
 	}
 	return &CLAY__SCROLL_ELEMENT_CONFIG_DEFAULT;
 }
+#ifdef _MSC_VER
 #pragma endregion
+#endif
 // __GENERATED__ template
 
 // __GENERATED__ template array_define_slice,array_allocate,array_add TYPE=Clay_String NAME=Clay__StringArray DEFAULT_VALUE=&CLAY__STRING_DEFAULT
+#ifdef _MSC_VER
 #pragma region generated
+#endif
 typedef struct
 {
 	uint32_t length;
 	Clay_String *internalArray;
 } Clay__StringArraySlice;
 Clay__StringArray Clay__StringArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT(Clay__StringArray){.capacity = capacity, .length = 0, .internalArray = (Clay_String *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_String), CLAY__ALIGNMENT(Clay_String), arena)};
+    Clay__StringArray array = CLAY__INIT(Clay__StringArray){.capacity = capacity, .length = 0, .internalArray = (Clay_String *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_String), CLAY__ALIGNMENT(Clay_String), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
 }
 Clay_String *Clay__StringArray_Add(Clay__StringArray *array, Clay_String item) {
 	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
@@ -886,7 +1199,9 @@ Clay_String *Clay__StringArray_Add(Clay__StringArray *array, Clay_String item) {
 	}
 	return &CLAY__STRING_DEFAULT;
 }
+#ifdef _MSC_VER
 #pragma endregion
+#endif
 // __GENERATED__ template
 
 typedef struct {
@@ -897,7 +1212,9 @@ typedef struct {
 Clay__WrappedTextLine CLAY__WRAPPED_TEXT_LINE_DEFAULT = CLAY__INIT(Clay__WrappedTextLine) {};
 
 // __GENERATED__ template array_define,array_define_slice,array_allocate,array_add,array_get TYPE=Clay__WrappedTextLine NAME=Clay__WrappedTextLineArray DEFAULT_VALUE=&CLAY__WRAPPED_TEXT_LINE_DEFAULT
+#ifdef _MSC_VER
 #pragma region generated
+#endif
 typedef struct
 {
     uint32_t capacity;
@@ -910,7 +1227,11 @@ typedef struct
     Clay__WrappedTextLine *internalArray;
 } Clay__WrappedTextLineArraySlice;
 Clay__WrappedTextLineArray Clay__WrappedTextLineArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT(Clay__WrappedTextLineArray){.capacity = capacity, .length = 0, .internalArray = (Clay__WrappedTextLine *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay__WrappedTextLine), CLAY__ALIGNMENT(Clay__WrappedTextLine), arena)};
+    Clay__WrappedTextLineArray array = CLAY__INIT(Clay__WrappedTextLineArray){.capacity = capacity, .length = 0, .internalArray = (Clay__WrappedTextLine *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay__WrappedTextLine), CLAY__ALIGNMENT(Clay__WrappedTextLine), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
 }
 Clay__WrappedTextLine *Clay__WrappedTextLineArray_Add(Clay__WrappedTextLineArray *array, Clay__WrappedTextLine item) {
     if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
@@ -922,7 +1243,9 @@ Clay__WrappedTextLine *Clay__WrappedTextLineArray_Add(Clay__WrappedTextLineArray
 Clay__WrappedTextLine *Clay__WrappedTextLineArray_Get(Clay__WrappedTextLineArray *array, int index) {
     return Clay__Array_RangeCheck(index, array->length) ? &array->internalArray[index] : &CLAY__WRAPPED_TEXT_LINE_DEFAULT;
 }
+#ifdef _MSC_VER
 #pragma endregion
+#endif
 // __GENERATED__ template
 
 typedef struct
@@ -936,7 +1259,9 @@ typedef struct
 Clay__TextElementData CLAY__TEXT_ELEMENT_DATA_DEFAULT = CLAY__INIT(Clay__TextElementData) {};
 
 // __GENERATED__ template array_define,array_allocate,array_get,array_add TYPE=Clay__TextElementData NAME=Clay__TextElementDataArray DEFAULT_VALUE=&CLAY__TEXT_ELEMENT_DATA_DEFAULT
+#ifdef _MSC_VER
 #pragma region generated
+#endif
 typedef struct
 {
 	uint32_t capacity;
@@ -944,7 +1269,11 @@ typedef struct
 	Clay__TextElementData *internalArray;
 } Clay__TextElementDataArray;
 Clay__TextElementDataArray Clay__TextElementDataArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT(Clay__TextElementDataArray){.capacity = capacity, .length = 0, .internalArray = (Clay__TextElementData *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay__TextElementData), CLAY__ALIGNMENT(Clay__TextElementData), arena)};
+    Clay__TextElementDataArray array = CLAY__INIT(Clay__TextElementDataArray){.capacity = capacity, .length = 0, .internalArray = (Clay__TextElementData *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay__TextElementData), CLAY__ALIGNMENT(Clay__TextElementData), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
 }
 Clay__TextElementData *Clay__TextElementDataArray_Get(Clay__TextElementDataArray *array, int index) {
     return Clay__Array_RangeCheck(index, array->length) ? &array->internalArray[index] : &CLAY__TEXT_ELEMENT_DATA_DEFAULT;
@@ -956,13 +1285,17 @@ Clay__TextElementData *Clay__TextElementDataArray_Add(Clay__TextElementDataArray
 	}
 	return &CLAY__TEXT_ELEMENT_DATA_DEFAULT;
 }
+#ifdef _MSC_VER
 #pragma endregion
+#endif
 // __GENERATED__ template
 
 Clay_BorderElementConfig CLAY__BORDER_ELEMENT_CONFIG_DEFAULT = CLAY__INIT(Clay_BorderElementConfig ) {};
 
 // __GENERATED__ template array_define,array_allocate,array_add TYPE=Clay_BorderElementConfig NAME=Clay__BorderElementConfigArray DEFAULT_VALUE=&CLAY__BORDER_ELEMENT_CONFIG_DEFAULT
+#ifdef _MSC_VER
 #pragma region generated
+#endif
 typedef struct
 {
 	uint32_t capacity;
@@ -970,7 +1303,11 @@ typedef struct
 	Clay_BorderElementConfig *internalArray;
 } Clay__BorderElementConfigArray;
 Clay__BorderElementConfigArray Clay__BorderElementConfigArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT(Clay__BorderElementConfigArray){.capacity = capacity, .length = 0, .internalArray = (Clay_BorderElementConfig *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_BorderElementConfig), CLAY__ALIGNMENT(Clay_BorderElementConfig), arena)};
+    Clay__BorderElementConfigArray array = CLAY__INIT(Clay__BorderElementConfigArray){.capacity = capacity, .length = 0, .internalArray = (Clay_BorderElementConfig *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_BorderElementConfig), CLAY__ALIGNMENT(Clay_BorderElementConfig), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
 }
 Clay_BorderElementConfig *Clay__BorderElementConfigArray_Add(Clay__BorderElementConfigArray *array, Clay_BorderElementConfig item) {
 	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
@@ -979,7 +1316,9 @@ Clay_BorderElementConfig *Clay__BorderElementConfigArray_Add(Clay__BorderElement
 	}
 	return &CLAY__BORDER_ELEMENT_CONFIG_DEFAULT;
 }
+#ifdef _MSC_VER
 #pragma endregion
+#endif
 // __GENERATED__ template
 
 typedef struct
@@ -998,14 +1337,16 @@ typedef struct
     Clay_Dimensions minDimensions;
     Clay_LayoutConfig *layoutConfig;
     Clay__ElementConfigArraySlice elementConfigs;
-    uint32_t configsEnabled;
+    uint32_t configsEnabled; // The low byte is a mask of Clay__ElementConfigType, and the bits above it hold each type's slot in elementConfigs
     uint32_t id;
 } Clay_LayoutElement;
 
 Clay_LayoutElement CLAY__LAYOUT_ELEMENT_DEFAULT = CLAY__INIT(Clay_LayoutElement) {};
 
 // __GENERATED__ template array_define,array_allocate,array_add,array_get TYPE=Clay_LayoutElement NAME=Clay_LayoutElementArray DEFAULT_VALUE=&CLAY__LAYOUT_ELEMENT_DEFAULT
+#ifdef _MSC_VER
 #pragma region generated
+#endif
 typedef struct
 {
 	uint32_t capacity;
@@ -1013,7 +1354,11 @@ typedef struct
 	Clay_LayoutElement *internalArray;
 } Clay_LayoutElementArray;
 Clay_LayoutElementArray Clay_LayoutElementArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT(Clay_LayoutElementArray){.capacity = capacity, .length = 0, .internalArray = (Clay_LayoutElement *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_LayoutElement), CLAY__ALIGNMENT(Clay_LayoutElement), arena)};
+    Clay_LayoutElementArray array = CLAY__INIT(Clay_LayoutElementArray){.capacity = capacity, .length = 0, .internalArray = (Clay_LayoutElement *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_LayoutElement), CLAY__ALIGNMENT(Clay_LayoutElement), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
 }
 Clay_LayoutElement *Clay_LayoutElementArray_Add(Clay_LayoutElementArray *array, Clay_LayoutElement item) {
 	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
@@ -1025,11 +1370,15 @@ Clay_LayoutElement *Clay_LayoutElementArray_Add(Clay_LayoutElementArray *array,
 Clay_LayoutElement *Clay_LayoutElementArray_Get(Clay_LayoutElementArray *array, int index) {
     return Clay__Array_RangeCheck(index, array->length) ? &array->internalArray[index] : &CLAY__LAYOUT_ELEMENT_DEFAULT;
 }
+#ifdef _MSC_VER
 #pragma endregion
+#endif
 // __GENERATED__ template
 
 // __GENERATED__ template array_define,array_allocate,array_add,array_get_value,array_remove_swapback TYPE=Clay_LayoutElement* NAME=Clay__LayoutElementPointerArray DEFAULT_VALUE=CLAY__NULL
+#ifdef _MSC_VER
 #pragma region generated
+#endif
 typedef struct
 {
 	uint32_t capacity;
@@ -1037,7 +1386,11 @@ typedef struct
 	Clay_LayoutElement* *internalArray;
 } Clay__LayoutElementPointerArray;
 Clay__LayoutElementPointerArray Clay__LayoutElementPointerArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT(Clay__LayoutElementPointerArray){.capacity = capacity, .length = 0, .internalArray = (Clay_LayoutElement* *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_LayoutElement*), CLAY__ALIGNMENT(Clay_LayoutElement*), arena)};
+    Clay__LayoutElementPointerArray array = CLAY__INIT(Clay__LayoutElementPointerArray){.capacity = capacity, .length = 0, .internalArray = (Clay_LayoutElement* *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_LayoutElement*), CLAY__ALIGNMENT(Clay_LayoutElement*), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
 }
 Clay_LayoutElement* *Clay__LayoutElementPointerArray_Add(Clay__LayoutElementPointerArray *array, Clay_LayoutElement* item) {
 	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
@@ -1058,15 +1411,23 @@ Clay_LayoutElement* Clay__LayoutElementPointerArray_RemoveSwapback(Clay__LayoutE
 	}
 	return CLAY__NULL;
 }
+#ifdef _MSC_VER
 #pragma endregion
+#endif
 // __GENERATED__ template
 
 Clay_RenderCommand CLAY__RENDER_COMMAND_DEFAULT = CLAY__INIT(Clay_RenderCommand) {};
 
 // __GENERATED__ template array_allocate,array_add,array_get TYPE=Clay_RenderCommand NAME=Clay_RenderCommandArray DEFAULT_VALUE=&CLAY__RENDER_COMMAND_DEFAULT
+#ifdef _MSC_VER
 #pragma region generated
+#endif
 Clay_RenderCommandArray Clay_RenderCommandArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT(Clay_RenderCommandArray){.capacity = capacity, .length = 0, .internalArray = (Clay_RenderCommand *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_RenderCommand), CLAY__ALIGNMENT(Clay_RenderCommand), arena)};
+    Clay_RenderCommandArray array = CLAY__INIT(Clay_RenderCommandArray){.capacity = capacity, .length = 0, .internalArray = (Clay_RenderCommand *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_RenderCommand), CLAY__ALIGNMENT(Clay_RenderCommand), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
 }
 Clay_RenderCommand *Clay_RenderCommandArray_Add(Clay_RenderCommandArray *array, Clay_RenderCommand item) {
 	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
@@ -1078,53 +1439,223 @@ Clay_RenderCommand *Clay_RenderCommandArray_Add(Clay_RenderCommandArray *array,
 Clay_RenderCommand *Clay_RenderCommandArray_Get(Clay_RenderCommandArray *array, int index) {
     return Clay__Array_RangeCheck(index, array->length) ? &array->internalArray[index] : &CLAY__RENDER_COMMAND_DEFAULT;
 }
+#ifdef _MSC_VER
 #pragma endregion
+#endif
 // __GENERATED__ template
 
-typedef struct
-{
-    Clay_LayoutElement *layoutElement;
-    Clay_BoundingBox boundingBox;
-    Clay_Dimensions contentSize;
-    Clay_Vector2 scrollOrigin;
-    Clay_Vector2 pointerOrigin;
-    Clay_Vector2 scrollMomentum;
-    Clay_Vector2 scrollPosition;
-    Clay_Vector2 previousDelta;
-    float momentumTime;
-    uint32_t elementId;
-    bool openThisFrame;
-    bool pointerScrollActive;
-} Clay__ScrollContainerDataInternal;
-
-Clay__ScrollContainerDataInternal CLAY__SCROLL_CONTAINER_DEFAULT = CLAY__INIT(Clay__ScrollContainerDataInternal) {};
+Clay_RenderCommandDelta CLAY__RENDER_COMMAND_DELTA_DEFAULT = CLAY__INIT(Clay_RenderCommandDelta) {};
 
-// __GENERATED__ template array_define,array_allocate,array_add,array_get TYPE=Clay__ScrollContainerDataInternal NAME=Clay__ScrollContainerDataInternalArray DEFAULT_VALUE=&CLAY__SCROLL_CONTAINER_DEFAULT
+// __GENERATED__ template array_allocate,array_add,array_get TYPE=Clay_RenderCommandDelta NAME=Clay_RenderCommandDeltaArray DEFAULT_VALUE=&CLAY__RENDER_COMMAND_DELTA_DEFAULT
+#ifdef _MSC_VER
 #pragma region generated
-typedef struct
-{
-	uint32_t capacity;
-	uint32_t length;
-	Clay__ScrollContainerDataInternal *internalArray;
-} Clay__ScrollContainerDataInternalArray;
-Clay__ScrollContainerDataInternalArray Clay__ScrollContainerDataInternalArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT(Clay__ScrollContainerDataInternalArray){.capacity = capacity, .length = 0, .internalArray = (Clay__ScrollContainerDataInternal *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay__ScrollContainerDataInternal), CLAY__ALIGNMENT(Clay__ScrollContainerDataInternal), arena)};
+#endif
+Clay_RenderCommandDeltaArray Clay_RenderCommandDeltaArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
+    Clay_RenderCommandDeltaArray array = CLAY__INIT(Clay_RenderCommandDeltaArray){.capacity = capacity, .length = 0, .internalArray = (Clay_RenderCommandDelta *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_RenderCommandDelta), CLAY__ALIGNMENT(Clay_RenderCommandDelta), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
 }
-Clay__ScrollContainerDataInternal *Clay__ScrollContainerDataInternalArray_Add(Clay__ScrollContainerDataInternalArray *array, Clay__ScrollContainerDataInternal item) {
+Clay_RenderCommandDelta *Clay_RenderCommandDeltaArray_Add(Clay_RenderCommandDeltaArray *array, Clay_RenderCommandDelta item) {
 	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
 		array->internalArray[array->length++] = item;
 		return &array->internalArray[array->length - 1];
 	}
-	return &CLAY__SCROLL_CONTAINER_DEFAULT;
+	return &CLAY__RENDER_COMMAND_DELTA_DEFAULT;
 }
-Clay__ScrollContainerDataInternal *Clay__ScrollContainerDataInternalArray_Get(Clay__ScrollContainerDataInternalArray *array, int index) {
-    return Clay__Array_RangeCheck(index, array->length) ? &array->internalArray[index] : &CLAY__SCROLL_CONTAINER_DEFAULT;
+Clay_RenderCommandDelta *Clay_RenderCommandDeltaArray_Get(Clay_RenderCommandDeltaArray *array, int index) {
+    return Clay__Array_RangeCheck(index, array->length) ? &array->internalArray[index] : &CLAY__RENDER_COMMAND_DELTA_DEFAULT;
 }
+#ifdef _MSC_VER
 #pragma endregion
+#endif
 // __GENERATED__ template
 
-// __GENERATED__ template array_remove_swapback TYPE=Clay__ScrollContainerDataInternal NAME=Clay__ScrollContainerDataInternalArray DEFAULT_VALUE=CLAY__SCROLL_CONTAINER_DEFAULT
+Clay_CompactRenderCommand CLAY__COMPACT_RENDER_COMMAND_DEFAULT = CLAY__INIT(Clay_CompactRenderCommand) {};
+
+// __GENERATED__ template array_allocate,array_add,array_get TYPE=Clay_CompactRenderCommand NAME=Clay_CompactRenderCommandArray DEFAULT_VALUE=&CLAY__COMPACT_RENDER_COMMAND_DEFAULT
+#ifdef _MSC_VER
 #pragma region generated
+#endif
+Clay_CompactRenderCommandArray Clay_CompactRenderCommandArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
+    Clay_CompactRenderCommandArray array = CLAY__INIT(Clay_CompactRenderCommandArray){.capacity = capacity, .length = 0, .internalArray = (Clay_CompactRenderCommand *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_CompactRenderCommand), CLAY__ALIGNMENT(Clay_CompactRenderCommand), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
+}
+Clay_CompactRenderCommand *Clay_CompactRenderCommandArray_Add(Clay_CompactRenderCommandArray *array, Clay_CompactRenderCommand item) {
+	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
+		array->internalArray[array->length++] = item;
+		return &array->internalArray[array->length - 1];
+	}
+	return &CLAY__COMPACT_RENDER_COMMAND_DEFAULT;
+}
+Clay_CompactRenderCommand *Clay_CompactRenderCommandArray_Get(Clay_CompactRenderCommandArray *array, int index) {
+    return Clay__Array_RangeCheck(index, array->length) ? &array->internalArray[index] : &CLAY__COMPACT_RENDER_COMMAND_DEFAULT;
+}
+#ifdef _MSC_VER
+#pragma endregion
+#endif
+// __GENERATED__ template
+
+Clay_CompactRenderCommandText CLAY__COMPACT_RENDER_COMMAND_TEXT_DEFAULT = CLAY__INIT(Clay_CompactRenderCommandText) {};
+
+// __GENERATED__ template array_allocate,array_add,array_get TYPE=Clay_CompactRenderCommandText NAME=Clay_CompactRenderCommandTextArray DEFAULT_VALUE=&CLAY__COMPACT_RENDER_COMMAND_TEXT_DEFAULT
+#ifdef _MSC_VER
+#pragma region generated
+#endif
+Clay_CompactRenderCommandTextArray Clay_CompactRenderCommandTextArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
+    Clay_CompactRenderCommandTextArray array = CLAY__INIT(Clay_CompactRenderCommandTextArray){.capacity = capacity, .length = 0, .internalArray = (Clay_CompactRenderCommandText *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_CompactRenderCommandText), CLAY__ALIGNMENT(Clay_CompactRenderCommandText), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
+}
+Clay_CompactRenderCommandText *Clay_CompactRenderCommandTextArray_Add(Clay_CompactRenderCommandTextArray *array, Clay_CompactRenderCommandText item) {
+	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
+		array->internalArray[array->length++] = item;
+		return &array->internalArray[array->length - 1];
+	}
+	return &CLAY__COMPACT_RENDER_COMMAND_TEXT_DEFAULT;
+}
+Clay_CompactRenderCommandText *Clay_CompactRenderCommandTextArray_Get(Clay_CompactRenderCommandTextArray *array, int index) {
+    return Clay__Array_RangeCheck(index, array->length) ? &array->internalArray[index] : &CLAY__COMPACT_RENDER_COMMAND_TEXT_DEFAULT;
+}
+#ifdef _MSC_VER
+#pragma endregion
+#endif
+// __GENERATED__ template
+
+Clay_BoundingBox CLAY__BOUNDING_BOX_DEFAULT = CLAY__INIT(Clay_BoundingBox) {};
+
+// __GENERATED__ template array_allocate,array_add TYPE=Clay_BoundingBox NAME=Clay_DamageRectArray DEFAULT_VALUE=&CLAY__BOUNDING_BOX_DEFAULT
+#ifdef _MSC_VER
+#pragma region generated
+#endif
+Clay_DamageRectArray Clay_DamageRectArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
+    Clay_DamageRectArray array = CLAY__INIT(Clay_DamageRectArray){.capacity = capacity, .length = 0, .internalArray = (Clay_BoundingBox *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_BoundingBox), CLAY__ALIGNMENT(Clay_BoundingBox), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
+}
+Clay_BoundingBox *Clay_DamageRectArray_Add(Clay_DamageRectArray *array, Clay_BoundingBox item) {
+	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
+		array->internalArray[array->length++] = item;
+		return &array->internalArray[array->length - 1];
+	}
+	return &CLAY__BOUNDING_BOX_DEFAULT;
+}
+#ifdef _MSC_VER
+#pragma endregion
+#endif
+// __GENERATED__ template
+
+typedef struct
+{
+    uint64_t key; // The command type and id, and which of the frame's commands with that type and id this is in bits 40 and up
+    uint64_t fingerprint;
+    Clay_BoundingBox boundingBox;
+    int32_t nextIndex;
+    bool matched;
+} Clay__RenderCommandFingerprint;
+
+Clay__RenderCommandFingerprint CLAY__RENDER_COMMAND_FINGERPRINT_DEFAULT = CLAY__INIT(Clay__RenderCommandFingerprint) {};
+
+// __GENERATED__ template array_define,array_allocate,array_get,array_add TYPE=Clay__RenderCommandFingerprint NAME=Clay__RenderCommandFingerprintArray DEFAULT_VALUE=&CLAY__RENDER_COMMAND_FINGERPRINT_DEFAULT
+#ifdef _MSC_VER
+#pragma region generated
+#endif
+typedef struct
+{
+	uint32_t capacity;
+	uint32_t length;
+	Clay__RenderCommandFingerprint *internalArray;
+} Clay__RenderCommandFingerprintArray;
+Clay__RenderCommandFingerprintArray Clay__RenderCommandFingerprintArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
+    Clay__RenderCommandFingerprintArray array = CLAY__INIT(Clay__RenderCommandFingerprintArray){.capacity = capacity, .length = 0, .internalArray = (Clay__RenderCommandFingerprint *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay__RenderCommandFingerprint), CLAY__ALIGNMENT(Clay__RenderCommandFingerprint), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
+}
+Clay__RenderCommandFingerprint *Clay__RenderCommandFingerprintArray_Get(Clay__RenderCommandFingerprintArray *array, int index) {
+    return Clay__Array_RangeCheck(index, array->length) ? &array->internalArray[index] : &CLAY__RENDER_COMMAND_FINGERPRINT_DEFAULT;
+}
+Clay__RenderCommandFingerprint *Clay__RenderCommandFingerprintArray_Add(Clay__RenderCommandFingerprintArray *array, Clay__RenderCommandFingerprint item) {
+	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
+		array->internalArray[array->length++] = item;
+		return &array->internalArray[array->length - 1];
+	}
+	return &CLAY__RENDER_COMMAND_FINGERPRINT_DEFAULT;
+}
+#ifdef _MSC_VER
+#pragma endregion
+#endif
+// __GENERATED__ template
+
+typedef struct
+{
+    Clay_LayoutElement *layoutElement;
+    Clay_BoundingBox boundingBox;
+    Clay_Dimensions contentSize;
+    Clay_Vector2 scrollOrigin;
+    Clay_Vector2 pointerOrigin;
+    Clay_Vector2 scrollMomentum;
+    Clay_Vector2 scrollPosition;
+    Clay_Vector2 previousDelta;
+    float momentumTime;
+    uint32_t elementId;
+    // The first visible item of a virtual list in this container, and where it starts in the content, kept so the next frame can search from it
+    uint32_t virtualListAnchorIndex;
+    float virtualListAnchorOffset;
+    float virtualListTrailingExtent;
+    uint32_t virtualListFirstChildIndex; // Added to a child's position to get its item index, so it's one less than the first item when the leading spacer is declared
+    bool virtualListOpen; // Clay_VirtualList was called in this container and it hasn't been closed yet
+    bool openThisFrame;
+    bool pointerScrollActive;
+} Clay__ScrollContainerDataInternal;
+
+Clay__ScrollContainerDataInternal CLAY__SCROLL_CONTAINER_DEFAULT = CLAY__INIT(Clay__ScrollContainerDataInternal) {};
+
+// __GENERATED__ template array_define,array_allocate,array_add,array_get TYPE=Clay__ScrollContainerDataInternal NAME=Clay__ScrollContainerDataInternalArray DEFAULT_VALUE=&CLAY__SCROLL_CONTAINER_DEFAULT
+#ifdef _MSC_VER
+#pragma region generated
+#endif
+typedef struct
+{
+	uint32_t capacity;
+	uint32_t length;
+	Clay__ScrollContainerDataInternal *internalArray;
+} Clay__ScrollContainerDataInternalArray;
+Clay__ScrollContainerDataInternalArray Clay__ScrollContainerDataInternalArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
+    Clay__ScrollContainerDataInternalArray array = CLAY__INIT(Clay__ScrollContainerDataInternalArray){.capacity = capacity, .length = 0, .internalArray = (Clay__ScrollContainerDataInternal *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay__ScrollContainerDataInternal), CLAY__ALIGNMENT(Clay__ScrollContainerDataInternal), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
+}
+Clay__ScrollContainerDataInternal *Clay__ScrollContainerDataInternalArray_Add(Clay__ScrollContainerDataInternalArray *array, Clay__ScrollContainerDataInternal item) {
+	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
+		array->internalArray[array->length++] = item;
+		return &array->internalArray[array->length - 1];
+	}
+	return &CLAY__SCROLL_CONTAINER_DEFAULT;
+}
+Clay__ScrollContainerDataInternal *Clay__ScrollContainerDataInternalArray_Get(Clay__ScrollContainerDataInternalArray *array, int index) {
+    return Clay__Array_RangeCheck(index, array->length) ? &array->internalArray[index] : &CLAY__SCROLL_CONTAINER_DEFAULT;
+}
+#ifdef _MSC_VER
+#pragma endregion
+#endif
+// __GENERATED__ template
+
+// __GENERATED__ template array_remove_swapback TYPE=Clay__ScrollContainerDataInternal NAME=Clay__ScrollContainerDataInternalArray DEFAULT_VALUE=CLAY__SCROLL_CONTAINER_DEFAULT
+#ifdef _MSC_VER
+#pragma region generated
+#endif
 Clay__ScrollContainerDataInternal Clay__ScrollContainerDataInternalArray_RemoveSwapback(Clay__ScrollContainerDataInternalArray *array, int index) {
 	if (Clay__Array_RangeCheck(index, array->length)) {
 		array->length--;
@@ -1134,7 +1665,9 @@ Clay__ScrollContainerDataInternal Clay__ScrollContainerDataInternalArray_RemoveS
 	}
 	return CLAY__SCROLL_CONTAINER_DEFAULT;
 }
+#ifdef _MSC_VER
 #pragma endregion
+#endif
 // __GENERATED__ template
 
 typedef struct
@@ -1146,7 +1679,9 @@ typedef struct
 Clay__DebugElementData CLAY__DEBUG_ELEMENT_DATA_DEFAULT = CLAY__INIT(Clay__DebugElementData) {};
 
 // __GENERATED__ template array_define,array_allocate,array_add,array_get TYPE=Clay__DebugElementData NAME=Clay__DebugElementDataArray DEFAULT_VALUE=&CLAY__DEBUG_ELEMENT_DATA_DEFAULT
+#ifdef _MSC_VER
 #pragma region generated
+#endif
 typedef struct
 {
 	uint32_t capacity;
@@ -1154,7 +1689,11 @@ typedef struct
 	Clay__DebugElementData *internalArray;
 } Clay__DebugElementDataArray;
 Clay__DebugElementDataArray Clay__DebugElementDataArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT(Clay__DebugElementDataArray){.capacity = capacity, .length = 0, .internalArray = (Clay__DebugElementData *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay__DebugElementData), CLAY__ALIGNMENT(Clay__DebugElementData), arena)};
+    Clay__DebugElementDataArray array = CLAY__INIT(Clay__DebugElementDataArray){.capacity = capacity, .length = 0, .internalArray = (Clay__DebugElementData *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay__DebugElementData), CLAY__ALIGNMENT(Clay__DebugElementData), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
 }
 Clay__DebugElementData *Clay__DebugElementDataArray_Add(Clay__DebugElementDataArray *array, Clay__DebugElementData item) {
 	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
@@ -1166,25 +1705,31 @@ Clay__DebugElementData *Clay__DebugElementDataArray_Add(Clay__DebugElementDataAr
 Clay__DebugElementData *Clay__DebugElementDataArray_Get(Clay__DebugElementDataArray *array, int index) {
     return Clay__Array_RangeCheck(index, array->length) ? &array->internalArray[index] : &CLAY__DEBUG_ELEMENT_DATA_DEFAULT;
 }
+#ifdef _MSC_VER
 #pragma endregion
+#endif
 // __GENERATED__ template
 
-typedef struct // todo get this struct into a single cache line
+typedef struct
 {
     Clay_BoundingBox boundingBox;
     Clay_ElementId elementId;
     Clay_LayoutElement* layoutElement;
     void (*onHoverFunction)(Clay_ElementId elementId, Clay_PointerData pointerInfo, intptr_t userData);
     intptr_t hoverFunctionUserData;
-    int32_t nextIndex;
     uint32_t generation;
+    int32_t scrollContainerDataIndex; // Only meaningful if the scroll container data at this index has the same element id
+    uint32_t pointerOverGeneration; // Matches the context's pointerOverGeneration if the pointer was over this element in the most recent Clay_SetPointerState
+    uint32_t pointerOverPriority; // The element's index in pointerOverIds
     Clay__DebugElementData *debugData;
 } Clay_LayoutElementHashMapItem;
 
 Clay_LayoutElementHashMapItem CLAY__LAYOUT_ELEMENT_HASH_MAP_ITEM_DEFAULT = CLAY__INIT(Clay_LayoutElementHashMapItem) { .layoutElement = &CLAY__LAYOUT_ELEMENT_DEFAULT };
 
 // __GENERATED__ template array_define,array_allocate,array_get,array_add TYPE=Clay_LayoutElementHashMapItem NAME=Clay__LayoutElementHashMapItemArray DEFAULT_VALUE=&CLAY__LAYOUT_ELEMENT_HASH_MAP_ITEM_DEFAULT
+#ifdef _MSC_VER
 #pragma region generated
+#endif
 typedef struct
 {
 	uint32_t capacity;
@@ -1192,7 +1737,11 @@ typedef struct
 	Clay_LayoutElementHashMapItem *internalArray;
 } Clay__LayoutElementHashMapItemArray;
 Clay__LayoutElementHashMapItemArray Clay__LayoutElementHashMapItemArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT(Clay__LayoutElementHashMapItemArray){.capacity = capacity, .length = 0, .internalArray = (Clay_LayoutElementHashMapItem *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_LayoutElementHashMapItem), CLAY__ALIGNMENT(Clay_LayoutElementHashMapItem), arena)};
+    Clay__LayoutElementHashMapItemArray array = CLAY__INIT(Clay__LayoutElementHashMapItemArray){.capacity = capacity, .length = 0, .internalArray = (Clay_LayoutElementHashMapItem *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_LayoutElementHashMapItem), CLAY__ALIGNMENT(Clay_LayoutElementHashMapItem), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
 }
 Clay_LayoutElementHashMapItem *Clay__LayoutElementHashMapItemArray_Get(Clay__LayoutElementHashMapItemArray *array, int index) {
     return Clay__Array_RangeCheck(index, array->length) ? &array->internalArray[index] : &CLAY__LAYOUT_ELEMENT_HASH_MAP_ITEM_DEFAULT;
@@ -1204,7 +1753,39 @@ Clay_LayoutElementHashMapItem *Clay__LayoutElementHashMapItemArray_Add(Clay__Lay
 	}
 	return &CLAY__LAYOUT_ELEMENT_HASH_MAP_ITEM_DEFAULT;
 }
+#ifdef _MSC_VER
 #pragma endregion
+#endif
+// __GENERATED__ template
+
+// Element lookups probe a dense table of (id, item index) pairs, so that a whole run of candidates shares a cache line
+// and the larger items are only touched once the id has matched
+typedef struct
+{
+    uint32_t id;
+    int32_t itemIndex; // -1 for an empty slot
+} Clay__LayoutElementHashMapSlot;
+
+// __GENERATED__ template array_define,array_allocate TYPE=Clay__LayoutElementHashMapSlot NAME=Clay__LayoutElementHashMapSlotArray
+#ifdef _MSC_VER
+#pragma region generated
+#endif
+typedef struct
+{
+	uint32_t capacity;
+	uint32_t length;
+	Clay__LayoutElementHashMapSlot *internalArray;
+} Clay__LayoutElementHashMapSlotArray;
+Clay__LayoutElementHashMapSlotArray Clay__LayoutElementHashMapSlotArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
+    Clay__LayoutElementHashMapSlotArray array = CLAY__INIT(Clay__LayoutElementHashMapSlotArray){.capacity = capacity, .length = 0, .internalArray = (Clay__LayoutElementHashMapSlot *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay__LayoutElementHashMapSlot), CLAY__ALIGNMENT(Clay__LayoutElementHashMapSlot), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
+}
+#ifdef _MSC_VER
+#pragma endregion
+#endif
 // __GENERATED__ template
 
 typedef struct
@@ -1218,7 +1799,9 @@ typedef struct
 Clay__MeasuredWord CLAY__MEASURED_WORD_DEFAULT = CLAY__INIT(Clay__MeasuredWord) { .next = -1 };
 
 // __GENERATED__ template array_define,array_allocate,array_get,array_set,array_add TYPE=Clay__MeasuredWord NAME=Clay__MeasuredWordArray DEFAULT_VALUE=&CLAY__MEASURED_WORD_DEFAULT
+#ifdef _MSC_VER
 #pragma region generated
+#endif
 typedef struct
 {
 	uint32_t capacity;
@@ -1226,7 +1809,11 @@ typedef struct
 	Clay__MeasuredWord *internalArray;
 } Clay__MeasuredWordArray;
 Clay__MeasuredWordArray Clay__MeasuredWordArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT(Clay__MeasuredWordArray){.capacity = capacity, .length = 0, .internalArray = (Clay__MeasuredWord *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay__MeasuredWord), CLAY__ALIGNMENT(Clay__MeasuredWord), arena)};
+    Clay__MeasuredWordArray array = CLAY__INIT(Clay__MeasuredWordArray){.capacity = capacity, .length = 0, .internalArray = (Clay__MeasuredWord *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay__MeasuredWord), CLAY__ALIGNMENT(Clay__MeasuredWord), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
 }
 Clay__MeasuredWord *Clay__MeasuredWordArray_Get(Clay__MeasuredWordArray *array, int index) {
     return Clay__Array_RangeCheck(index, array->length) ? &array->internalArray[index] : &CLAY__MEASURED_WORD_DEFAULT;
@@ -1234,7 +1821,7 @@ Clay__MeasuredWord *Clay__MeasuredWordArray_Get(Clay__MeasuredWordArray *array,
 void Clay__MeasuredWordArray_Set(Clay__MeasuredWordArray *array, int index, Clay__MeasuredWord value) {
 	if (Clay__Array_RangeCheck(index, array->capacity)) {
 		array->internalArray[index] = value;
-		array->length = index < array->length ? array->length : index + 1;
+		array->length = index < (int32_t)array->length ? array->length : index + 1;
 	}
 }
 Clay__MeasuredWord *Clay__MeasuredWordArray_Add(Clay__MeasuredWordArray *array, Clay__MeasuredWord item) {
@@ -1244,23 +1831,30 @@ Clay__MeasuredWord *Clay__MeasuredWordArray_Add(Clay__MeasuredWordArray *array,
 	}
 	return &CLAY__MEASURED_WORD_DEFAULT;
 }
+#ifdef _MSC_VER
 #pragma endregion
+#endif
 // __GENERATED__ template
 
 typedef struct
 {
     Clay_Dimensions unwrappedDimensions;
     int32_t measuredWordsStartIndex;
+    // Lines from the last time this text was wrapped, stored as words in Clay__wrappedLineCache
+    int32_t wrappedLinesStartIndex;
+    float wrappedWidth;
     // Hash map data
     uint32_t id;
     int32_t nextIndex;
     uint32_t generation;
 } Clay__MeasureTextCacheItem;
 
-Clay__MeasureTextCacheItem CLAY__MEASURE_TEXT_CACHE_ITEM_DEFAULT = CLAY__INIT(Clay__MeasureTextCacheItem) { .measuredWordsStartIndex = -1 };
+Clay__MeasureTextCacheItem CLAY__MEASURE_TEXT_CACHE_ITEM_DEFAULT = CLAY__INIT(Clay__MeasureTextCacheItem) { .measuredWordsStartIndex = -1, .wrappedLinesStartIndex = -1 };
 
 // __GENERATED__ template array_define,array_allocate,array_get,array_add,array_set TYPE=Clay__MeasureTextCacheItem NAME=Clay__MeasureTextCacheItemArray DEFAULT_VALUE=&CLAY__MEASURE_TEXT_CACHE_ITEM_DEFAULT
+#ifdef _MSC_VER
 #pragma region generated
+#endif
 typedef struct
 {
 	uint32_t capacity;
@@ -1268,7 +1862,11 @@ typedef struct
 	Clay__MeasureTextCacheItem *internalArray;
 } Clay__MeasureTextCacheItemArray;
 Clay__MeasureTextCacheItemArray Clay__MeasureTextCacheItemArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT(Clay__MeasureTextCacheItemArray){.capacity = capacity, .length = 0, .internalArray = (Clay__MeasureTextCacheItem *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay__MeasureTextCacheItem), CLAY__ALIGNMENT(Clay__MeasureTextCacheItem), arena)};
+    Clay__MeasureTextCacheItemArray array = CLAY__INIT(Clay__MeasureTextCacheItemArray){.capacity = capacity, .length = 0, .internalArray = (Clay__MeasureTextCacheItem *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay__MeasureTextCacheItem), CLAY__ALIGNMENT(Clay__MeasureTextCacheItem), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
 }
 Clay__MeasureTextCacheItem *Clay__MeasureTextCacheItemArray_Get(Clay__MeasureTextCacheItemArray *array, int index) {
     return Clay__Array_RangeCheck(index, array->length) ? &array->internalArray[index] : &CLAY__MEASURE_TEXT_CACHE_ITEM_DEFAULT;
@@ -1283,211 +1881,724 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCacheItemArray_Add(Clay__MeasureTex
 void Clay__MeasureTextCacheItemArray_Set(Clay__MeasureTextCacheItemArray *array, int index, Clay__MeasureTextCacheItem value) {
 	if (Clay__Array_RangeCheck(index, array->capacity)) {
 		array->internalArray[index] = value;
-		array->length = index < array->length ? array->length : index + 1;
+		array->length = index < (int32_t)array->length ? array->length : index + 1;
 	}
 }
+#ifdef _MSC_VER
 #pragma endregion
+#endif
 // __GENERATED__ template
 
-// __GENERATED__ template array_define,array_allocate,array_get_value,array_add_value,array_set,array_remove_swapback TYPE=int32_t NAME=Clay__int32_tArray DEFAULT_VALUE=-1
+typedef struct
+{
+    uint16_t fontId;
+    Clay_FontMetrics metrics;
+} Clay__RegisteredFontMetrics;
+
+Clay__RegisteredFontMetrics CLAY__REGISTERED_FONT_METRICS_DEFAULT = CLAY__INIT(Clay__RegisteredFontMetrics) {};
+
+// __GENERATED__ template array_define,array_allocate,array_get,array_add TYPE=Clay__RegisteredFontMetrics NAME=Clay__RegisteredFontMetricsArray DEFAULT_VALUE=&CLAY__REGISTERED_FONT_METRICS_DEFAULT
+#ifdef _MSC_VER
 #pragma region generated
+#endif
 typedef struct
 {
 	uint32_t capacity;
 	uint32_t length;
-	int32_t *internalArray;
-} Clay__int32_tArray;
-Clay__int32_tArray Clay__int32_tArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT(Clay__int32_tArray){.capacity = capacity, .length = 0, .internalArray = (int32_t *)Clay__Array_Allocate_Arena(capacity, sizeof(int32_t), CLAY__ALIGNMENT(int32_t), arena)};
+	Clay__RegisteredFontMetrics *internalArray;
+} Clay__RegisteredFontMetricsArray;
+Clay__RegisteredFontMetricsArray Clay__RegisteredFontMetricsArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
+    Clay__RegisteredFontMetricsArray array = CLAY__INIT(Clay__RegisteredFontMetricsArray){.capacity = capacity, .length = 0, .internalArray = (Clay__RegisteredFontMetrics *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay__RegisteredFontMetrics), CLAY__ALIGNMENT(Clay__RegisteredFontMetrics), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
 }
-int32_t Clay__int32_tArray_Get(Clay__int32_tArray *array, int index) {
-    return Clay__Array_RangeCheck(index, array->length) ? array->internalArray[index] : -1;
+Clay__RegisteredFontMetrics *Clay__RegisteredFontMetricsArray_Get(Clay__RegisteredFontMetricsArray *array, int index) {
+    return Clay__Array_RangeCheck(index, array->length) ? &array->internalArray[index] : &CLAY__REGISTERED_FONT_METRICS_DEFAULT;
 }
-void Clay__int32_tArray_Add(Clay__int32_tArray *array, int32_t item) {
+Clay__RegisteredFontMetrics *Clay__RegisteredFontMetricsArray_Add(Clay__RegisteredFontMetricsArray *array, Clay__RegisteredFontMetrics item) {
 	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
 		array->internalArray[array->length++] = item;
+		return &array->internalArray[array->length - 1];
 	}
+	return &CLAY__REGISTERED_FONT_METRICS_DEFAULT;
 }
-void Clay__int32_tArray_Set(Clay__int32_tArray *array, int index, int32_t value) {
-	if (Clay__Array_RangeCheck(index, array->capacity)) {
-		array->internalArray[index] = value;
-		array->length = index < array->length ? array->length : index + 1;
-	}
-}
-int32_t Clay__int32_tArray_RemoveSwapback(Clay__int32_tArray *array, int index) {
-	if (Clay__Array_RangeCheck(index, array->length)) {
-		array->length--;
-		int32_t removed = array->internalArray[index];
-		array->internalArray[index] = array->internalArray[array->length];
-		return removed;
-	}
-	return -1;
-}
+#ifdef _MSC_VER
 #pragma endregion
+#endif
 // __GENERATED__ template
 
+// Longer words aren't cached, they're rare enough that measuring them every time costs less than making every entry bigger
+#define CLAY__MEASURE_WORD_CACHE_MAX_WORD_LENGTH 20
+
 typedef struct
 {
-    Clay_LayoutElement *layoutElement;
-    Clay_Vector2 position;
-    Clay_Vector2 nextChildOffset;
-} Clay__LayoutElementTreeNode;
+    Clay_Dimensions dimensions;
+    // Hash map data
+    uint64_t id;
+    int32_t nextIndex;
+    uint32_t generation;
+    int32_t batchIndex; // While the word is waiting to be measured in a batch, its index in that batch. Otherwise -1
+    // The whole key is kept, since different words and fonts can hash to the same id
+    uint16_t fontId;
+    uint16_t fontSize;
+    uint16_t letterSpacing;
+    uint8_t length;
+    char chars[CLAY__MEASURE_WORD_CACHE_MAX_WORD_LENGTH];
+} Clay__MeasureWordCacheItem;
 
-Clay__LayoutElementTreeNode CLAY__LAYOUT_ELEMENT_TREE_NODE_DEFAULT = CLAY__INIT(Clay__LayoutElementTreeNode) {};
+Clay__MeasureWordCacheItem CLAY__MEASURE_WORD_CACHE_ITEM_DEFAULT = CLAY__INIT(Clay__MeasureWordCacheItem) { .batchIndex = -1 };
 
-// __GENERATED__ template array_define,array_allocate,array_add,array_get TYPE=Clay__LayoutElementTreeNode NAME=Clay__LayoutElementTreeNodeArray DEFAULT_VALUE=&CLAY__LAYOUT_ELEMENT_TREE_NODE_DEFAULT
+// __GENERATED__ template array_define,array_allocate,array_get,array_add,array_set TYPE=Clay__MeasureWordCacheItem NAME=Clay__MeasureWordCacheItemArray DEFAULT_VALUE=&CLAY__MEASURE_WORD_CACHE_ITEM_DEFAULT
+#ifdef _MSC_VER
 #pragma region generated
+#endif
 typedef struct
 {
 	uint32_t capacity;
 	uint32_t length;
-	Clay__LayoutElementTreeNode *internalArray;
-} Clay__LayoutElementTreeNodeArray;
-Clay__LayoutElementTreeNodeArray Clay__LayoutElementTreeNodeArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT(Clay__LayoutElementTreeNodeArray){.capacity = capacity, .length = 0, .internalArray = (Clay__LayoutElementTreeNode *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay__LayoutElementTreeNode), CLAY__ALIGNMENT(Clay__LayoutElementTreeNode), arena)};
+	Clay__MeasureWordCacheItem *internalArray;
+} Clay__MeasureWordCacheItemArray;
+Clay__MeasureWordCacheItemArray Clay__MeasureWordCacheItemArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
+    Clay__MeasureWordCacheItemArray array = CLAY__INIT(Clay__MeasureWordCacheItemArray){.capacity = capacity, .length = 0, .internalArray = (Clay__MeasureWordCacheItem *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay__MeasureWordCacheItem), CLAY__ALIGNMENT(Clay__MeasureWordCacheItem), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
 }
-Clay__LayoutElementTreeNode *Clay__LayoutElementTreeNodeArray_Add(Clay__LayoutElementTreeNodeArray *array, Clay__LayoutElementTreeNode item) {
+Clay__MeasureWordCacheItem *Clay__MeasureWordCacheItemArray_Get(Clay__MeasureWordCacheItemArray *array, int index) {
+    return Clay__Array_RangeCheck(index, array->length) ? &array->internalArray[index] : &CLAY__MEASURE_WORD_CACHE_ITEM_DEFAULT;
+}
+Clay__MeasureWordCacheItem *Clay__MeasureWordCacheItemArray_Add(Clay__MeasureWordCacheItemArray *array, Clay__MeasureWordCacheItem item) {
 	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
 		array->internalArray[array->length++] = item;
 		return &array->internalArray[array->length - 1];
 	}
-	return &CLAY__LAYOUT_ELEMENT_TREE_NODE_DEFAULT;
+	return &CLAY__MEASURE_WORD_CACHE_ITEM_DEFAULT;
 }
-Clay__LayoutElementTreeNode *Clay__LayoutElementTreeNodeArray_Get(Clay__LayoutElementTreeNodeArray *array, int index) {
-    return Clay__Array_RangeCheck(index, array->length) ? &array->internalArray[index] : &CLAY__LAYOUT_ELEMENT_TREE_NODE_DEFAULT;
+void Clay__MeasureWordCacheItemArray_Set(Clay__MeasureWordCacheItemArray *array, int index, Clay__MeasureWordCacheItem value) {
+	if (Clay__Array_RangeCheck(index, array->capacity)) {
+		array->internalArray[index] = value;
+		array->length = index < (int32_t)array->length ? array->length : index + 1;
+	}
 }
+#ifdef _MSC_VER
 #pragma endregion
+#endif
 // __GENERATED__ template
 
 typedef struct
 {
-    uint32_t layoutElementIndex;
-    uint32_t parentId; // This can be zero in the case of the root layout tree
-    uint32_t clipElementId; // This can be zero if there is no clip element
-    uint32_t zIndex;
-    Clay_Vector2 pointerOffset; // Only used when scroll containers are managed externally
-} Clay__LayoutElementTreeRoot;
+    Clay__MeasureTextCacheItem *measured;
+    Clay_String text;
+    Clay_TextElementConfig *config;
+    uint32_t firstWordIndex;
+} Clay__MeasureTextBatchItem;
 
-Clay__LayoutElementTreeRoot CLAY__LAYOUT_ELEMENT_TREE_ROOT_DEFAULT = CLAY__INIT(Clay__LayoutElementTreeRoot) {};
+Clay__MeasureTextBatchItem CLAY__MEASURE_TEXT_BATCH_ITEM_DEFAULT = CLAY__INIT(Clay__MeasureTextBatchItem) {};
 
-// __GENERATED__ template array_define,array_allocate,array_add,array_get TYPE=Clay__LayoutElementTreeRoot NAME=Clay__LayoutElementTreeRootArray DEFAULT_VALUE=&CLAY__LAYOUT_ELEMENT_TREE_ROOT_DEFAULT
+// __GENERATED__ template array_define,array_allocate,array_add,array_get TYPE=Clay__MeasureTextBatchItem NAME=Clay__MeasureTextBatchItemArray DEFAULT_VALUE=&CLAY__MEASURE_TEXT_BATCH_ITEM_DEFAULT
+#ifdef _MSC_VER
 #pragma region generated
+#endif
 typedef struct
 {
 	uint32_t capacity;
 	uint32_t length;
-	Clay__LayoutElementTreeRoot *internalArray;
-} Clay__LayoutElementTreeRootArray;
-Clay__LayoutElementTreeRootArray Clay__LayoutElementTreeRootArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT(Clay__LayoutElementTreeRootArray){.capacity = capacity, .length = 0, .internalArray = (Clay__LayoutElementTreeRoot *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay__LayoutElementTreeRoot), CLAY__ALIGNMENT(Clay__LayoutElementTreeRoot), arena)};
+	Clay__MeasureTextBatchItem *internalArray;
+} Clay__MeasureTextBatchItemArray;
+Clay__MeasureTextBatchItemArray Clay__MeasureTextBatchItemArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
+    Clay__MeasureTextBatchItemArray array = CLAY__INIT(Clay__MeasureTextBatchItemArray){.capacity = capacity, .length = 0, .internalArray = (Clay__MeasureTextBatchItem *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay__MeasureTextBatchItem), CLAY__ALIGNMENT(Clay__MeasureTextBatchItem), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
 }
-Clay__LayoutElementTreeRoot *Clay__LayoutElementTreeRootArray_Add(Clay__LayoutElementTreeRootArray *array, Clay__LayoutElementTreeRoot item) {
+Clay__MeasureTextBatchItem *Clay__MeasureTextBatchItemArray_Add(Clay__MeasureTextBatchItemArray *array, Clay__MeasureTextBatchItem item) {
 	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
 		array->internalArray[array->length++] = item;
 		return &array->internalArray[array->length - 1];
 	}
-	return &CLAY__LAYOUT_ELEMENT_TREE_ROOT_DEFAULT;
+	return &CLAY__MEASURE_TEXT_BATCH_ITEM_DEFAULT;
 }
-Clay__LayoutElementTreeRoot *Clay__LayoutElementTreeRootArray_Get(Clay__LayoutElementTreeRootArray *array, int index) {
-    return Clay__Array_RangeCheck(index, array->length) ? &array->internalArray[index] : &CLAY__LAYOUT_ELEMENT_TREE_ROOT_DEFAULT;
+Clay__MeasureTextBatchItem *Clay__MeasureTextBatchItemArray_Get(Clay__MeasureTextBatchItemArray *array, int index) {
+    return Clay__Array_RangeCheck(index, array->length) ? &array->internalArray[index] : &CLAY__MEASURE_TEXT_BATCH_ITEM_DEFAULT;
 }
+#ifdef _MSC_VER
 #pragma endregion
+#endif
 // __GENERATED__ template
 
-// __GENERATED__ template array_define,array_allocate TYPE=uint8_t NAME=Clay__CharArray DEFAULT_VALUE=0
+// __GENERATED__ template array_define,array_allocate,array_add TYPE=Clay_TextElementConfig* NAME=Clay__TextElementConfigPointerArray DEFAULT_VALUE=CLAY__NULL
+#ifdef _MSC_VER
 #pragma region generated
+#endif
 typedef struct
 {
 	uint32_t capacity;
 	uint32_t length;
-	uint8_t *internalArray;
-} Clay__CharArray;
-Clay__CharArray Clay__CharArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT(Clay__CharArray){.capacity = capacity, .length = 0, .internalArray = (uint8_t *)Clay__Array_Allocate_Arena(capacity, sizeof(uint8_t), CLAY__ALIGNMENT(uint8_t), arena)};
+	Clay_TextElementConfig* *internalArray;
+} Clay__TextElementConfigPointerArray;
+Clay__TextElementConfigPointerArray Clay__TextElementConfigPointerArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
+    Clay__TextElementConfigPointerArray array = CLAY__INIT(Clay__TextElementConfigPointerArray){.capacity = capacity, .length = 0, .internalArray = (Clay_TextElementConfig* *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_TextElementConfig*), CLAY__ALIGNMENT(Clay_TextElementConfig*), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
+}
+Clay_TextElementConfig* *Clay__TextElementConfigPointerArray_Add(Clay__TextElementConfigPointerArray *array, Clay_TextElementConfig* item) {
+	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
+		array->internalArray[array->length++] = item;
+		return &array->internalArray[array->length - 1];
+	}
+	return CLAY__NULL;
 }
+#ifdef _MSC_VER
 #pragma endregion
+#endif
 // __GENERATED__ template
 
-Clay_String Clay__WriteStringToCharBuffer(Clay__CharArray *buffer, Clay_String string) {
-    for (int i = 0; i < string.length; i++) {
-        buffer->internalArray[buffer->length + i] = string.chars[i];
-    }
-    buffer->length += string.length;
-    return CLAY__INIT(Clay_String) { .length = string.length, .chars = (const char *)(buffer->internalArray + buffer->length - string.length) };
-}
-
+// __GENERATED__ template array_define,array_allocate TYPE=Clay_Dimensions NAME=Clay__DimensionsArray
+#ifdef _MSC_VER
+#pragma region generated
+#endif
+typedef struct
+{
+	uint32_t capacity;
+	uint32_t length;
+	Clay_Dimensions *internalArray;
+} Clay__DimensionsArray;
+Clay__DimensionsArray Clay__DimensionsArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
+    Clay__DimensionsArray array = CLAY__INIT(Clay__DimensionsArray){.capacity = capacity, .length = 0, .internalArray = (Clay_Dimensions *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay_Dimensions), CLAY__ALIGNMENT(Clay_Dimensions), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
+}
+#ifdef _MSC_VER
+#pragma endregion
+#endif
+// __GENERATED__ template
+
+// __GENERATED__ template array_define,array_allocate TYPE=float NAME=Clay__floatArray DEFAULT_VALUE=0
+#ifdef _MSC_VER
+#pragma region generated
+#endif
+typedef struct
+{
+	uint32_t capacity;
+	uint32_t length;
+	float *internalArray;
+} Clay__floatArray;
+Clay__floatArray Clay__floatArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
+    Clay__floatArray array = CLAY__INIT(Clay__floatArray){.capacity = capacity, .length = 0, .internalArray = (float *)Clay__Array_Allocate_Arena(capacity, sizeof(float), CLAY__ALIGNMENT(float), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
+}
+#ifdef _MSC_VER
+#pragma endregion
+#endif
+// __GENERATED__ template
+
+// __GENERATED__ template array_define,array_allocate,array_get_value,array_add_value,array_set,array_remove_swapback TYPE=int32_t NAME=Clay__int32_tArray DEFAULT_VALUE=-1
+#ifdef _MSC_VER
+#pragma region generated
+#endif
+typedef struct
+{
+	uint32_t capacity;
+	uint32_t length;
+	int32_t *internalArray;
+} Clay__int32_tArray;
+Clay__int32_tArray Clay__int32_tArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
+    Clay__int32_tArray array = CLAY__INIT(Clay__int32_tArray){.capacity = capacity, .length = 0, .internalArray = (int32_t *)Clay__Array_Allocate_Arena(capacity, sizeof(int32_t), CLAY__ALIGNMENT(int32_t), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
+}
+int32_t Clay__int32_tArray_Get(Clay__int32_tArray *array, int index) {
+    return Clay__Array_RangeCheck(index, array->length) ? array->internalArray[index] : -1;
+}
+void Clay__int32_tArray_Add(Clay__int32_tArray *array, int32_t item) {
+	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
+		array->internalArray[array->length++] = item;
+	}
+}
+void Clay__int32_tArray_Set(Clay__int32_tArray *array, int index, int32_t value) {
+	if (Clay__Array_RangeCheck(index, array->capacity)) {
+		array->internalArray[index] = value;
+		array->length = index < (int32_t)array->length ? array->length : index + 1;
+	}
+}
+int32_t Clay__int32_tArray_RemoveSwapback(Clay__int32_tArray *array, int index) {
+	if (Clay__Array_RangeCheck(index, array->length)) {
+		array->length--;
+		int32_t removed = array->internalArray[index];
+		array->internalArray[index] = array->internalArray[array->length];
+		return removed;
+	}
+	return -1;
+}
+#ifdef _MSC_VER
+#pragma endregion
+#endif
+// __GENERATED__ template
+
+typedef struct
+{
+    Clay_LayoutElement *layoutElement;
+    Clay_Vector2 position;
+    Clay_Vector2 nextChildOffset;
+} Clay__LayoutElementTreeNode;
+
+Clay__LayoutElementTreeNode CLAY__LAYOUT_ELEMENT_TREE_NODE_DEFAULT = CLAY__INIT(Clay__LayoutElementTreeNode) {};
+
+// __GENERATED__ template array_define,array_allocate,array_add,array_get TYPE=Clay__LayoutElementTreeNode NAME=Clay__LayoutElementTreeNodeArray DEFAULT_VALUE=&CLAY__LAYOUT_ELEMENT_TREE_NODE_DEFAULT
+#ifdef _MSC_VER
+#pragma region generated
+#endif
+typedef struct
+{
+	uint32_t capacity;
+	uint32_t length;
+	Clay__LayoutElementTreeNode *internalArray;
+} Clay__LayoutElementTreeNodeArray;
+Clay__LayoutElementTreeNodeArray Clay__LayoutElementTreeNodeArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
+    Clay__LayoutElementTreeNodeArray array = CLAY__INIT(Clay__LayoutElementTreeNodeArray){.capacity = capacity, .length = 0, .internalArray = (Clay__LayoutElementTreeNode *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay__LayoutElementTreeNode), CLAY__ALIGNMENT(Clay__LayoutElementTreeNode), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
+}
+Clay__LayoutElementTreeNode *Clay__LayoutElementTreeNodeArray_Add(Clay__LayoutElementTreeNodeArray *array, Clay__LayoutElementTreeNode item) {
+	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
+		array->internalArray[array->length++] = item;
+		return &array->internalArray[array->length - 1];
+	}
+	return &CLAY__LAYOUT_ELEMENT_TREE_NODE_DEFAULT;
+}
+Clay__LayoutElementTreeNode *Clay__LayoutElementTreeNodeArray_Get(Clay__LayoutElementTreeNodeArray *array, int index) {
+    return Clay__Array_RangeCheck(index, array->length) ? &array->internalArray[index] : &CLAY__LAYOUT_ELEMENT_TREE_NODE_DEFAULT;
+}
+#ifdef _MSC_VER
+#pragma endregion
+#endif
+// __GENERATED__ template
+
+typedef struct
+{
+    uint32_t layoutElementIndex;
+    uint32_t parentId; // This can be zero in the case of the root layout tree
+    uint32_t clipElementId; // This can be zero if there is no clip element
+    uint32_t zIndex;
+    Clay_Vector2 pointerOffset; // Only used when scroll containers are managed externally
+    // The root's render commands, which are moved into zIndex order once every root has been laid out
+    uint32_t renderCommandsOffset;
+    uint32_t renderCommandsLength;
+    // Regions of the scratch and output arrays reserved for this root, only used when roots are laid out in parallel
+    uint32_t dfsBufferOffset;
+    uint32_t dfsBufferCapacity;
+    uint32_t renderCommandsCapacity;
+    uint32_t rectangleConfigsOffset;
+    uint32_t rectangleConfigsCapacity;
+} Clay__LayoutElementTreeRoot;
+
+Clay__LayoutElementTreeRoot CLAY__LAYOUT_ELEMENT_TREE_ROOT_DEFAULT = CLAY__INIT(Clay__LayoutElementTreeRoot) {};
+
+// __GENERATED__ template array_define,array_allocate,array_add,array_get TYPE=Clay__LayoutElementTreeRoot NAME=Clay__LayoutElementTreeRootArray DEFAULT_VALUE=&CLAY__LAYOUT_ELEMENT_TREE_ROOT_DEFAULT
+#ifdef _MSC_VER
+#pragma region generated
+#endif
+typedef struct
+{
+	uint32_t capacity;
+	uint32_t length;
+	Clay__LayoutElementTreeRoot *internalArray;
+} Clay__LayoutElementTreeRootArray;
+Clay__LayoutElementTreeRootArray Clay__LayoutElementTreeRootArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
+    Clay__LayoutElementTreeRootArray array = CLAY__INIT(Clay__LayoutElementTreeRootArray){.capacity = capacity, .length = 0, .internalArray = (Clay__LayoutElementTreeRoot *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay__LayoutElementTreeRoot), CLAY__ALIGNMENT(Clay__LayoutElementTreeRoot), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
+}
+Clay__LayoutElementTreeRoot *Clay__LayoutElementTreeRootArray_Add(Clay__LayoutElementTreeRootArray *array, Clay__LayoutElementTreeRoot item) {
+	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
+		array->internalArray[array->length++] = item;
+		return &array->internalArray[array->length - 1];
+	}
+	return &CLAY__LAYOUT_ELEMENT_TREE_ROOT_DEFAULT;
+}
+Clay__LayoutElementTreeRoot *Clay__LayoutElementTreeRootArray_Get(Clay__LayoutElementTreeRootArray *array, int index) {
+    return Clay__Array_RangeCheck(index, array->length) ? &array->internalArray[index] : &CLAY__LAYOUT_ELEMENT_TREE_ROOT_DEFAULT;
+}
+#ifdef _MSC_VER
+#pragma endregion
+#endif
+// __GENERATED__ template
+
+// Every element that pointer hit testing visits, in the order the hit test visits them
+typedef struct
+{
+    Clay_BoundingBox boundingBox; // Already adjusted by the root's pointerOffset
+    Clay_LayoutElementHashMapItem *hashMapItem;
+    int32_t rootIndex;
+} Clay__PointerHitRecord;
+
+Clay__PointerHitRecord CLAY__POINTER_HIT_RECORD_DEFAULT = CLAY__INIT(Clay__PointerHitRecord) {};
+
+// __GENERATED__ template array_define,array_allocate,array_add TYPE=Clay__PointerHitRecord NAME=Clay__PointerHitRecordArray DEFAULT_VALUE=&CLAY__POINTER_HIT_RECORD_DEFAULT
+#ifdef _MSC_VER
+#pragma region generated
+#endif
+typedef struct
+{
+	uint32_t capacity;
+	uint32_t length;
+	Clay__PointerHitRecord *internalArray;
+} Clay__PointerHitRecordArray;
+Clay__PointerHitRecordArray Clay__PointerHitRecordArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
+    Clay__PointerHitRecordArray array = CLAY__INIT(Clay__PointerHitRecordArray){.capacity = capacity, .length = 0, .internalArray = (Clay__PointerHitRecord *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay__PointerHitRecord), CLAY__ALIGNMENT(Clay__PointerHitRecord), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
+}
+Clay__PointerHitRecord *Clay__PointerHitRecordArray_Add(Clay__PointerHitRecordArray *array, Clay__PointerHitRecord item) {
+	if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {
+		array->internalArray[array->length++] = item;
+		return &array->internalArray[array->length - 1];
+	}
+	return &CLAY__POINTER_HIT_RECORD_DEFAULT;
+}
+#ifdef _MSC_VER
+#pragma endregion
+#endif
+// __GENERATED__ template
+
+// __GENERATED__ template array_define,array_allocate TYPE=uint8_t NAME=Clay__CharArray DEFAULT_VALUE=0
+#ifdef _MSC_VER
+#pragma region generated
+#endif
+typedef struct
+{
+	uint32_t capacity;
+	uint32_t length;
+	uint8_t *internalArray;
+} Clay__CharArray;
+Clay__CharArray Clay__CharArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
+    Clay__CharArray array = CLAY__INIT(Clay__CharArray){.capacity = capacity, .length = 0, .internalArray = (uint8_t *)Clay__Array_Allocate_Arena(capacity, sizeof(uint8_t), CLAY__ALIGNMENT(uint8_t), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
+}
+#ifdef _MSC_VER
+#pragma endregion
+#endif
+// __GENERATED__ template
+
+Clay_String Clay__WriteStringToCharBuffer(Clay__CharArray *buffer, Clay_String string) {
+    for (int i = 0; i < string.length; i++) {
+        buffer->internalArray[buffer->length + i] = string.chars[i];
+    }
+    buffer->length += string.length;
+    return CLAY__INIT(Clay_String) { .length = string.length, .chars = (const char *)(buffer->internalArray + buffer->length - string.length) };
+}
+
 // Global Variable Definitions ----------------------------------------------
-Clay_PointerData Clay__pointerInfo = CLAY__INIT(Clay_PointerData) { .position = {-1, -1} };
-Clay_Dimensions Clay__layoutDimensions = CLAY__INIT(Clay_Dimensions){};
 Clay_ElementId Clay__dynamicElementIndexBaseHash = CLAY__INIT(Clay_ElementId) { .id = 128476991, .stringId = { .length = 8, .chars = "Auto ID" } };
-uint32_t Clay__dynamicElementIndex = 0;
-bool Clay__debugModeEnabled = false;
-bool Clay__disableCulling = false;
-bool Clay__externalScrollHandlingEnabled = false;
-uint32_t Clay__debugSelectedElementId = 0;
 uint32_t Clay__debugViewWidth = 400;
 Clay_Color Clay__debugViewHighlightColor = CLAY__INIT(Clay_Color) { 168, 66, 28, 100 };
-uint32_t Clay__generation = 0;
-uint64_t Clay__arenaResetOffset = 0;
-Clay_Arena Clay__internalArena;
-// Layout Elements / Render Commands
-Clay_LayoutElementArray Clay__layoutElements;
-Clay_RenderCommandArray Clay__renderCommands;
-Clay__int32_tArray Clay__openLayoutElementStack;
-Clay__int32_tArray Clay__layoutElementChildren;
-Clay__int32_tArray Clay__layoutElementChildrenBuffer;
-Clay__TextElementDataArray Clay__textElementData;
-Clay__LayoutElementPointerArray Clay__imageElementPointers;
-Clay__int32_tArray Clay__reusableElementIndexBuffer;
-Clay__int32_tArray Clay__layoutElementClipElementIds;
-// Configs
-Clay__LayoutConfigArray Clay__layoutConfigs;
-Clay__ElementConfigArray Clay__elementConfigBuffer;
-Clay__ElementConfigArray Clay__elementConfigs;
-Clay__RectangleElementConfigArray Clay__rectangleElementConfigs;
-Clay__TextElementConfigArray Clay__textElementConfigs;
-Clay__ImageElementConfigArray Clay__imageElementConfigs;
-Clay__FloatingElementConfigArray Clay__floatingElementConfigs;
-Clay__ScrollElementConfigArray Clay__scrollElementConfigs;
-Clay__CustomElementConfigArray Clay__customElementConfigs;
-Clay__BorderElementConfigArray Clay__borderElementConfigs;
-// Misc Data Structures
-Clay__StringArray Clay__layoutElementIdStrings;
-Clay__WrappedTextLineArray Clay__wrappedTextLines;
-Clay__LayoutElementTreeNodeArray Clay__layoutElementTreeNodeArray1;
-Clay__LayoutElementTreeRootArray Clay__layoutElementTreeRoots;
-Clay__LayoutElementHashMapItemArray Clay__layoutElementsHashMapInternal;
-Clay__int32_tArray Clay__layoutElementsHashMap;
-Clay__MeasureTextCacheItemArray Clay__measureTextHashMapInternal;
-Clay__int32_tArray Clay__measureTextHashMapInternalFreeList;
-Clay__int32_tArray Clay__measureTextHashMap;
-Clay__MeasuredWordArray Clay__measuredWords;
-Clay__int32_tArray Clay__measuredWordsFreeList;
-Clay__int32_tArray Clay__openClipElementStack;
-Clay__ElementIdArray Clay__pointerOverIds;
-Clay__ScrollContainerDataInternalArray Clay__scrollContainerDatas;
-Clay__BoolArray Clay__treeNodeVisited;
-Clay__CharArray Clay__dynamicStringData;
-Clay__DebugElementDataArray Clay__debugElementData;
 
+// All layout state lives in a Clay_Context so that independent layouts can run concurrently on different threads.
+struct Clay_Context {
+    uint32_t maxElementCount;
+    uint32_t maxMeasureTextCacheWordCount;
+    uint32_t maxScrollContainerCount;
+    Clay_EphemeralCapacities ephemeralCapacities;
+    Clay_EphemeralCapacities adaptiveEphemeralCapacities;
+    Clay_EphemeralCapacities adaptiveEphemeralHighWaterMarks;
+    bool warningsEnabled;
+    Clay_ErrorHandler errorHandler;
+    Clay_ParallelLayoutHandler parallelLayoutHandler;
+    Clay_ArenaCommitHandler arenaCommitHandler;
+    Clay_Dimensions (*measureTextFunction)(Clay_String *text, Clay_TextElementConfig *config);
+    void (*measureTextBatchFunction)(Clay_String *words, Clay_TextElementConfig **configs, Clay_Dimensions *outDimensions, uint32_t count);
+    Clay_Vector2 (*queryScrollOffsetFunction)(uint32_t elementId);
+    uint32_t pendingMaxElementCount;
+    uint32_t failedMaxElementCount;
+    uint32_t pendingMaxScrollContainerCount;
+    uint32_t failedMaxScrollContainerCount;
+    uint32_t droppedElementCount;
+    Clay_BooleanWarnings booleanWarnings;
+    Clay__WarningArray warnings;
+
+    Clay_PointerData pointerInfo;
+    Clay_Dimensions layoutDimensions;
+    uint32_t dynamicElementIndex;
+    bool debugModeEnabled;
+    bool disableCulling;
+    bool externalScrollHandlingEnabled;
+    bool renderCommandDeltasEnabled;
+    bool compactRenderCommandsEnabled;
+    bool pointerHitGridEnabled;
+    bool idleFrameSkippingEnabled;
+    bool previousDeclarationHashValid;
+    bool layoutUnchanged;
+    uint64_t declarationHash;
+    uint64_t previousDeclarationHash;
+    uint32_t previousRenderCommandCount;
+    uint32_t debugSelectedElementId;
+    uint32_t generation;
+    uint64_t arenaResetOffset;
+    Clay_Arena internalArena;
+    bool arenaAllocationFailed; // Set when an array doesn't fit in the arena, in which case it's given a capacity of 0
+    // Layout Elements / Render Commands
+    Clay_LayoutElementArray layoutElements;
+    Clay_RenderCommandArray renderCommands;
+    Clay_RenderCommandDeltaArray renderCommandDeltas;
+    Clay_CompactRenderCommandArray compactRenderCommands;
+    Clay_CompactRenderCommandTextArray compactRenderCommandTexts;
+    Clay_DamageRectArray damageRects;
+    Clay__RenderCommandFingerprintArray renderCommandFingerprints;
+    Clay__int32_tArray renderCommandFingerprintsHashMap;
+    Clay__RenderCommandFingerprintArray previousRenderCommandFingerprints;
+    Clay__int32_tArray previousRenderCommandFingerprintsHashMap;
+    Clay__int32_tArray openLayoutElementStack;
+    Clay__int32_tArray layoutElementChildren;
+    Clay__int32_tArray layoutElementChildrenBuffer;
+    Clay__TextElementDataArray textElementData;
+    Clay__LayoutElementPointerArray imageElementPointers;
+    Clay__int32_tArray reusableElementIndexBuffer;
+    Clay__int32_tArray layoutElementClipElementIds;
+    // Configs
+    Clay__LayoutConfigArray layoutConfigs;
+    Clay__ElementConfigArray elementConfigBuffer;
+    Clay__ElementConfigArray elementConfigs;
+    Clay__RectangleElementConfigArray rectangleElementConfigs;
+    Clay__TextElementConfigArray textElementConfigs;
+    Clay__ImageElementConfigArray imageElementConfigs;
+    Clay__FloatingElementConfigArray floatingElementConfigs;
+    Clay__ScrollElementConfigArray scrollElementConfigs;
+    Clay__CustomElementConfigArray customElementConfigs;
+    Clay__BorderElementConfigArray borderElementConfigs;
+    // Misc Data Structures
+    Clay__StringArray layoutElementIdStrings;
+    Clay__WrappedTextLineArray wrappedTextLines;
+    Clay__LayoutElementTreeNodeArray layoutElementTreeNodeArray1;
+    Clay__LayoutElementTreeRootArray layoutElementTreeRoots;
+    Clay__LayoutElementHashMapItemArray layoutElementsHashMapInternal;
+    Clay__int32_tArray layoutElementsHashMapInternalFreeList;
+    Clay__LayoutElementHashMapSlotArray layoutElementsHashMap;
+    Clay__MeasureTextCacheItemArray measureTextHashMapInternal;
+    Clay__int32_tArray measureTextHashMapInternalFreeList;
+    Clay__int32_tArray measureTextHashMap;
+    Clay__MeasureWordCacheItemArray measureWordHashMapInternal;
+    Clay__int32_tArray measureWordHashMapInternalFreeList;
+    Clay__int32_tArray measureWordHashMap;
+    Clay_MeasureWordCacheStats measureWordCacheStats;
+    Clay_MemoryStats memoryStats;
+    Clay__RegisteredFontMetricsArray fontMetrics;
+    bool measureTextCachesStale; // Set when font metrics change, the caches are emptied at the start of the next layout
+    Clay__MeasuredWordArray measuredWords;
+    Clay__MeasureTextBatchItemArray measureTextBatchItems;
+    Clay__StringArray measureTextBatchWords;
+    Clay__TextElementConfigPointerArray measureTextBatchConfigs;
+    Clay__DimensionsArray measureTextBatchDimensions;
+    Clay__int32_tArray measureTextBatchWordCacheIndexes;
+    Clay__DimensionsArray measureTextBatchResults;
+    Clay__int32_tArray measureTextBatchResultSources;
+    bool textMeasurementDeferred;
+    Clay__int32_tArray measuredWordsFreeList;
+    Clay__MeasuredWordArray wrappedLineCache;
+    Clay__int32_tArray wrappedLineCacheFreeList;
+    Clay__int32_tArray openClipElementStack;
+    Clay__floatArray sizeDistributionCapacities;
+    Clay__ElementIdArray pointerOverIds; // Topmost root first, and the deepest or last sibling first within each root
+    uint32_t pointerOverGeneration; // Incremented by each call to Clay_SetPointerState
+    int32_t pointerOverRootIndex;
+    uint32_t pointerOverRootStart;
+    // Element boxes recorded by the first pointer query after each layout, and a uniform grid over them built by the second
+    bool pointerHitRecordsValid;
+    bool pointerHitGridValid;
+    Clay__PointerHitRecordArray pointerHitRecords;
+    Clay__ElementIdArray pointHitTestIds;
+    Clay__int32_tArray pointerHitGridCells; // The end of each cell's range in pointerHitGridEntries
+    Clay__int32_tArray pointerHitGridEntries; // Indexes into pointerHitRecords, ascending within each cell
+    Clay_BoundingBox pointerHitGridBounds;
+    int32_t pointerHitGridColumns;
+    int32_t pointerHitGridRows;
+    Clay__ScrollContainerDataInternalArray scrollContainerDatas;
+    Clay__BoolArray treeNodeVisited;
+    Clay__CharArray dynamicStringData;
+    Clay__DebugElementDataArray debugElementData;
+};
+
+CLAY__THREAD_LOCAL Clay_Context *Clay__currentContext = CLAY__NULL;
+
+Clay_Context* Clay__Context_Allocate_Arena(Clay_Arena *arena) {
+    uintptr_t nextAllocAddress = arena->nextAllocation + (uintptr_t)arena->memory;
+    uintptr_t arenaOffsetAligned = nextAllocAddress + (CLAY__ALIGNMENT(Clay_Context) - (nextAllocAddress % CLAY__ALIGNMENT(Clay_Context)));
+    arenaOffsetAligned -= (uintptr_t)arena->memory;
+    if (arenaOffsetAligned + sizeof(Clay_Context) > arena->capacity) {
+        return CLAY__NULL;
+    }
+    arena->nextAllocation = arenaOffsetAligned + sizeof(Clay_Context);
+    return (Clay_Context*)((uintptr_t)arena->memory + arenaOffsetAligned);
+}
+
+Clay__WarningArray Clay__WarningArray_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
+    size_t totalSizeBytes = capacity * sizeof(Clay_String);
+    Clay__WarningArray array = CLAY__INIT(Clay__WarningArray){.length = 0};
+    uintptr_t nextAllocAddress = arena->nextAllocation + (uintptr_t)arena->memory;
+    uintptr_t arenaOffsetAligned = nextAllocAddress + (CLAY__ALIGNMENT(Clay_String) - (nextAllocAddress % CLAY__ALIGNMENT(Clay_String)));
+    arenaOffsetAligned -= (uintptr_t)arena->memory;
+    if (arenaOffsetAligned + totalSizeBytes <= arena->capacity) {
+        array.internalArray = (Clay__Warning*)((uintptr_t)arena->memory + (uintptr_t)arenaOffsetAligned);
+        array.capacity = capacity;
+        arena->nextAllocation = arenaOffsetAligned + totalSizeBytes;
+    }
+    else {
+        Clay_Context* context = Clay_GetCurrentContext();
+        context->arenaAllocationFailed = true;
+        context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+            .errorType = CLAY_ERROR_TYPE_ARENA_CAPACITY_EXCEEDED,
+            .errorText = CLAY_STRING("Clay attempted to allocate memory in its arena, but ran out of capacity. Try increasing the capacity of the arena passed to Clay_Initialize()"),
+            .userData = context->errorHandler.userData });
+    }
+    return array;
+}
+
+void* Clay__Array_Allocate_Arena(uint32_t capacity, uint32_t itemSize, uint32_t alignment, Clay_Arena *arena)
+{
+    size_t totalSizeBytes = capacity * itemSize;
+    uintptr_t nextAllocAddress = arena->nextAllocation + (uintptr_t)arena->memory;
+    uintptr_t arenaOffsetAligned = nextAllocAddress + (alignment - (nextAllocAddress % alignment));
+    arenaOffsetAligned -= (uintptr_t)arena->memory;
+    if (arenaOffsetAligned + totalSizeBytes <= arena->capacity) {
+        arena->nextAllocation = arenaOffsetAligned + totalSizeBytes;
+        return (void*)((uintptr_t)arena->memory + (uintptr_t)arenaOffsetAligned);
+    }
+    else {
+        // The generated allocate functions give an array with no memory a capacity of 0, so that adding to it fails safely
+        Clay_Context* context = Clay_GetCurrentContext();
+        context->arenaAllocationFailed = true;
+        context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+                .errorType = CLAY_ERROR_TYPE_ARENA_CAPACITY_EXCEEDED,
+                .errorText = CLAY_STRING("Clay attempted to allocate memory in its arena, but ran out of capacity. Try increasing the capacity of the arena passed to Clay_Initialize()"),
+                .userData = context->errorHandler.userData });
+    }
+    return CLAY__NULL;
+}
+
+bool Clay__Array_RangeCheck(int index, uint32_t length)
+{
+    if (index >= 0 && index < (int32_t)length) {
+        return true;
+    }
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+            .errorType = CLAY_ERROR_TYPE_INTERNAL_ERROR,
+            .errorText = CLAY_STRING("Clay attempted to make an out of bounds array access. This is an internal error and is likely a bug."),
+            .userData = context->errorHandler.userData });
+    return false;
+}
+
+bool Clay__Array_AddCapacityCheck(uint32_t length, uint32_t capacity)
+{
+    if (length < capacity) {
+        return true;
+    }
+    Clay_Context* context = Clay_GetCurrentContext();
+    // Only report the first overflow each frame, since a full array usually overflows many times
+    if (!context->booleanWarnings.arrayCapacityExceeded) {
+        context->booleanWarnings.arrayCapacityExceeded = true;
+        context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+            .errorType = CLAY_ERROR_TYPE_INTERNAL_ERROR,
+            .errorText = CLAY_STRING("Clay attempted to make an out of bounds array access. If you've lowered any capacities with Clay_SetEphemeralCapacities(), try raising them. Otherwise, this is an internal error and is likely a bug."),
+            .userData = context->errorHandler.userData });
+    }
+    return false;
+}
+
+
+// The functions used by contexts that are created while no other context is current
 #if CLAY_WASM
     __attribute__((import_module("clay"), import_name("measureTextFunction"))) Clay_Dimensions Clay__MeasureText(Clay_String *text, Clay_TextElementConfig *config);
     __attribute__((import_module("clay"), import_name("queryScrollOffsetFunction"))) Clay_Vector2 Clay__QueryScrollOffset(uint32_t elementId);
+    Clay_Dimensions (*Clay__defaultMeasureTextFunction)(Clay_String *text, Clay_TextElementConfig *config) = Clay__MeasureText;
+    #ifdef CLAY_WASM_MEASURE_TEXT_BATCH
+    // Every call to measureTextFunction is a crossing into JS, so the measureTextBatchFunction import is always used when it's enabled
+    __attribute__((import_module("clay"), import_name("measureTextBatchFunction"))) void Clay__MeasureTextBatch(Clay_String *words, Clay_TextElementConfig **configs, Clay_Dimensions *outDimensions, uint32_t count);
+    void (*Clay__defaultMeasureTextBatchFunction)(Clay_String *words, Clay_TextElementConfig **configs, Clay_Dimensions *outDimensions, uint32_t count) = Clay__MeasureTextBatch;
+    #else
+    void (*Clay__defaultMeasureTextBatchFunction)(Clay_String *words, Clay_TextElementConfig **configs, Clay_Dimensions *outDimensions, uint32_t count) = CLAY__NULL;
+    #endif
+    Clay_Vector2 (*Clay__defaultQueryScrollOffsetFunction)(uint32_t elementId) = Clay__QueryScrollOffset;
 #else
-    Clay_Dimensions (*Clay__MeasureText)(Clay_String *text, Clay_TextElementConfig *config);
-    Clay_Vector2 (*Clay__QueryScrollOffset)(uint32_t elementId);
+    Clay_Dimensions (*Clay__defaultMeasureTextFunction)(Clay_String *text, Clay_TextElementConfig *config) = CLAY__NULL;
+    void (*Clay__defaultMeasureTextBatchFunction)(Clay_String *words, Clay_TextElementConfig **configs, Clay_Dimensions *outDimensions, uint32_t count) = CLAY__NULL;
+    Clay_Vector2 (*Clay__defaultQueryScrollOffsetFunction)(uint32_t elementId) = CLAY__NULL;
 #endif
 
+bool Clay__MeasureTextIsBatched(void) {
+    return Clay_GetCurrentContext()->measureTextBatchFunction != CLAY__NULL;
+}
+
 Clay_LayoutElement* Clay__GetOpenLayoutElement() {
-    return Clay_LayoutElementArray_Get(&Clay__layoutElements, Clay__int32_tArray_Get(&Clay__openLayoutElementStack, Clay__openLayoutElementStack.length - 1));
+    Clay_Context* context = Clay_GetCurrentContext();
+    return Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_Get(&context->openLayoutElementStack, context->openLayoutElementStack.length - 1));
+}
+
+uint32_t Clay__GetParentElementChildCount(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    return Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_Get(&context->openLayoutElementStack, (int)context->openLayoutElementStack.length - 2))->children.length;
+}
+
+uint32_t Clay__GetOpenLayoutElementId(void) {
+    return Clay__GetOpenLayoutElement()->id;
 }
 
 bool Clay__ElementHasConfig(Clay_LayoutElement *element, Clay__ElementConfigType type) {
     return (element->configsEnabled & type);
 }
 
+#define CLAY__ELEMENT_CONFIG_SLOT_BITS 3
+#define CLAY__ELEMENT_CONFIG_SLOT_UNKNOWN 7 // The slot didn't fit in CLAY__ELEMENT_CONFIG_SLOT_BITS, so the config has to be searched for
+
+uint32_t Clay__ElementConfigSlotShift(Clay__ElementConfigType type) {
+    switch (type) {
+        case CLAY__ELEMENT_CONFIG_TYPE_RECTANGLE: return 8;
+        case CLAY__ELEMENT_CONFIG_TYPE_BORDER_CONTAINER: return 8 + CLAY__ELEMENT_CONFIG_SLOT_BITS;
+        case CLAY__ELEMENT_CONFIG_TYPE_FLOATING_CONTAINER: return 8 + CLAY__ELEMENT_CONFIG_SLOT_BITS * 2;
+        case CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER: return 8 + CLAY__ELEMENT_CONFIG_SLOT_BITS * 3;
+        case CLAY__ELEMENT_CONFIG_TYPE_IMAGE: return 8 + CLAY__ELEMENT_CONFIG_SLOT_BITS * 4;
+        case CLAY__ELEMENT_CONFIG_TYPE_TEXT: return 8 + CLAY__ELEMENT_CONFIG_SLOT_BITS * 5;
+        default: return 8 + CLAY__ELEMENT_CONFIG_SLOT_BITS * 6;
+    }
+}
+
+// Only the first config of each type is recorded, as that's the one Clay__FindElementConfigWithType returns
+void Clay__AddElementConfigSlot(Clay_LayoutElement *element, Clay__ElementConfigType type, int32_t slot) {
+    if (!(element->configsEnabled & type)) {
+        element->configsEnabled |= type | ((uint32_t)CLAY__MIN(slot, CLAY__ELEMENT_CONFIG_SLOT_UNKNOWN) << Clay__ElementConfigSlotShift(type));
+    }
+}
+
 Clay_ElementConfigUnion Clay__FindElementConfigWithType(Clay_LayoutElement *element, Clay__ElementConfigType type) {
-    for (int i = 0; i < element->elementConfigs.length; i++) {
+    if (!(element->configsEnabled & type)) {
+        return CLAY__INIT(Clay_ElementConfigUnion) { NULL };
+    }
+    uint32_t slot = (element->configsEnabled >> Clay__ElementConfigSlotShift(type)) & CLAY__ELEMENT_CONFIG_SLOT_UNKNOWN;
+    if (slot != CLAY__ELEMENT_CONFIG_SLOT_UNKNOWN) {
+        return element->elementConfigs.internalArray[slot].config;
+    }
+    for (int32_t i = CLAY__ELEMENT_CONFIG_SLOT_UNKNOWN; i < (int32_t)element->elementConfigs.length; i++) {
         Clay_ElementConfig *config = Clay__ElementConfigArraySlice_Get(&element->elementConfigs, i);
         if (config->type == type) {
             return config->config;
@@ -1554,11 +2665,41 @@ uint32_t Clay__RehashWithNumber(uint32_t id, uint32_t number) {
     return id;
 }
 
+// Hashes eight bytes at a time. Byte-wise loads are used so that there are no alignment requirements, compilers combine them into single loads.
+uint64_t Clay__HashStringContents(Clay_String *text, uint64_t seed) {
+    const uint8_t *chars = (const uint8_t *)text->chars;
+    // The seed is mixed on its own first, otherwise seeds that differ in a few low bits can cancel out against the contents
+    uint64_t hash = (seed + 0x9E3779B97F4A7C15ull) * 0xBF58476D1CE4E5B9ull;
+    hash = (hash ^ (hash >> 31) ^ (uint64_t)text->length) * 0x94D049BB133111EBull;
+    int32_t i = 0;
+    for (; i + 8 <= text->length; i += 8) {
+        uint64_t block = (uint64_t)chars[i] | (uint64_t)chars[i + 1] << 8 | (uint64_t)chars[i + 2] << 16 | (uint64_t)chars[i + 3] << 24
+            | (uint64_t)chars[i + 4] << 32 | (uint64_t)chars[i + 5] << 40 | (uint64_t)chars[i + 6] << 48 | (uint64_t)chars[i + 7] << 56;
+        hash = (hash ^ block) * 0xBF58476D1CE4E5B9ull;
+        hash ^= hash >> 31;
+    }
+    uint64_t tail = 0;
+    for (int32_t shift = 0; i < text->length; ++i, shift += 8) {
+        tail |= (uint64_t)chars[i] << shift;
+    }
+    hash = (hash ^ tail) * 0x94D049BB133111EBull;
+    return hash ^ (hash >> 29);
+}
+
+uint64_t Clay__HashBytes(const void *data, int32_t length, uint64_t seed) {
+    Clay_String bytes = CLAY__INIT(Clay_String) { .length = length, .chars = (const char *)data };
+    return Clay__HashStringContents(&bytes, seed);
+}
+
 uint32_t Clay__HashTextWithConfig(Clay_String *text, Clay_TextElementConfig *config) {
     uint32_t hash = 0;
-    uintptr_t pointerAsNumber = (uintptr_t)text->chars;
-
-    hash += pointerAsNumber;
+    if (config->hashStringContents) {
+        uint64_t contentsHash = Clay__HashStringContents(text, 0);
+        hash += (uint32_t)(contentsHash ^ (contentsHash >> 32));
+    } else {
+        uintptr_t pointerAsNumber = (uintptr_t)text->chars;
+        hash += pointerAsNumber;
+    }
     hash += (hash << 10);
     hash ^= (hash >> 6);
 
@@ -1593,56 +2734,124 @@ uint32_t Clay__HashTextWithConfig(Clay_String *text, Clay_TextElementConfig *con
 }
 
 Clay__MeasuredWord *Clay__AddMeasuredWord(Clay__MeasuredWord word, Clay__MeasuredWord *previousWord) {
-    if (Clay__measuredWordsFreeList.length > 0) {
-        uint32_t newItemIndex = Clay__int32_tArray_Get(&Clay__measuredWordsFreeList, (int)Clay__measuredWordsFreeList.length - 1);
-        Clay__measuredWordsFreeList.length--;
-        Clay__MeasuredWordArray_Set(&Clay__measuredWords, (int)newItemIndex, word);
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->measuredWordsFreeList.length > 0) {
+        uint32_t newItemIndex = Clay__int32_tArray_Get(&context->measuredWordsFreeList, (int)context->measuredWordsFreeList.length - 1);
+        context->measuredWordsFreeList.length--;
+        Clay__MeasuredWordArray_Set(&context->measuredWords, (int)newItemIndex, word);
         previousWord->next = (int32_t)newItemIndex;
-        return Clay__MeasuredWordArray_Get(&Clay__measuredWords, (int)newItemIndex);
+        return Clay__MeasuredWordArray_Get(&context->measuredWords, (int)newItemIndex);
     } else {
-        previousWord->next = (int32_t)Clay__measuredWords.length;
-        return Clay__MeasuredWordArray_Add(&Clay__measuredWords, word);
+        previousWord->next = (int32_t)context->measuredWords.length;
+        return Clay__MeasuredWordArray_Add(&context->measuredWords, word);
     }
 }
 
-Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_TextElementConfig *config) {
-    #ifndef CLAY_WASM
-    if (!Clay__MeasureText) {
-        Clay__errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
-            .errorType = CLAY_ERROR_TYPE_TEXT_MEASUREMENT_FUNCTION_NOT_PROVIDED,
-            .errorText = CLAY_STRING("Clay's internal MeasureText function is null. You may have forgotten to call Clay_SetMeasureTextFunction(), or passed a NULL function pointer by mistake."),
-            .userData = Clay__errorHandler.userData });
-        return NULL;
+Clay_FontMetrics *Clay__GetFontMetrics(uint16_t fontId) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    for (int32_t i = 0; i < (int32_t)context->fontMetrics.length; ++i) {
+        Clay__RegisteredFontMetrics *registered = Clay__RegisteredFontMetricsArray_Get(&context->fontMetrics, i);
+        if (registered->fontId == fontId) {
+            return &registered->metrics;
+        }
     }
-    #endif
-    uint32_t id = Clay__HashTextWithConfig(text, config);
-    uint32_t hashBucket = id % (Clay__maxMeasureTextCacheWordCount / 32);
+    return CLAY__NULL;
+}
+
+float Clay__GetKerningAdjustment(Clay_FontMetrics *metrics, uint32_t first, uint32_t second) {
+    int32_t low = 0;
+    int32_t high = (int32_t)metrics->kerningPairCount - 1;
+    while (low <= high) {
+        int32_t middle = (low + high) / 2;
+        const Clay_FontKerningPair *pair = &metrics->kerningPairs[middle];
+        if (pair->first == first && pair->second == second) {
+            return pair->adjustment;
+        }
+        if (pair->first < first || (pair->first == first && pair->second < second)) {
+            low = middle + 1;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return 0;
+}
+
+// Measures text using metrics registered with Clay_RegisterFontMetrics, in the same way as the reference renderers:
+// the widest line in the string, and the height of a single line.
+Clay_Dimensions Clay__MeasureTextWithFontMetrics(Clay_String *text, Clay_TextElementConfig *config, Clay_FontMetrics *metrics) {
+    const uint8_t *chars = (const uint8_t *)text->chars;
+    float scale = metrics->baseSize > 0 ? (float)config->fontSize / metrics->baseSize : 1;
+    float maxLineWidth = 0;
+    float lineWidth = 0;
+    uint32_t previousCodepoint = 0;
+    int32_t i = 0;
+    while (i < text->length) {
+        uint32_t codepoint = chars[i];
+        // Decode UTF-8, treating malformed sequences as single bytes
+        int32_t sequenceLength = codepoint < 0x80 ? 1 : (codepoint & 0xE0) == 0xC0 ? 2 : (codepoint & 0xF0) == 0xE0 ? 3 : (codepoint & 0xF8) == 0xF0 ? 4 : 1;
+        if (sequenceLength > 1 && i + sequenceLength <= text->length) {
+            codepoint &= 0xFF >> (sequenceLength + 1);
+            for (int32_t j = 1; j < sequenceLength; ++j) {
+                codepoint = (codepoint << 6) | (chars[i + j] & 0x3F);
+            }
+        } else {
+            sequenceLength = 1;
+        }
+        i += sequenceLength;
+        if (codepoint == '\n') {
+            maxLineWidth = CLAY__MAX(maxLineWidth, lineWidth);
+            lineWidth = 0;
+            previousCodepoint = 0;
+            continue;
+        }
+        if (previousCodepoint != 0) {
+            lineWidth += (metrics->kerningPairCount > 0 ? Clay__GetKerningAdjustment(metrics, previousCodepoint, codepoint) * scale : 0) + config->letterSpacing;
+        }
+        lineWidth += (codepoint < metrics->advanceCount ? metrics->advances[codepoint] : metrics->fallbackAdvance) * scale;
+        previousCodepoint = codepoint;
+    }
+    return CLAY__INIT(Clay_Dimensions) { .width = CLAY__MAX(maxLineWidth, lineWidth), .height = metrics->lineHeight * scale };
+}
+
+bool Clay__CharsEqual(const char *a, const char *b, int32_t length) {
+    for (int32_t i = 0; i < length; ++i) {
+        if (a[i] != b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Finds the cache entry for a word, or adds an empty one if it isn't cached. Returns NULL if the word isn't cached and either the cache is full or the word is too long to cache.
+Clay__MeasureWordCacheItem *Clay__GetOrAddMeasureWordCacheItem(Clay_String *word, Clay_TextElementConfig *config, int32_t *itemIndex, bool *found) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    *found = false;
+    if (word->length > CLAY__MEASURE_WORD_CACHE_MAX_WORD_LENGTH) {
+        return CLAY__NULL;
+    }
+    // Measurements are shared between every string using the same font, so only the fields that affect the size of glyphs are part of the key
+    uint64_t id = Clay__HashStringContents(word, (uint64_t)config->fontId | (uint64_t)config->fontSize << 16 | (uint64_t)config->letterSpacing << 32);
+    uint32_t hashBucket = (uint32_t)(id % context->measureWordHashMap.capacity);
     int32_t elementIndexPrevious = 0;
-    int32_t elementIndex = Clay__measureTextHashMap.internalArray[hashBucket];
+    int32_t elementIndex = context->measureWordHashMap.internalArray[hashBucket];
     while (elementIndex != 0) {
-        Clay__MeasureTextCacheItem *hashEntry = Clay__MeasureTextCacheItemArray_Get(&Clay__measureTextHashMapInternal, elementIndex);
-        if (hashEntry->id == id) {
-            hashEntry->generation = Clay__generation;
+        Clay__MeasureWordCacheItem *hashEntry = Clay__MeasureWordCacheItemArray_Get(&context->measureWordHashMapInternal, elementIndex);
+        if (hashEntry->id == id && hashEntry->fontId == config->fontId && hashEntry->fontSize == config->fontSize && hashEntry->letterSpacing == config->letterSpacing
+            && hashEntry->length == word->length && Clay__CharsEqual(hashEntry->chars, word->chars, word->length)) {
+            hashEntry->generation = context->generation;
+            *itemIndex = elementIndex;
+            *found = true;
             return hashEntry;
         }
-        // This element hasn't been seen in a few frames, delete the hash map item
-        if (Clay__generation - hashEntry->generation > 2) {
-            // Add all the measured words that were included in this measurement to the freelist
-            int32_t nextWordIndex = hashEntry->measuredWordsStartIndex;
-            while (nextWordIndex != -1) {
-                Clay__MeasuredWord *measuredWord = Clay__MeasuredWordArray_Get(&Clay__measuredWords, nextWordIndex);
-                Clay__int32_tArray_Add(&Clay__measuredWordsFreeList, nextWordIndex);
-                nextWordIndex = measuredWord->next;
-            }
-
-            uint32_t nextIndex = hashEntry->nextIndex;
-            Clay__MeasureTextCacheItemArray_Set(&Clay__measureTextHashMapInternal, elementIndex, CLAY__INIT(Clay__MeasureTextCacheItem) { .measuredWordsStartIndex = -1 });
-            Clay__int32_tArray_Add(&Clay__measureTextHashMapInternalFreeList, elementIndex);
+        // This word hasn't been seen in a few frames, delete the hash map item
+        if (context->generation - hashEntry->generation > 2 && hashEntry->batchIndex == -1) {
+            context->memoryStats.measureWordCache.evictionCount++;
+            int32_t nextIndex = hashEntry->nextIndex;
+            Clay__int32_tArray_Add(&context->measureWordHashMapInternalFreeList, elementIndex);
             if (elementIndexPrevious == 0) {
-                Clay__measureTextHashMap.internalArray[hashBucket] = nextIndex;
+                context->measureWordHashMap.internalArray[hashBucket] = nextIndex;
             } else {
-                Clay__MeasureTextCacheItem *previousHashEntry = Clay__MeasureTextCacheItemArray_Get(&Clay__measureTextHashMapInternal, elementIndexPrevious);
-                previousHashEntry->nextIndex = nextIndex;
+                Clay__MeasureWordCacheItemArray_Get(&context->measureWordHashMapInternal, elementIndexPrevious)->nextIndex = nextIndex;
             }
             elementIndex = nextIndex;
         } else {
@@ -1651,52 +2860,86 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
         }
     }
 
-    uint32_t newItemIndex = 0;
-    Clay__MeasureTextCacheItem newCacheItem = CLAY__INIT(Clay__MeasureTextCacheItem) { .measuredWordsStartIndex = -1, .id = id, .generation = Clay__generation };
-    Clay__MeasureTextCacheItem *measured = NULL;
-    if (Clay__measureTextHashMapInternalFreeList.length > 0) {
-        newItemIndex = Clay__int32_tArray_Get(&Clay__measureTextHashMapInternalFreeList, Clay__measureTextHashMapInternalFreeList.length - 1);
-        Clay__measureTextHashMapInternalFreeList.length--;
-        Clay__MeasureTextCacheItemArray_Set(&Clay__measureTextHashMapInternal, newItemIndex, newCacheItem);
-        measured = Clay__MeasureTextCacheItemArray_Get(&Clay__measureTextHashMapInternal, newItemIndex);
+    Clay__MeasureWordCacheItem newCacheItem = CLAY__INIT(Clay__MeasureWordCacheItem) {
+        .id = id, .nextIndex = context->measureWordHashMap.internalArray[hashBucket], .generation = context->generation, .batchIndex = -1,
+        .fontId = config->fontId, .fontSize = config->fontSize, .letterSpacing = config->letterSpacing, .length = (uint8_t)word->length
+    };
+    for (int32_t i = 0; i < word->length; ++i) {
+        newCacheItem.chars[i] = word->chars[i];
+    }
+    if (context->measureWordHashMapInternalFreeList.length > 0) {
+        *itemIndex = Clay__int32_tArray_Get(&context->measureWordHashMapInternalFreeList, (int)context->measureWordHashMapInternalFreeList.length - 1);
+        context->measureWordHashMapInternalFreeList.length--;
+        Clay__MeasureWordCacheItemArray_Set(&context->measureWordHashMapInternal, *itemIndex, newCacheItem);
+    } else if (context->measureWordHashMapInternal.length < context->measureWordHashMapInternal.capacity) {
+        *itemIndex = (int32_t)context->measureWordHashMapInternal.length;
+        Clay__MeasureWordCacheItemArray_Add(&context->measureWordHashMapInternal, newCacheItem);
     } else {
-        if (Clay__measureTextHashMapInternal.length == Clay__measureTextHashMapInternal.capacity - 1) {
-            if (Clay__booleanWarnings.maxTextMeasureCacheExceeded) {
-                Clay__errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
-                        .errorType = CLAY_ERROR_TYPE_ELEMENTS_CAPACITY_EXCEEDED,
-                        .errorText = CLAY_STRING("Clay ran out of capacity while attempting to measure text elements. Try using Clay_SetMaxElementCount() with a higher value."),
-                        .userData = Clay__errorHandler.userData });
-                Clay__booleanWarnings.maxTextMeasureCacheExceeded = true;
-            }
-            return &CLAY__MEASURE_TEXT_CACHE_ITEM_DEFAULT;
-        }
-        measured = Clay__MeasureTextCacheItemArray_Add(&Clay__measureTextHashMapInternal, newCacheItem);
-        newItemIndex = Clay__measureTextHashMapInternal.length - 1;
+        return CLAY__NULL;
     }
+    context->measureWordHashMap.internalArray[hashBucket] = *itemIndex;
+    return Clay__MeasureWordCacheItemArray_Get(&context->measureWordHashMapInternal, *itemIndex);
+}
 
+// Measures a single word, only calling the user's MeasureText function if the same word hasn't been measured with the same font recently
+Clay_Dimensions Clay__MeasureWordCached(Clay_String *word, Clay_TextElementConfig *config) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_FontMetrics *fontMetrics = Clay__GetFontMetrics(config->fontId);
+    if (fontMetrics) {
+        return Clay__MeasureTextWithFontMetrics(word, config, fontMetrics);
+    }
+    int32_t itemIndex = 0;
+    bool found = false;
+    Clay__MeasureWordCacheItem *cacheItem = Clay__GetOrAddMeasureWordCacheItem(word, config, &itemIndex, &found);
+    if (found && cacheItem->batchIndex == -1) {
+        context->measureWordCacheStats.hitCount++;
+        return cacheItem->dimensions;
+    }
+    context->measureWordCacheStats.missCount++;
+    Clay_Dimensions dimensions = context->measureTextFunction(word, config);
+    if (cacheItem) {
+        cacheItem->dimensions = dimensions;
+    }
+    return dimensions;
+}
+
+// Splits text into words and measures them. If batchDimensions is provided, it must hold the results of measuring the words
+// returned by Clay__AddMeasureTextBatchItem, in the same order.
+bool Clay__MeasureTextWords(Clay__MeasureTextCacheItem *measured, Clay_String *text, Clay_TextElementConfig *config, Clay_Dimensions *batchDimensions) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    #ifndef CLAY_WASM
+    if (!batchDimensions && !context->measureTextFunction && !Clay__GetFontMetrics(config->fontId)) {
+        context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+            .errorType = CLAY_ERROR_TYPE_TEXT_MEASUREMENT_CAPACITY_EXCEEDED,
+            .errorText = CLAY_STRING("A text element has more words than fit in a single call to the batch MeasureText function. Try using Clay_SetMaxElementCount() with a higher value, or also providing Clay_SetMeasureTextFunction()."),
+            .userData = context->errorHandler.userData });
+        return false;
+    }
+    #endif
     uint32_t start = 0;
     uint32_t end = 0;
     float measuredWidth = 0;
     float measuredHeight = 0;
-    float spaceWidth = Clay__MeasureText(&CLAY__SPACECHAR, config).width;
+    uint32_t batchIndex = 0;
+    float spaceWidth = batchDimensions ? batchDimensions[batchIndex++].width : Clay__MeasureWordCached(&CLAY__SPACECHAR, config).width;
     Clay__MeasuredWord tempWord = { .next = -1 };
     Clay__MeasuredWord *previousWord = &tempWord;
-    while (end < text->length) {
-        if (Clay__measuredWords.length == Clay__measuredWords.capacity - 1) {
-            if (!Clay__booleanWarnings.maxTextMeasureCacheExceeded) {
-                Clay__errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+    while (end < (uint32_t)text->length) {
+        if (context->measuredWords.length == context->measuredWords.capacity - 1) {
+            if (!context->booleanWarnings.maxTextMeasureCacheExceeded) {
+                context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
                     .errorType = CLAY_ERROR_TYPE_TEXT_MEASUREMENT_CAPACITY_EXCEEDED,
                     .errorText = CLAY_STRING("Clay has run out of space in it's internal text measurement cache. Try using Clay_SetMaxMeasureTextCacheWordCount() (default 16384, with 1 unit storing 1 measured word)."),
-                    .userData = Clay__errorHandler.userData });
-                Clay__booleanWarnings.maxTextMeasureCacheExceeded = true;
+                    .userData = context->errorHandler.userData });
+                context->booleanWarnings.maxTextMeasureCacheExceeded = true;
             }
-            return &CLAY__MEASURE_TEXT_CACHE_ITEM_DEFAULT;
+            return false;
         }
         char current = text->chars[end];
         if (current == ' ' || current == '\n') {
             uint32_t length = end - start;
             Clay_String word = CLAY__INIT(Clay_String) { .length = (int)length, .chars = &text->chars[start] };
-            Clay_Dimensions dimensions = Clay__MeasureText(&word, config);
+            Clay_Dimensions dimensions = batchDimensions ? batchDimensions[batchIndex++] : Clay__MeasureWordCached(&word, config);
             if (current == ' ') {
                 dimensions.width += spaceWidth;
                 previousWord = Clay__AddMeasuredWord(CLAY__INIT(Clay__MeasuredWord) { .startOffset = start, .length = length + 1, .width = dimensions.width, .next = -1 }, previousWord);
@@ -1715,7 +2958,7 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
     }
     if (end - start > 0) {
         Clay_String lastWord = CLAY__INIT(Clay_String) { .length = (int)(end - start), .chars = &text->chars[start] };
-        Clay_Dimensions dimensions = Clay__MeasureText(&lastWord, config);
+        Clay_Dimensions dimensions = batchDimensions ? batchDimensions[batchIndex++] : Clay__MeasureWordCached(&lastWord, config);
         Clay__AddMeasuredWord(CLAY__INIT(Clay__MeasuredWord) { .startOffset = start, .length = end - start, .width = dimensions.width, .next = -1 }, previousWord);
         measuredWidth += dimensions.width;
         measuredHeight = dimensions.height;
@@ -1723,82 +2966,453 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
     measured->measuredWordsStartIndex = tempWord.next;
     measured->unwrappedDimensions.width = measuredWidth;
     measured->unwrappedDimensions.height = measuredHeight;
+    return true;
+}
+
+// Measures every queued word with a single call to the batch measurement function, then fills in the word and text cache items that were waiting on them
+void Clay__ResolveMeasureTextBatch(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->measureTextBatchItems.length == 0) {
+        return;
+    }
+    if (context->measureTextBatchWords.length > 0) {
+        context->measureTextBatchFunction(context->measureTextBatchWords.internalArray, context->measureTextBatchConfigs.internalArray, context->measureTextBatchDimensions.internalArray, context->measureTextBatchWords.length);
+    }
+    for (int32_t i = 0; i < (int32_t)context->measureTextBatchWords.length; ++i) {
+        int32_t cacheIndex = Clay__int32_tArray_Get(&context->measureTextBatchWordCacheIndexes, i);
+        if (cacheIndex != -1) {
+            Clay__MeasureWordCacheItem *cacheItem = Clay__MeasureWordCacheItemArray_Get(&context->measureWordHashMapInternal, cacheIndex);
+            cacheItem->dimensions = context->measureTextBatchDimensions.internalArray[i];
+            cacheItem->batchIndex = -1;
+        }
+    }
+    for (int32_t i = 0; i < (int32_t)context->measureTextBatchResults.length; ++i) {
+        int32_t source = Clay__int32_tArray_Get(&context->measureTextBatchResultSources, i);
+        if (source != -1) {
+            context->measureTextBatchResults.internalArray[i] = context->measureTextBatchDimensions.internalArray[source];
+        }
+    }
+    for (int32_t i = 0; i < (int32_t)context->measureTextBatchItems.length; ++i) {
+        Clay__MeasureTextBatchItem *batchItem = Clay__MeasureTextBatchItemArray_Get(&context->measureTextBatchItems, i);
+        if (!Clay__MeasureTextWords(batchItem->measured, &batchItem->text, batchItem->config, &context->measureTextBatchResults.internalArray[batchItem->firstWordIndex])) {
+            break;
+        }
+    }
+    context->measureTextBatchItems.length = 0;
+    context->measureTextBatchWords.length = 0;
+    context->measureTextBatchConfigs.length = 0;
+    context->measureTextBatchWordCacheIndexes.length = 0;
+    context->measureTextBatchResults.length = 0;
+    context->measureTextBatchResultSources.length = 0;
+}
+
+// Words that are already in the word cache don't need to be sent to the batch function, and repeated words are only sent once
+void Clay__AddMeasureTextBatchWord(Clay_String word, Clay_TextElementConfig *config) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    int32_t itemIndex = -1;
+    bool found = false;
+    Clay__MeasureWordCacheItem *cacheItem = Clay__GetOrAddMeasureWordCacheItem(&word, config, &itemIndex, &found);
+    Clay_Dimensions dimensions = CLAY__INIT(Clay_Dimensions) {};
+    int32_t source = -1;
+    if (found) {
+        context->measureWordCacheStats.hitCount++;
+        dimensions = cacheItem->dimensions;
+        source = cacheItem->batchIndex;
+    } else {
+        context->measureWordCacheStats.missCount++;
+        source = (int32_t)context->measureTextBatchWords.length;
+        Clay__StringArray_Add(&context->measureTextBatchWords, word);
+        Clay__TextElementConfigPointerArray_Add(&context->measureTextBatchConfigs, config);
+        Clay__int32_tArray_Add(&context->measureTextBatchWordCacheIndexes, cacheItem ? itemIndex : -1);
+        if (cacheItem) {
+            cacheItem->batchIndex = source;
+        }
+    }
+    context->measureTextBatchResults.internalArray[context->measureTextBatchResults.length++] = dimensions;
+    Clay__int32_tArray_Add(&context->measureTextBatchResultSources, source);
+}
+
+// Queues all of the words in text to be measured in one call to the batch measurement function.
+// Returns false if the text has too many words to fit in the batch.
+bool Clay__AddMeasureTextBatchItem(Clay__MeasureTextCacheItem *measured, Clay_String *text, Clay_TextElementConfig *config) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    uint32_t wordCount = 1; // Space width
+    for (int i = 0; i < text->length; ++i) {
+        if (text->chars[i] == ' ' || text->chars[i] == '\n') {
+            wordCount++;
+        }
+    }
+    if (text->length > 0 && text->chars[text->length - 1] != ' ' && text->chars[text->length - 1] != '\n') {
+        wordCount++;
+    }
+    if (wordCount > context->measureTextBatchResults.capacity) {
+        return false;
+    }
+    if (context->measureTextBatchResults.length + wordCount > context->measureTextBatchResults.capacity || context->measureTextBatchItems.length == context->measureTextBatchItems.capacity) {
+        Clay__ResolveMeasureTextBatch();
+    }
+    Clay__MeasureTextBatchItemArray_Add(&context->measureTextBatchItems, CLAY__INIT(Clay__MeasureTextBatchItem) { .measured = measured, .text = *text, .config = config, .firstWordIndex = context->measureTextBatchResults.length });
+    Clay__AddMeasureTextBatchWord(CLAY__SPACECHAR, config);
+    uint32_t start = 0;
+    for (int end = 0; end < text->length; ++end) {
+        if (text->chars[end] == ' ' || text->chars[end] == '\n') {
+            Clay__AddMeasureTextBatchWord(CLAY__INIT(Clay_String) { .length = (int)(end - start), .chars = &text->chars[start] }, config);
+            start = end + 1;
+        }
+    }
+    if (text->length - start > 0) {
+        Clay__AddMeasureTextBatchWord(CLAY__INIT(Clay_String) { .length = (int)(text->length - start), .chars = &text->chars[start] }, config);
+    }
+    return true;
+}
+
+void Clay__FreeCachedWrappedLines(Clay__MeasureTextCacheItem *measured) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    int32_t lineIndex = measured->wrappedLinesStartIndex;
+    while (lineIndex != -1) {
+        Clay__int32_tArray_Add(&context->wrappedLineCacheFreeList, lineIndex);
+        lineIndex = Clay__MeasuredWordArray_Get(&context->wrappedLineCache, lineIndex)->next;
+    }
+    measured->wrappedLinesStartIndex = -1;
+}
+
+// Stores the lines that a text element was just wrapped into, so that they can be reused while the text and its container's width stay the same
+void Clay__CacheWrappedLines(Clay__MeasureTextCacheItem *measured, Clay_String *text, Clay__WrappedTextLineArraySlice wrappedLines, float wrappedWidth) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__FreeCachedWrappedLines(measured);
+    int32_t freeLineCount = (int32_t)context->wrappedLineCacheFreeList.length + (int32_t)(context->wrappedLineCache.capacity - context->wrappedLineCache.length);
+    if ((int32_t)wrappedLines.length > freeLineCount) {
+        return;
+    }
+    Clay__MeasuredWord tempLine = { .next = -1 };
+    Clay__MeasuredWord *previousLine = &tempLine;
+    for (int32_t i = 0; i < (int32_t)wrappedLines.length; ++i) {
+        Clay__WrappedTextLine *wrappedLine = &wrappedLines.internalArray[i];
+        Clay__MeasuredWord line = { .startOffset = (uint32_t)(wrappedLine->line.chars - text->chars), .length = (uint32_t)wrappedLine->line.length, .width = wrappedLine->dimensions.width, .next = -1 };
+        if (context->wrappedLineCacheFreeList.length > 0) {
+            int32_t lineIndex = Clay__int32_tArray_Get(&context->wrappedLineCacheFreeList, (int)context->wrappedLineCacheFreeList.length - 1);
+            context->wrappedLineCacheFreeList.length--;
+            Clay__MeasuredWordArray_Set(&context->wrappedLineCache, lineIndex, line);
+            previousLine->next = lineIndex;
+        } else {
+            Clay__MeasuredWordArray_Add(&context->wrappedLineCache, line);
+            previousLine->next = (int32_t)context->wrappedLineCache.length - 1;
+        }
+        previousLine = Clay__MeasuredWordArray_Get(&context->wrappedLineCache, previousLine->next);
+    }
+    measured->wrappedLinesStartIndex = tempLine.next;
+    measured->wrappedWidth = wrappedWidth;
+}
+
+Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_TextElementConfig *config) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    #ifndef CLAY_WASM
+    if (!context->measureTextFunction && !context->measureTextBatchFunction && !Clay__GetFontMetrics(config->fontId)) {
+        context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+            .errorType = CLAY_ERROR_TYPE_TEXT_MEASUREMENT_FUNCTION_NOT_PROVIDED,
+            .errorText = CLAY_STRING("Clay's internal MeasureText function is null. You may have forgotten to call Clay_SetMeasureTextFunction(), Clay_SetMeasureTextBatchFunction() or Clay_RegisterFontMetrics(), or passed a NULL function pointer by mistake."),
+            .userData = context->errorHandler.userData });
+        return NULL;
+    }
+    #endif
+    uint32_t id = Clay__HashTextWithConfig(text, config);
+    uint32_t hashBucket = id % context->measureTextHashMap.capacity;
+    int32_t elementIndexPrevious = 0;
+    int32_t elementIndex = context->measureTextHashMap.internalArray[hashBucket];
+    while (elementIndex != 0) {
+        Clay__MeasureTextCacheItem *hashEntry = Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, elementIndex);
+        if (hashEntry->id == id) {
+            hashEntry->generation = context->generation;
+            context->memoryStats.measureTextCache.hitCount++;
+            return hashEntry;
+        }
+        // This element hasn't been seen in a few frames, delete the hash map item
+        if (context->generation - hashEntry->generation > 2) {
+            context->memoryStats.measureTextCache.evictionCount++;
+            // Add all the measured words that were included in this measurement to the freelist
+            int32_t nextWordIndex = hashEntry->measuredWordsStartIndex;
+            while (nextWordIndex != -1) {
+                Clay__MeasuredWord *measuredWord = Clay__MeasuredWordArray_Get(&context->measuredWords, nextWordIndex);
+                Clay__int32_tArray_Add(&context->measuredWordsFreeList, nextWordIndex);
+                nextWordIndex = measuredWord->next;
+            }
+            Clay__FreeCachedWrappedLines(hashEntry);
+
+            uint32_t nextIndex = hashEntry->nextIndex;
+            Clay__MeasureTextCacheItemArray_Set(&context->measureTextHashMapInternal, elementIndex, CLAY__INIT(Clay__MeasureTextCacheItem) { .measuredWordsStartIndex = -1, .wrappedLinesStartIndex = -1 });
+            Clay__int32_tArray_Add(&context->measureTextHashMapInternalFreeList, elementIndex);
+            if (elementIndexPrevious == 0) {
+                context->measureTextHashMap.internalArray[hashBucket] = nextIndex;
+            } else {
+                Clay__MeasureTextCacheItem *previousHashEntry = Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, elementIndexPrevious);
+                previousHashEntry->nextIndex = nextIndex;
+            }
+            elementIndex = nextIndex;
+        } else {
+            elementIndexPrevious = elementIndex;
+            elementIndex = hashEntry->nextIndex;
+        }
+    }
+
+    context->memoryStats.measureTextCache.missCount++;
+    uint32_t newItemIndex = 0;
+    Clay__MeasureTextCacheItem newCacheItem = CLAY__INIT(Clay__MeasureTextCacheItem) { .measuredWordsStartIndex = -1, .wrappedLinesStartIndex = -1, .id = id, .generation = context->generation };
+    Clay__MeasureTextCacheItem *measured = NULL;
+    if (context->measureTextHashMapInternalFreeList.length > 0) {
+        newItemIndex = Clay__int32_tArray_Get(&context->measureTextHashMapInternalFreeList, context->measureTextHashMapInternalFreeList.length - 1);
+        context->measureTextHashMapInternalFreeList.length--;
+        Clay__MeasureTextCacheItemArray_Set(&context->measureTextHashMapInternal, newItemIndex, newCacheItem);
+        measured = Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, newItemIndex);
+    } else {
+        if (context->measureTextHashMapInternal.length == context->measureTextHashMapInternal.capacity - 1) {
+            if (context->booleanWarnings.maxTextMeasureCacheExceeded) {
+                context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+                        .errorType = CLAY_ERROR_TYPE_ELEMENTS_CAPACITY_EXCEEDED,
+                        .errorText = CLAY_STRING("Clay ran out of capacity while attempting to measure text elements. Try using Clay_SetMaxElementCount() with a higher value."),
+                        .userData = context->errorHandler.userData });
+                context->booleanWarnings.maxTextMeasureCacheExceeded = true;
+            }
+            return &CLAY__MEASURE_TEXT_CACHE_ITEM_DEFAULT;
+        }
+        measured = Clay__MeasureTextCacheItemArray_Add(&context->measureTextHashMapInternal, newCacheItem);
+        newItemIndex = context->measureTextHashMapInternal.length - 1;
+    }
+
+    // Fonts with registered metrics are cheap to measure, so there's no reason to defer them
+    if (Clay__MeasureTextIsBatched() && !Clay__GetFontMetrics(config->fontId) && Clay__AddMeasureTextBatchItem(measured, text, config)) {
+        // The words will be measured along with the rest of the frame's text by Clay__ResolveMeasureTextBatch
+        context->textMeasurementDeferred = true;
+    } else if (!Clay__MeasureTextWords(measured, text, config, CLAY__NULL)) {
+        return &CLAY__MEASURE_TEXT_CACHE_ITEM_DEFAULT;
+    }
 
     if (elementIndexPrevious != 0) {
-        Clay__MeasureTextCacheItemArray_Get(&Clay__measureTextHashMapInternal, elementIndexPrevious)->nextIndex = newItemIndex;
+        Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, elementIndexPrevious)->nextIndex = newItemIndex;
     } else {
-        Clay__measureTextHashMap.internalArray[hashBucket] = newItemIndex;
+        context->measureTextHashMap.internalArray[hashBucket] = newItemIndex;
     }
     return measured;
 }
 
+// Empties the text, word and wrapped line caches, so that every string is measured again
+void Clay__ResetMeasureTextCaches(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    for (int32_t i = 0; i < (int32_t)context->measureTextHashMap.capacity; ++i) {
+        context->measureTextHashMap.internalArray[i] = 0;
+    }
+    context->measureTextHashMapInternal.length = 1; // Reserve the 0 value to mean "no next element"
+    context->measureTextHashMapInternalFreeList.length = 0;
+    for (int32_t i = 0; i < (int32_t)context->measureWordHashMap.capacity; ++i) {
+        context->measureWordHashMap.internalArray[i] = 0;
+    }
+    context->measureWordHashMapInternal.length = 1; // Reserve the 0 value to mean "no next element"
+    context->measureWordHashMapInternalFreeList.length = 0;
+    context->measuredWords.length = 0;
+    context->measuredWordsFreeList.length = 0;
+    context->wrappedLineCache.length = 0;
+    context->wrappedLineCacheFreeList.length = 0;
+    context->measureTextCachesStale = false;
+}
+
 bool Clay__PointIsInsideRect(Clay_Vector2 point, Clay_BoundingBox rect) {
     return point.x >= rect.x && point.x <= rect.x + rect.width && point.y >= rect.y && point.y <= rect.y + rect.height;
 }
 
-Clay_LayoutElementHashMapItem* Clay__AddHashMapItem(Clay_ElementId elementId, Clay_LayoutElement* layoutElement) {
-    if (Clay__layoutElementsHashMapInternal.length == Clay__layoutElementsHashMapInternal.capacity - 1) {
-        return NULL;
+// Elements that haven't been declared for a few frames are removed from the hash map, so that their space can be reused
+bool Clay__HashMapItemIsStale(Clay_LayoutElementHashMapItem *hashItem) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    return hashItem->generation + 2 < context->generation;
+}
+
+// The slot table is a power of two at least twice the size of maxElementCount, so probes stay short and always reach an empty slot
+uint32_t Clay__LayoutElementHashMapSlotCount(int32_t maxElementCount) {
+    uint32_t slotCount = 1;
+    while (slotCount < (uint32_t)maxElementCount * 2) {
+        slotCount *= 2;
     }
-    Clay_LayoutElementHashMapItem item = CLAY__INIT(Clay_LayoutElementHashMapItem) { .elementId = elementId, .layoutElement = layoutElement, .nextIndex = -1, .generation = Clay__generation + 1 };
-    uint32_t hashBucket = elementId.id % Clay__layoutElementsHashMap.capacity;
-    int32_t hashItemPrevious = -1;
-    int32_t hashItemIndex = Clay__layoutElementsHashMap.internalArray[hashBucket];
-    while (hashItemIndex != -1) { // Just replace collision, not a big deal - leave it up to the end user
-        Clay_LayoutElementHashMapItem *hashItem = Clay__LayoutElementHashMapItemArray_Get(&Clay__layoutElementsHashMapInternal, hashItemIndex);
-        if (hashItem->elementId.id == elementId.id) { // Collision - resolve based on generation
-            item.nextIndex = hashItem->nextIndex;
-            if (hashItem->generation <= Clay__generation) { // First collision - assume this is the "same" element
-                hashItem->generation = Clay__generation + 1;
+    return slotCount;
+}
+
+void Clay__InsertHashMapSlot(uint32_t id, int32_t itemIndex) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    uint32_t slotMask = context->layoutElementsHashMap.capacity - 1;
+    uint32_t slotIndex = id & slotMask;
+    while (context->layoutElementsHashMap.internalArray[slotIndex].itemIndex != -1) {
+        slotIndex = (slotIndex + 1) & slotMask;
+    }
+    context->layoutElementsHashMap.internalArray[slotIndex] = CLAY__INIT(Clay__LayoutElementHashMapSlot) { .id = id, .itemIndex = itemIndex };
+}
+
+// Empties a slot, shifting later entries in the probe sequence back so that none of them become unreachable
+void Clay__RemoveHashMapSlot(uint32_t slotIndex) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__LayoutElementHashMapSlot *slots = context->layoutElementsHashMap.internalArray;
+    uint32_t slotMask = context->layoutElementsHashMap.capacity - 1;
+    for (uint32_t nextSlotIndex = (slotIndex + 1) & slotMask; slots[nextSlotIndex].itemIndex != -1; nextSlotIndex = (nextSlotIndex + 1) & slotMask) {
+        uint32_t homeSlotIndex = slots[nextSlotIndex].id & slotMask;
+        // The entry can only move back if the hole is still on its probe sequence
+        if (((nextSlotIndex - homeSlotIndex) & slotMask) >= ((nextSlotIndex - slotIndex) & slotMask)) {
+            slots[slotIndex] = slots[nextSlotIndex];
+            slotIndex = nextSlotIndex;
+        }
+    }
+    slots[slotIndex] = CLAY__INIT(Clay__LayoutElementHashMapSlot) { .itemIndex = -1 };
+}
+
+// Only called when the hash map is full, so that lookups never have to read the items to check their generation
+void Clay__EvictStaleHashMapItems(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    uint32_t slotMask = context->layoutElementsHashMap.capacity - 1;
+    for (int32_t hashItemIndex = 0; hashItemIndex < (int32_t)context->layoutElementsHashMapInternal.length; ++hashItemIndex) {
+        Clay_LayoutElementHashMapItem *hashItem = Clay__LayoutElementHashMapItemArray_Get(&context->layoutElementsHashMapInternal, hashItemIndex);
+        if (hashItem->generation == 0 || !Clay__HashMapItemIsStale(hashItem)) {
+            continue;
+        }
+        uint32_t slotIndex = hashItem->elementId.id & slotMask;
+        while (context->layoutElementsHashMap.internalArray[slotIndex].itemIndex != hashItemIndex) {
+            slotIndex = (slotIndex + 1) & slotMask;
+        }
+        Clay__RemoveHashMapSlot(slotIndex);
+        // Each item owns the debug data at the same index, which is kept for whichever element reuses the item. A generation of 0 marks the item as free.
+        *hashItem = CLAY__INIT(Clay_LayoutElementHashMapItem) { .debugData = hashItem->debugData };
+        Clay__int32_tArray_Add(&context->layoutElementsHashMapInternalFreeList, hashItemIndex);
+        context->memoryStats.layoutElementsHashMapEvictionCount++;
+    }
+}
+
+Clay_LayoutElementHashMapItem* Clay__AddHashMapItem(Clay_ElementId elementId, Clay_LayoutElement* layoutElement) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_LayoutElementHashMapItem item = CLAY__INIT(Clay_LayoutElementHashMapItem) { .elementId = elementId, .layoutElement = layoutElement, .generation = context->generation + 1 };
+    uint32_t slotMask = context->layoutElementsHashMap.capacity - 1;
+    for (uint32_t slotIndex = elementId.id & slotMask; context->layoutElementsHashMap.internalArray[slotIndex].itemIndex != -1; slotIndex = (slotIndex + 1) & slotMask) {
+        Clay__LayoutElementHashMapSlot *slot = &context->layoutElementsHashMap.internalArray[slotIndex];
+        if (slot->id == elementId.id) { // Collision - resolve based on generation
+            Clay_LayoutElementHashMapItem *hashItem = Clay__LayoutElementHashMapItemArray_Get(&context->layoutElementsHashMapInternal, slot->itemIndex);
+            if (hashItem->generation <= context->generation) { // First collision - assume this is the "same" element
+                hashItem->generation = context->generation + 1;
                 hashItem->layoutElement = layoutElement;
                 hashItem->debugData->collision = false;
             } else { // Multiple collisions this frame - two elements have the same ID
-                Clay__errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+                context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
                     .errorType = CLAY_ERROR_TYPE_DUPLICATE_ID,
                     .errorText = CLAY_STRING("An element with this ID was already previously declared during this layout."),
-                    .userData = Clay__errorHandler.userData });
-                if (Clay__debugModeEnabled) {
+                    .userData = context->errorHandler.userData });
+                if (context->debugModeEnabled) {
                     hashItem->debugData->collision = true;
                 }
             }
             return hashItem;
         }
-        hashItemPrevious = hashItemIndex;
-        hashItemIndex = hashItem->nextIndex;
     }
-    Clay_LayoutElementHashMapItem *hashItem = Clay__LayoutElementHashMapItemArray_Add(&Clay__layoutElementsHashMapInternal, item);
-    hashItem->debugData = Clay__DebugElementDataArray_Add(&Clay__debugElementData, CLAY__INIT(Clay__DebugElementData) {});
-    if (hashItemPrevious != -1) {
-        Clay__LayoutElementHashMapItemArray_Get(&Clay__layoutElementsHashMapInternal, hashItemPrevious)->nextIndex = (int32_t)Clay__layoutElementsHashMapInternal.length - 1;
+    if (context->layoutElementsHashMapInternalFreeList.length == 0 && context->layoutElementsHashMapInternal.length == context->layoutElementsHashMapInternal.capacity - 1) {
+        Clay__EvictStaleHashMapItems();
+    }
+    int32_t newItemIndex = 0;
+    Clay_LayoutElementHashMapItem *hashItem = NULL;
+    if (context->layoutElementsHashMapInternalFreeList.length > 0) {
+        newItemIndex = Clay__int32_tArray_Get(&context->layoutElementsHashMapInternalFreeList, (int)context->layoutElementsHashMapInternalFreeList.length - 1);
+        context->layoutElementsHashMapInternalFreeList.length--;
+        hashItem = Clay__LayoutElementHashMapItemArray_Get(&context->layoutElementsHashMapInternal, newItemIndex);
+        item.debugData = hashItem->debugData;
+        *hashItem = item;
+        *hashItem->debugData = CLAY__INIT(Clay__DebugElementData) {};
+    } else if (context->layoutElementsHashMapInternal.length < context->layoutElementsHashMapInternal.capacity - 1) {
+        newItemIndex = (int32_t)context->layoutElementsHashMapInternal.length;
+        hashItem = Clay__LayoutElementHashMapItemArray_Add(&context->layoutElementsHashMapInternal, item);
+        hashItem->debugData = Clay__DebugElementDataArray_Add(&context->debugElementData, CLAY__INIT(Clay__DebugElementData) {});
     } else {
-        Clay__layoutElementsHashMap.internalArray[hashBucket] = (int32_t)Clay__layoutElementsHashMapInternal.length - 1;
+        return NULL;
     }
+    // The sweep above may have shifted entries around, so the empty slot is found again rather than reused from the search
+    Clay__InsertHashMapSlot(elementId.id, newItemIndex);
     return hashItem;
 }
 
 Clay_LayoutElementHashMapItem *Clay__GetHashMapItem(uint32_t id) {
-    uint32_t hashBucket = id % Clay__layoutElementsHashMap.capacity;
-    int32_t elementIndex = Clay__layoutElementsHashMap.internalArray[hashBucket];
-    while (elementIndex != -1) {
-        Clay_LayoutElementHashMapItem *hashEntry = Clay__LayoutElementHashMapItemArray_Get(&Clay__layoutElementsHashMapInternal, elementIndex);
-        if (hashEntry->elementId.id == id) {
-            return hashEntry;
+    Clay_Context* context = Clay_GetCurrentContext();
+    uint32_t slotMask = context->layoutElementsHashMap.capacity - 1;
+    for (uint32_t slotIndex = id & slotMask; context->layoutElementsHashMap.internalArray[slotIndex].itemIndex != -1; slotIndex = (slotIndex + 1) & slotMask) {
+        Clay__LayoutElementHashMapSlot *slot = &context->layoutElementsHashMap.internalArray[slotIndex];
+        if (slot->id == id) {
+            return Clay__LayoutElementHashMapItemArray_Get(&context->layoutElementsHashMapInternal, slot->itemIndex);
         }
-        elementIndex = hashEntry->nextIndex;
     }
     return &CLAY__LAYOUT_ELEMENT_HASH_MAP_ITEM_DEFAULT;
 }
 
+// Scroll containers are found through the hash map item for their element id, rather than by searching every container
+Clay__ScrollContainerDataInternal *Clay__GetScrollContainerDataInternal(uint32_t id) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    int32_t scrollContainerDataIndex = Clay__GetHashMapItem(id)->scrollContainerDataIndex;
+    if (scrollContainerDataIndex >= 0 && scrollContainerDataIndex < (int32_t)context->scrollContainerDatas.length) {
+        Clay__ScrollContainerDataInternal *scrollContainerData = &context->scrollContainerDatas.internalArray[scrollContainerDataIndex];
+        if (scrollContainerData->elementId == id) {
+            return scrollContainerData;
+        }
+    }
+    return CLAY__NULL;
+}
+
+void Clay__RemoveScrollContainerData(int32_t index) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__ScrollContainerDataInternalArray_RemoveSwapback(&context->scrollContainerDatas, index);
+    if (index < (int32_t)context->scrollContainerDatas.length) {
+        // The swapped in container's element may have been evicted from the hash map, in which case there's no index to update
+        Clay_LayoutElementHashMapItem *hashMapItem = Clay__GetHashMapItem(context->scrollContainerDatas.internalArray[index].elementId);
+        if (hashMapItem != &CLAY__LAYOUT_ELEMENT_HASH_MAP_ITEM_DEFAULT) {
+            hashMapItem->scrollContainerDataIndex = index;
+        }
+    }
+}
+
 void Clay__GenerateIdForAnonymousElement(Clay_LayoutElement *openLayoutElement) {
-    Clay_LayoutElement *parentElement = Clay_LayoutElementArray_Get(&Clay__layoutElements, Clay__int32_tArray_Get(&Clay__openLayoutElementStack, Clay__openLayoutElementStack.length - 2));
-    Clay_ElementId elementId = Clay__HashNumber(parentElement->children.length, parentElement->id);
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_LayoutElement *parentElement = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_Get(&context->openLayoutElementStack, context->openLayoutElementStack.length - 2));
+    uint32_t childIndex = parentElement->children.length;
+    if (Clay__ElementHasConfig(parentElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER)) {
+        // Items in a virtual list get the same ids as they would if every item was declared
+        Clay__ScrollContainerDataInternal *scrollData = Clay__GetScrollContainerDataInternal(parentElement->id);
+        if (scrollData && scrollData->virtualListOpen) {
+            childIndex += scrollData->virtualListFirstChildIndex;
+        }
+    }
+    Clay_ElementId elementId = Clay__HashNumber(childIndex, parentElement->id);
     openLayoutElement->id = elementId.id;
     Clay__AddHashMapItem(elementId, openLayoutElement);
-    Clay__StringArray_Add(&Clay__layoutElementIdStrings, elementId.stringId);
+    Clay__StringArray_Add(&context->layoutElementIdStrings, elementId.stringId);
+}
+
+// Puts an element's configs into the order their render commands are emitted in, keeping declaration order otherwise.
+// Scroll containers come first so that their scissor also clips the element's own content, and borders come last so they're drawn on top of it.
+void Clay__SortElementConfigsForRendering(Clay_LayoutElement *layoutElement) {
+    Clay_ElementConfig *configs = layoutElement->elementConfigs.internalArray;
+    int32_t scrollEnd = 0, borderStart = (int32_t)layoutElement->elementConfigs.length;
+    for (int32_t i = 0; i < (int32_t)layoutElement->elementConfigs.length; ++i) {
+        if (configs[i].type == CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER) {
+            Clay_ElementConfig scrollConfig = configs[i];
+            for (int32_t j = i; j > scrollEnd; --j) {
+                configs[j] = configs[j - 1];
+            }
+            configs[scrollEnd++] = scrollConfig;
+        }
+    }
+    for (int32_t i = borderStart - 1; i >= scrollEnd; --i) {
+        if (configs[i].type == CLAY__ELEMENT_CONFIG_TYPE_BORDER_CONTAINER) {
+            Clay_ElementConfig borderConfig = configs[i];
+            for (int32_t j = i; j < borderStart - 1; ++j) {
+                configs[j] = configs[j + 1];
+            }
+            configs[--borderStart] = borderConfig;
+        }
+    }
+    for (int32_t i = 0; i < (int32_t)layoutElement->elementConfigs.length; ++i) {
+        Clay__AddElementConfigSlot(layoutElement, configs[i].type, i);
+    }
 }
 
 void Clay__ElementPostConfiguration(void) {
-    if (Clay__booleanWarnings.maxElementsExceeded) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->booleanWarnings.maxElementsExceeded) {
         return;
     }
     Clay_LayoutElement *openLayoutElement = Clay__GetOpenLayoutElement();
@@ -1812,17 +3426,16 @@ void Clay__ElementPostConfiguration(void) {
     }
 
     // Loop through element configs and handle special cases
-    openLayoutElement->elementConfigs.internalArray = &Clay__elementConfigs.internalArray[Clay__elementConfigs.length];
+    openLayoutElement->elementConfigs.internalArray = &context->elementConfigs.internalArray[context->elementConfigs.length];
     for (int elementConfigIndex = 0; elementConfigIndex < openLayoutElement->elementConfigs.length; elementConfigIndex++) {
-        Clay_ElementConfig *config = Clay__ElementConfigArray_Add(&Clay__elementConfigs, *Clay__ElementConfigArray_Get(&Clay__elementConfigBuffer, Clay__elementConfigBuffer.length - openLayoutElement->elementConfigs.length + elementConfigIndex));
-        openLayoutElement->configsEnabled |= config->type;
+        Clay_ElementConfig *config = Clay__ElementConfigArray_Add(&context->elementConfigs, *Clay__ElementConfigArray_Get(&context->elementConfigBuffer, context->elementConfigBuffer.length - openLayoutElement->elementConfigs.length + elementConfigIndex));
         switch (config->type) {
             case CLAY__ELEMENT_CONFIG_TYPE_RECTANGLE:
             case CLAY__ELEMENT_CONFIG_TYPE_BORDER_CONTAINER: break;
             case CLAY__ELEMENT_CONFIG_TYPE_FLOATING_CONTAINER: {
                 Clay_FloatingElementConfig *floatingConfig = config->config.floatingElementConfig;
                 // This looks dodgy but because of the auto generated root element the depth of the tree will always be at least 2 here
-                Clay_LayoutElement *hierarchicalParent = Clay_LayoutElementArray_Get(&Clay__layoutElements, Clay__int32_tArray_Get(&Clay__openLayoutElementStack, Clay__openLayoutElementStack.length - 2));
+                Clay_LayoutElement *hierarchicalParent = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_Get(&context->openLayoutElementStack, context->openLayoutElementStack.length - 2));
                 if (!hierarchicalParent) {
                     break;
                 }
@@ -1831,23 +3444,23 @@ void Clay__ElementPostConfiguration(void) {
                     // If no parent id was specified, attach to the elements direct hierarchical parent
                     Clay_FloatingElementConfig newConfig = *floatingConfig;
                     newConfig.parentId = hierarchicalParent->id;
-                    floatingConfig = Clay__FloatingElementConfigArray_Add(&Clay__floatingElementConfigs, newConfig);
+                    floatingConfig = Clay__FloatingElementConfigArray_Add(&context->floatingElementConfigs, newConfig);
                     config->config.floatingElementConfig = floatingConfig;
-                    if (Clay__openClipElementStack.length > 0) {
-                        clipElementId = Clay__int32_tArray_Get(&Clay__openClipElementStack, (int)Clay__openClipElementStack.length - 1);
+                    if (context->openClipElementStack.length > 0) {
+                        clipElementId = Clay__int32_tArray_Get(&context->openClipElementStack, (int)context->openClipElementStack.length - 1);
                     }
                 } else {
                     Clay_LayoutElementHashMapItem *parentItem = Clay__GetHashMapItem(floatingConfig->parentId);
-                    clipElementId = Clay__int32_tArray_Get(&Clay__layoutElementClipElementIds, parentItem->layoutElement - Clay__layoutElements.internalArray);
+                    clipElementId = Clay__int32_tArray_Get(&context->layoutElementClipElementIds, parentItem->layoutElement - context->layoutElements.internalArray);
                     if (!parentItem) {
-                        Clay__errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+                        context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
                             .errorType = CLAY_ERROR_TYPE_FLOATING_CONTAINER_PARENT_NOT_FOUND,
                             .errorText = CLAY_STRING("A floating element was declared with a parentId, but no element with that ID was found."),
-                            .userData = Clay__errorHandler.userData });
+                            .userData = context->errorHandler.userData });
                     }
                 }
-                Clay__LayoutElementTreeRootArray_Add(&Clay__layoutElementTreeRoots, CLAY__INIT(Clay__LayoutElementTreeRoot) {
-                    .layoutElementIndex = (uint32_t)Clay__int32_tArray_Get(&Clay__openLayoutElementStack, Clay__openLayoutElementStack.length - 1),
+                Clay__LayoutElementTreeRootArray_Add(&context->layoutElementTreeRoots, CLAY__INIT(Clay__LayoutElementTreeRoot) {
+                    .layoutElementIndex = (uint32_t)Clay__int32_tArray_Get(&context->openLayoutElementStack, context->openLayoutElementStack.length - 1),
                     .parentId = floatingConfig->parentId,
                     .clipElementId = (uint32_t)clipElementId,
                     .zIndex = floatingConfig->zIndex,
@@ -1855,105 +3468,98 @@ void Clay__ElementPostConfiguration(void) {
                 break;
             }
             case CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER: {
-                Clay__int32_tArray_Add(&Clay__openClipElementStack, (int)openLayoutElement->id);
+                Clay__int32_tArray_Add(&context->openClipElementStack, (int)openLayoutElement->id);
                 // Retrieve or create cached data to track scroll position across frames
-                Clay__ScrollContainerDataInternal *scrollOffset = CLAY__NULL;
-                for (int i = 0; i < Clay__scrollContainerDatas.length; i++) {
-                    Clay__ScrollContainerDataInternal *mapping = Clay__ScrollContainerDataInternalArray_Get(&Clay__scrollContainerDatas, i);
-                    if (openLayoutElement->id == mapping->elementId) {
-                        scrollOffset = mapping;
-                        scrollOffset->layoutElement = openLayoutElement;
-                        scrollOffset->openThisFrame = true;
+                Clay__ScrollContainerDataInternal *scrollOffset = Clay__GetScrollContainerDataInternal(openLayoutElement->id);
+                if (scrollOffset) {
+                    scrollOffset->layoutElement = openLayoutElement;
+                    scrollOffset->openThisFrame = true;
+                } else if (context->scrollContainerDatas.length == context->scrollContainerDatas.capacity) {
+                    // Count how many scroll containers there are, so that there's room for all of them from the next frame
+                    context->pendingMaxScrollContainerCount = CLAY__MAX(context->pendingMaxScrollContainerCount, context->scrollContainerDatas.capacity) + 1;
+                    scrollOffset = &CLAY__SCROLL_CONTAINER_DEFAULT;
+                } else {
+                    scrollOffset = Clay__ScrollContainerDataInternalArray_Add(&context->scrollContainerDatas, CLAY__INIT(Clay__ScrollContainerDataInternal){.layoutElement = openLayoutElement, .scrollOrigin = {-1,-1}, .elementId = openLayoutElement->id, .openThisFrame = true});
+                    Clay_LayoutElementHashMapItem *hashMapItem = Clay__GetHashMapItem(openLayoutElement->id);
+                    if (scrollOffset != &CLAY__SCROLL_CONTAINER_DEFAULT && hashMapItem != &CLAY__LAYOUT_ELEMENT_HASH_MAP_ITEM_DEFAULT) {
+                        hashMapItem->scrollContainerDataIndex = (int32_t)context->scrollContainerDatas.length - 1;
                     }
                 }
-                if (!scrollOffset) {
-                    scrollOffset = Clay__ScrollContainerDataInternalArray_Add(&Clay__scrollContainerDatas, CLAY__INIT(Clay__ScrollContainerDataInternal){.layoutElement = openLayoutElement, .scrollOrigin = {-1,-1}, .elementId = openLayoutElement->id, .openThisFrame = true});
-                }
-                if (Clay__externalScrollHandlingEnabled) {
-                    scrollOffset->scrollPosition = Clay__QueryScrollOffset(scrollOffset->elementId);
+                if (context->externalScrollHandlingEnabled) {
+                    scrollOffset->scrollPosition = context->queryScrollOffsetFunction(scrollOffset->elementId);
                 }
                 break;
             }
             case CLAY__ELEMENT_CONFIG_TYPE_CUSTOM: break;
             case CLAY__ELEMENT_CONFIG_TYPE_IMAGE: {
-                Clay__LayoutElementPointerArray_Add(&Clay__imageElementPointers, openLayoutElement);
+                Clay__LayoutElementPointerArray_Add(&context->imageElementPointers, openLayoutElement);
                 break;
             }
             case CLAY__ELEMENT_CONFIG_TYPE_TEXT: break;
         }
     }
-    Clay__elementConfigBuffer.length -= openLayoutElement->elementConfigs.length;
+    context->elementConfigBuffer.length -= openLayoutElement->elementConfigs.length;
+    Clay__SortElementConfigsForRendering(openLayoutElement);
 }
 
-void Clay__CloseElement(void) {
-    if (Clay__booleanWarnings.maxElementsExceeded) {
-        return;
-    }
-    Clay_LayoutElement *openLayoutElement = Clay__GetOpenLayoutElement();
-    Clay_LayoutConfig *layoutConfig = openLayoutElement->layoutConfig;
+// Sizes an element to fit its children, then clamps it to the min and max from its layout config
+void Clay__CalculateElementFitDimensions(Clay_LayoutElement *layoutElement) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_LayoutConfig *layoutConfig = layoutElement->layoutConfig;
     bool elementHasScrollHorizontal = false;
     bool elementHasScrollVertical = false;
-    if (Clay__ElementHasConfig(openLayoutElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER)) {
-        Clay_ScrollElementConfig *scrollConfig = Clay__FindElementConfigWithType(openLayoutElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER).scrollElementConfig;
+    if (Clay__ElementHasConfig(layoutElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER)) {
+        Clay_ScrollElementConfig *scrollConfig = Clay__FindElementConfigWithType(layoutElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER).scrollElementConfig;
         elementHasScrollHorizontal = scrollConfig->horizontal;
         elementHasScrollVertical = scrollConfig->vertical;
-        Clay__openClipElementStack.length--;
     }
 
-    // Attach children to the current open element
-    openLayoutElement->children.elements = &Clay__layoutElementChildren.internalArray[Clay__layoutElementChildren.length];
     if (layoutConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) {
-        openLayoutElement->dimensions.width = layoutConfig->padding.x * 2;
-        for (int i = 0; i < openLayoutElement->children.length; i++) {
-            int32_t childIndex = Clay__int32_tArray_Get(&Clay__layoutElementChildrenBuffer, (int)Clay__layoutElementChildrenBuffer.length - openLayoutElement->children.length + i);
-            Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&Clay__layoutElements, childIndex);
-            openLayoutElement->dimensions.width += child->dimensions.width;
-            openLayoutElement->dimensions.height = CLAY__MAX(openLayoutElement->dimensions.height, child->dimensions.height + layoutConfig->padding.y * 2);
+        layoutElement->dimensions.width = layoutConfig->padding.x * 2;
+        for (int i = 0; i < layoutElement->children.length; i++) {
+            Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, layoutElement->children.elements[i]);
+            layoutElement->dimensions.width += child->dimensions.width;
+            layoutElement->dimensions.height = CLAY__MAX(layoutElement->dimensions.height, child->dimensions.height + layoutConfig->padding.y * 2);
             // Minimum size of child elements doesn't matter to scroll containers as they can shrink and hide their contents
             if (!elementHasScrollHorizontal) {
-                openLayoutElement->minDimensions.width += child->minDimensions.width;
+                layoutElement->minDimensions.width += child->minDimensions.width;
             }
             if (!elementHasScrollVertical) {
-                openLayoutElement->minDimensions.height = CLAY__MAX(openLayoutElement->minDimensions.height, child->minDimensions.height + layoutConfig->padding.y * 2);
+                layoutElement->minDimensions.height = CLAY__MAX(layoutElement->minDimensions.height, child->minDimensions.height + layoutConfig->padding.y * 2);
             }
-            Clay__int32_tArray_Add(&Clay__layoutElementChildren, childIndex);
         }
-        float childGap = (float)(CLAY__MAX(openLayoutElement->children.length - 1, 0) * layoutConfig->childGap);
-        openLayoutElement->dimensions.width += childGap; // TODO this is technically a bug with childgap and scroll containers
-        openLayoutElement->minDimensions.width += childGap;
+        float childGap = (float)(CLAY__MAX(layoutElement->children.length - 1, 0) * layoutConfig->childGap);
+        layoutElement->dimensions.width += childGap; // TODO this is technically a bug with childgap and scroll containers
+        layoutElement->minDimensions.width += childGap;
     }
     else if (layoutConfig->layoutDirection == CLAY_TOP_TO_BOTTOM) {
-        openLayoutElement->dimensions.height = layoutConfig->padding.y * 2;
-        for (int i = 0; i < openLayoutElement->children.length; i++) {
-            int32_t childIndex = Clay__int32_tArray_Get(&Clay__layoutElementChildrenBuffer, (int)Clay__layoutElementChildrenBuffer.length - openLayoutElement->children.length + i);
-            Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&Clay__layoutElements, childIndex);
-            openLayoutElement->dimensions.height += child->dimensions.height;
-            openLayoutElement->dimensions.width = CLAY__MAX(openLayoutElement->dimensions.width, child->dimensions.width + layoutConfig->padding.x * 2);
+        layoutElement->dimensions.height = layoutConfig->padding.y * 2;
+        for (int i = 0; i < layoutElement->children.length; i++) {
+            Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, layoutElement->children.elements[i]);
+            layoutElement->dimensions.height += child->dimensions.height;
+            layoutElement->dimensions.width = CLAY__MAX(layoutElement->dimensions.width, child->dimensions.width + layoutConfig->padding.x * 2);
             // Minimum size of child elements doesn't matter to scroll containers as they can shrink and hide their contents
             if (!elementHasScrollVertical) {
-                openLayoutElement->minDimensions.height += child->minDimensions.height;
+                layoutElement->minDimensions.height += child->minDimensions.height;
             }
             if (!elementHasScrollHorizontal) {
-                openLayoutElement->minDimensions.width = CLAY__MAX(openLayoutElement->minDimensions.width, child->minDimensions.width + layoutConfig->padding.x * 2);
+                layoutElement->minDimensions.width = CLAY__MAX(layoutElement->minDimensions.width, child->minDimensions.width + layoutConfig->padding.x * 2);
             }
-            Clay__int32_tArray_Add(&Clay__layoutElementChildren, childIndex);
         }
-        float childGap = (float)(CLAY__MAX(openLayoutElement->children.length - 1, 0) * layoutConfig->childGap);
-        openLayoutElement->dimensions.height += childGap; // TODO this is technically a bug with childgap and scroll containers
-        openLayoutElement->minDimensions.height += childGap;
+        float childGap = (float)(CLAY__MAX(layoutElement->children.length - 1, 0) * layoutConfig->childGap);
+        layoutElement->dimensions.height += childGap; // TODO this is technically a bug with childgap and scroll containers
+        layoutElement->minDimensions.height += childGap;
     }
 
-    Clay__layoutElementChildrenBuffer.length -= openLayoutElement->children.length;
-
     // Clamp element min and max width to the values configured in the layout
     if (layoutConfig->sizing.width.type != CLAY__SIZING_TYPE_PERCENT) {
         if (layoutConfig->sizing.width.size.minMax.max <= 0) { // Set the max size if the user didn't specify, makes calculations easier
             layoutConfig->sizing.width.size.minMax.max = CLAY__MAXFLOAT;
         }
-        openLayoutElement->dimensions.width = CLAY__MIN(CLAY__MAX(openLayoutElement->dimensions.width, layoutConfig->sizing.width.size.minMax.min), layoutConfig->sizing.width.size.minMax.max);
-        openLayoutElement->minDimensions.width = CLAY__MIN(CLAY__MAX(openLayoutElement->minDimensions.width, layoutConfig->sizing.width.size.minMax.min), layoutConfig->sizing.width.size.minMax.max);
+        layoutElement->dimensions.width = CLAY__MIN(CLAY__MAX(layoutElement->dimensions.width, layoutConfig->sizing.width.size.minMax.min), layoutConfig->sizing.width.size.minMax.max);
+        layoutElement->minDimensions.width = CLAY__MIN(CLAY__MAX(layoutElement->minDimensions.width, layoutConfig->sizing.width.size.minMax.min), layoutConfig->sizing.width.size.minMax.max);
     } else {
-        openLayoutElement->dimensions.width = 0;
+        layoutElement->dimensions.width = 0;
     }
 
     // Clamp element min and max height to the values configured in the layout
@@ -1961,42 +3567,100 @@ void Clay__CloseElement(void) {
         if (layoutConfig->sizing.height.size.minMax.max <= 0) { // Set the max size if the user didn't specify, makes calculations easier
             layoutConfig->sizing.height.size.minMax.max = CLAY__MAXFLOAT;
         }
-        openLayoutElement->dimensions.height = CLAY__MIN(CLAY__MAX(openLayoutElement->dimensions.height, layoutConfig->sizing.height.size.minMax.min), layoutConfig->sizing.height.size.minMax.max);
-        openLayoutElement->minDimensions.height = CLAY__MIN(CLAY__MAX(openLayoutElement->minDimensions.height, layoutConfig->sizing.height.size.minMax.min), layoutConfig->sizing.height.size.minMax.max);
+        layoutElement->dimensions.height = CLAY__MIN(CLAY__MAX(layoutElement->dimensions.height, layoutConfig->sizing.height.size.minMax.min), layoutConfig->sizing.height.size.minMax.max);
+        layoutElement->minDimensions.height = CLAY__MIN(CLAY__MAX(layoutElement->minDimensions.height, layoutConfig->sizing.height.size.minMax.min), layoutConfig->sizing.height.size.minMax.max);
     } else {
-        openLayoutElement->dimensions.height = 0;
+        layoutElement->dimensions.height = 0;
+    }
+}
+
+// Folds part of the declaration of the current layout into a hash, so that a layout identical to the previous frame's can be detected
+void Clay__HashDeclaration(const void *data, int32_t length) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->declarationHash = Clay__HashBytes(data, length, context->declarationHash);
+}
+
+// Declares an empty element in place of the items of a virtual list that are outside the declared range.
+// The extent is the sum of those items' strides, which includes the child gap that the layout adds after the spacer itself.
+// Spacers have their own ids, so that they aren't counted when generating ids for the items.
+void Clay__DeclareVirtualListSpacer(Clay_String idString, float extent, float childGap, bool vertical) {
+    float spacerExtent = CLAY__MAX(extent - childGap, 0);
+    Clay_LayoutElement *listElement = Clay__GetOpenLayoutElement();
+    Clay__OpenElement();
+    Clay__AttachId(Clay__HashString(idString, 0, listElement->id));
+    Clay__AttachLayoutConfig(Clay__StoreLayoutConfig(CLAY__INIT(Clay_LayoutConfig) { .sizing = { CLAY_SIZING_FIXED(vertical ? 0 : spacerExtent), CLAY_SIZING_FIXED(vertical ? spacerExtent : 0) } }));
+    Clay__ElementPostConfiguration();
+    Clay__CloseElement();
+}
+
+void Clay__CloseElement(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->booleanWarnings.maxElementsExceeded) {
+        return;
+    }
+    Clay_LayoutElement *openLayoutElement = Clay__GetOpenLayoutElement();
+    if (Clay__ElementHasConfig(openLayoutElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER)) {
+        Clay__ScrollContainerDataInternal *scrollData = Clay__GetScrollContainerDataInternal(openLayoutElement->id);
+        if (scrollData && scrollData->virtualListOpen) {
+            // The spacer for the items after a virtual list's range has to follow the items the user declared
+            scrollData->virtualListOpen = false;
+            if (scrollData->virtualListTrailingExtent > 0) {
+                Clay_LayoutConfig *layoutConfig = openLayoutElement->layoutConfig;
+                Clay__DeclareVirtualListSpacer(CLAY_STRING("Clay__VirtualListTrailingSpacer"), scrollData->virtualListTrailingExtent, layoutConfig->childGap, layoutConfig->layoutDirection == CLAY_TOP_TO_BOTTOM);
+                if (context->booleanWarnings.maxElementsExceeded) {
+                    return;
+                }
+            }
+        }
+        context->openClipElementStack.length--;
     }
 
+    // Attach children to the current open element
+    openLayoutElement->children.elements = &context->layoutElementChildren.internalArray[context->layoutElementChildren.length];
+    for (int i = 0; i < openLayoutElement->children.length; i++) {
+        Clay__int32_tArray_Add(&context->layoutElementChildren, Clay__int32_tArray_Get(&context->layoutElementChildrenBuffer, (int)context->layoutElementChildrenBuffer.length - openLayoutElement->children.length + i));
+    }
+    context->layoutElementChildrenBuffer.length -= openLayoutElement->children.length;
+    Clay__CalculateElementFitDimensions(openLayoutElement);
+
     bool elementIsFloating = Clay__ElementHasConfig(openLayoutElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING_CONTAINER);
 
     // Close the currently open element
-    int32_t closingElementIndex = Clay__int32_tArray_RemoveSwapback(&Clay__openLayoutElementStack, (int)Clay__openLayoutElementStack.length - 1);
+    int32_t closingElementIndex = Clay__int32_tArray_RemoveSwapback(&context->openLayoutElementStack, (int)context->openLayoutElementStack.length - 1);
     openLayoutElement = Clay__GetOpenLayoutElement();
 
-    if (!elementIsFloating && Clay__openLayoutElementStack.length > 1) {
+    if (!elementIsFloating && context->openLayoutElementStack.length > 1) {
         openLayoutElement->children.length++;
-        Clay__int32_tArray_Add(&Clay__layoutElementChildrenBuffer, closingElementIndex);
+        Clay__int32_tArray_Add(&context->layoutElementChildrenBuffer, closingElementIndex);
     }
 }
 
 void Clay__OpenElement(void) {
-    if (Clay__layoutElements.length == Clay__layoutElements.capacity - 1 || Clay__booleanWarnings.maxElementsExceeded) {
-        Clay__booleanWarnings.maxElementsExceeded = true;
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->layoutElements.length == context->layoutElements.capacity - 1 || context->booleanWarnings.maxElementsExceeded) {
+        context->booleanWarnings.maxElementsExceeded = true;
+        context->droppedElementCount++;
         return;
     }
     Clay_LayoutElement layoutElement = CLAY__INIT(Clay_LayoutElement) {};
-    Clay_LayoutElementArray_Add(&Clay__layoutElements, layoutElement);
-    Clay__int32_tArray_Add(&Clay__openLayoutElementStack, Clay__layoutElements.length - 1);
-    if (Clay__openClipElementStack.length > 0) {
-        Clay__int32_tArray_Set(&Clay__layoutElementClipElementIds, Clay__layoutElements.length - 1, Clay__int32_tArray_Get(&Clay__openClipElementStack, (int)Clay__openClipElementStack.length - 1));
+    Clay_LayoutElementArray_Add(&context->layoutElements, layoutElement);
+    Clay__int32_tArray_Add(&context->openLayoutElementStack, context->layoutElements.length - 1);
+    if (context->idleFrameSkippingEnabled) {
+        // The depth of each element as it's opened is enough to describe the shape of the tree
+        Clay__HashDeclaration(&context->openLayoutElementStack.length, sizeof(uint32_t));
+    }
+    if (context->openClipElementStack.length > 0) {
+        Clay__int32_tArray_Set(&context->layoutElementClipElementIds, context->layoutElements.length - 1, Clay__int32_tArray_Get(&context->openClipElementStack, (int)context->openClipElementStack.length - 1));
     } else {
-        Clay__int32_tArray_Set(&Clay__layoutElementClipElementIds, Clay__layoutElements.length - 1, 0);
+        Clay__int32_tArray_Set(&context->layoutElementClipElementIds, context->layoutElements.length - 1, 0);
     }
 }
 
 void Clay__OpenTextElement(Clay_String text, Clay_TextElementConfig *textConfig) {
-    if (Clay__layoutElements.length == Clay__layoutElements.capacity - 1 || Clay__booleanWarnings.maxElementsExceeded) {
-        Clay__booleanWarnings.maxElementsExceeded = true;
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->layoutElements.length == context->layoutElements.capacity - 1 || context->booleanWarnings.maxElementsExceeded) {
+        context->booleanWarnings.maxElementsExceeded = true;
+        context->droppedElementCount++;
         return;
     }
     Clay_LayoutElement *parentElement = Clay__GetOpenLayoutElement();
@@ -2004,75 +3668,177 @@ void Clay__OpenTextElement(Clay_String text, Clay_TextElementConfig *textConfig)
 
     Clay__OpenElement();
     Clay_LayoutElement * openLayoutElement = Clay__GetOpenLayoutElement();
-    Clay__int32_tArray_Add(&Clay__layoutElementChildrenBuffer, Clay__layoutElements.length - 1);
+    Clay__int32_tArray_Add(&context->layoutElementChildrenBuffer, context->layoutElements.length - 1);
+    if (context->idleFrameSkippingEnabled) {
+        // Render commands point into both the string and the config, so their addresses need to match as well as their contents
+        Clay__HashDeclaration(&text.chars, sizeof(text.chars));
+        Clay__HashDeclaration(text.chars, text.length);
+        Clay__HashDeclaration(&textConfig, sizeof(Clay_TextElementConfig *));
+        Clay__HashDeclaration(textConfig, sizeof(Clay_TextElementConfig));
+    }
     Clay__MeasureTextCacheItem *textMeasured = Clay__MeasureTextCached(&text, textConfig);
     Clay_ElementId elementId = Clay__HashString(CLAY_STRING("Text"), parentElement->children.length, parentElement->id);
     openLayoutElement->id = elementId.id;
     Clay__AddHashMapItem(elementId, openLayoutElement);
-    Clay__StringArray_Add(&Clay__layoutElementIdStrings, elementId.stringId);
+    Clay__StringArray_Add(&context->layoutElementIdStrings, elementId.stringId);
     Clay_Dimensions textDimensions = CLAY__INIT(Clay_Dimensions) { .width = textMeasured->unwrappedDimensions.width, .height = textConfig->lineHeight > 0 ? textConfig->lineHeight : textMeasured->unwrappedDimensions.height };
     openLayoutElement->dimensions = textDimensions;
     openLayoutElement->minDimensions = CLAY__INIT(Clay_Dimensions) { .width = textMeasured->unwrappedDimensions.height, .height = textDimensions.height }; // TODO not sure this is the best way to decide min width for text
-    openLayoutElement->textElementData = Clay__TextElementDataArray_Add(&Clay__textElementData, CLAY__INIT(Clay__TextElementData) { .text = text, .preferredDimensions = textMeasured->unwrappedDimensions, .elementIndex = Clay__layoutElements.length - 1 });
+    openLayoutElement->textElementData = Clay__TextElementDataArray_Add(&context->textElementData, CLAY__INIT(Clay__TextElementData) { .text = text, .preferredDimensions = textMeasured->unwrappedDimensions, .elementIndex = context->layoutElements.length - 1 });
     openLayoutElement->elementConfigs = CLAY__INIT(Clay__ElementConfigArraySlice) {
         .length = 1,
-        .internalArray = Clay__ElementConfigArray_Add(&Clay__elementConfigs, CLAY__INIT(Clay_ElementConfig) { .type = CLAY__ELEMENT_CONFIG_TYPE_TEXT, .config = { .textElementConfig = textConfig }})
+        .internalArray = Clay__ElementConfigArray_Add(&context->elementConfigs, CLAY__INIT(Clay_ElementConfig) { .type = CLAY__ELEMENT_CONFIG_TYPE_TEXT, .config = { .textElementConfig = textConfig }})
     };
-    openLayoutElement->configsEnabled |= CLAY__ELEMENT_CONFIG_TYPE_TEXT;
+    Clay__AddElementConfigSlot(openLayoutElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT, 0);
     openLayoutElement->layoutConfig = &CLAY_LAYOUT_DEFAULT;
     // Close the currently open element
-    Clay__int32_tArray_RemoveSwapback(&Clay__openLayoutElementStack, (int)Clay__openLayoutElementStack.length - 1);
+    Clay__int32_tArray_RemoveSwapback(&context->openLayoutElementStack, (int)context->openLayoutElementStack.length - 1);
+}
+
+Clay__MeasureTextCacheItem *Clay__GetMeasureTextCacheItem(Clay_String *text, Clay_TextElementConfig *config) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    uint32_t id = Clay__HashTextWithConfig(text, config);
+    int32_t elementIndex = context->measureTextHashMap.internalArray[id % context->measureTextHashMap.capacity];
+    while (elementIndex != 0) {
+        Clay__MeasureTextCacheItem *hashEntry = Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, elementIndex);
+        if (hashEntry->id == id) {
+            return hashEntry;
+        }
+        elementIndex = hashEntry->nextIndex;
+    }
+    return &CLAY__MEASURE_TEXT_CACHE_ITEM_DEFAULT;
+}
+
+// Text elements whose measurement was batched were declared with zero size. Once the batch has been resolved,
+// their sizes and the fit sizes of their ancestors are recalculated. Parents are always declared before their children,
+// so walking the elements in reverse visits every child before its parent. Every element from firstElementIndex onwards must be closed.
+void Clay__UpdateDeferredTextDimensions(int32_t firstElementIndex) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    for (int i = (int)context->layoutElements.length - 1; i >= firstElementIndex; --i) {
+        Clay_LayoutElement *element = Clay_LayoutElementArray_Get(&context->layoutElements, i);
+        if (Clay__ElementHasConfig(element, CLAY__ELEMENT_CONFIG_TYPE_TEXT)) {
+            Clay_TextElementConfig *textConfig = Clay__FindElementConfigWithType(element, CLAY__ELEMENT_CONFIG_TYPE_TEXT).textElementConfig;
+            Clay__MeasureTextCacheItem *textMeasured = Clay__GetMeasureTextCacheItem(&element->textElementData->text, textConfig);
+            element->dimensions = CLAY__INIT(Clay_Dimensions) { .width = textMeasured->unwrappedDimensions.width, .height = textConfig->lineHeight > 0 ? textConfig->lineHeight : textMeasured->unwrappedDimensions.height };
+            element->minDimensions = CLAY__INIT(Clay_Dimensions) { .width = textMeasured->unwrappedDimensions.height, .height = element->dimensions.height };
+            element->textElementData->preferredDimensions = textMeasured->unwrappedDimensions;
+        } else {
+            element->dimensions = CLAY__INIT(Clay_Dimensions) {};
+            element->minDimensions = CLAY__INIT(Clay_Dimensions) {};
+            Clay__CalculateElementFitDimensions(element);
+        }
+    }
+}
+
+uint32_t Clay__EphemeralCapacity(uint32_t capacity) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    return capacity > 0 ? capacity : context->maxElementCount;
 }
 
 void Clay__InitializeEphemeralMemory(Clay_Arena *arena) {
+    Clay_Context* context = Clay_GetCurrentContext();
     // Ephemeral Memory - reset every frame
-    Clay__internalArena.nextAllocation = Clay__arenaResetOffset;
-
-    Clay__layoutElementChildrenBuffer = Clay__int32_tArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__layoutElements = Clay_LayoutElementArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay_warnings = Clay__WarningArray_Allocate_Arena(100, arena);
-
-    Clay__layoutConfigs = Clay__LayoutConfigArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__elementConfigBuffer = Clay__ElementConfigArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__elementConfigs = Clay__ElementConfigArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__rectangleElementConfigs = Clay__RectangleElementConfigArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__textElementConfigs = Clay__TextElementConfigArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__imageElementConfigs = Clay__ImageElementConfigArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__floatingElementConfigs = Clay__FloatingElementConfigArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__scrollElementConfigs = Clay__ScrollElementConfigArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__customElementConfigs = Clay__CustomElementConfigArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__borderElementConfigs = Clay__BorderElementConfigArray_Allocate_Arena(Clay__maxElementCount, arena);
-
-    Clay__layoutElementIdStrings = Clay__StringArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__wrappedTextLines = Clay__WrappedTextLineArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__layoutElementTreeNodeArray1 = Clay__LayoutElementTreeNodeArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__layoutElementTreeRoots = Clay__LayoutElementTreeRootArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__layoutElementChildren = Clay__int32_tArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__openLayoutElementStack = Clay__int32_tArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__textElementData = Clay__TextElementDataArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__imageElementPointers = Clay__LayoutElementPointerArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__renderCommands = Clay_RenderCommandArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__treeNodeVisited = Clay__BoolArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__treeNodeVisited.length = Clay__treeNodeVisited.capacity; // This array is accessed directly rather than behaving as a list
-    Clay__openClipElementStack = Clay__int32_tArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__reusableElementIndexBuffer = Clay__int32_tArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__layoutElementClipElementIds = Clay__int32_tArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__dynamicStringData = Clay__CharArray_Allocate_Arena(Clay__maxElementCount, arena);
+    context->internalArena.nextAllocation = context->arenaResetOffset;
+    Clay_EphemeralCapacities *capacities = context->ephemeralCapacities.adaptive ? &context->adaptiveEphemeralCapacities : &context->ephemeralCapacities;
+
+    context->layoutElementChildrenBuffer = Clay__int32_tArray_Allocate_Arena(context->maxElementCount, arena);
+    context->layoutElements = Clay_LayoutElementArray_Allocate_Arena(context->maxElementCount, arena);
+    context->warnings = Clay__WarningArray_Allocate_Arena(100, arena);
+
+    context->layoutConfigs = Clay__LayoutConfigArray_Allocate_Arena(context->maxElementCount, arena);
+    context->elementConfigBuffer = Clay__ElementConfigArray_Allocate_Arena(context->maxElementCount, arena);
+    context->elementConfigs = Clay__ElementConfigArray_Allocate_Arena(context->maxElementCount, arena);
+    context->rectangleElementConfigs = Clay__RectangleElementConfigArray_Allocate_Arena(Clay__EphemeralCapacity(capacities->rectangleElementConfigs), arena);
+    context->textElementConfigs = Clay__TextElementConfigArray_Allocate_Arena(Clay__EphemeralCapacity(capacities->textElementConfigs), arena);
+    context->imageElementConfigs = Clay__ImageElementConfigArray_Allocate_Arena(Clay__EphemeralCapacity(capacities->imageElementConfigs), arena);
+    context->floatingElementConfigs = Clay__FloatingElementConfigArray_Allocate_Arena(Clay__EphemeralCapacity(capacities->floatingElementConfigs), arena);
+    context->scrollElementConfigs = Clay__ScrollElementConfigArray_Allocate_Arena(Clay__EphemeralCapacity(capacities->scrollElementConfigs), arena);
+    context->customElementConfigs = Clay__CustomElementConfigArray_Allocate_Arena(Clay__EphemeralCapacity(capacities->customElementConfigs), arena);
+    context->borderElementConfigs = Clay__BorderElementConfigArray_Allocate_Arena(Clay__EphemeralCapacity(capacities->borderElementConfigs), arena);
+
+    context->layoutElementIdStrings = Clay__StringArray_Allocate_Arena(context->maxElementCount, arena);
+    context->wrappedTextLines = Clay__WrappedTextLineArray_Allocate_Arena(Clay__EphemeralCapacity(capacities->wrappedTextLines), arena);
+    context->layoutElementTreeNodeArray1 = Clay__LayoutElementTreeNodeArray_Allocate_Arena(context->maxElementCount, arena);
+    context->layoutElementTreeRoots = Clay__LayoutElementTreeRootArray_Allocate_Arena(Clay__EphemeralCapacity(capacities->layoutElementTreeRoots), arena);
+    context->layoutElementChildren = Clay__int32_tArray_Allocate_Arena(context->maxElementCount, arena);
+    context->openLayoutElementStack = Clay__int32_tArray_Allocate_Arena(context->maxElementCount, arena);
+    context->textElementData = Clay__TextElementDataArray_Allocate_Arena(Clay__EphemeralCapacity(capacities->textElementData), arena);
+    context->imageElementPointers = Clay__LayoutElementPointerArray_Allocate_Arena(Clay__EphemeralCapacity(capacities->imageElementPointers), arena);
+    context->renderCommands = Clay_RenderCommandArray_Allocate_Arena(context->maxElementCount, arena);
+    context->renderCommandDeltas = Clay_RenderCommandDeltaArray_Allocate_Arena(context->renderCommandDeltasEnabled ? context->maxElementCount * 2 : 0, arena);
+    // Only take up space in the arena if they're going to be used
+    uint32_t compactRenderCommandCapacity = context->compactRenderCommandsEnabled ? context->maxElementCount : 0;
+    context->compactRenderCommands = Clay_CompactRenderCommandArray_Allocate_Arena(compactRenderCommandCapacity, arena);
+    context->compactRenderCommandTexts = Clay_CompactRenderCommandTextArray_Allocate_Arena(compactRenderCommandCapacity, arena);
+    context->damageRects = Clay_DamageRectArray_Allocate_Arena(16, arena);
+    context->treeNodeVisited = Clay__BoolArray_Allocate_Arena(context->maxElementCount, arena);
+    context->treeNodeVisited.length = context->treeNodeVisited.capacity; // This array is accessed directly rather than behaving as a list
+    // Only take up space in the arena if pointer queries are going to use the grid
+    uint32_t pointerHitGridCapacity = context->pointerHitGridEnabled ? context->maxElementCount : 0;
+    context->pointerHitRecords = Clay__PointerHitRecordArray_Allocate_Arena(pointerHitGridCapacity, arena);
+    context->pointerHitGridCells = Clay__int32_tArray_Allocate_Arena(pointerHitGridCapacity, arena);
+    context->pointerHitGridEntries = Clay__int32_tArray_Allocate_Arena(pointerHitGridCapacity * 4, arena);
+    context->pointHitTestIds = Clay__ElementIdArray_Allocate_Arena(pointerHitGridCapacity, arena);
+    context->pointerHitRecordsValid = false;
+    context->pointerHitGridValid = false;
+    context->openClipElementStack = Clay__int32_tArray_Allocate_Arena(context->maxElementCount, arena);
+    context->sizeDistributionCapacities = Clay__floatArray_Allocate_Arena(context->maxElementCount, arena);
+    context->reusableElementIndexBuffer = Clay__int32_tArray_Allocate_Arena(context->maxElementCount, arena);
+    context->layoutElementClipElementIds = Clay__int32_tArray_Allocate_Arena(context->maxElementCount, arena);
+    context->dynamicStringData = Clay__CharArray_Allocate_Arena(Clay__EphemeralCapacity(capacities->dynamicStringData), arena);
+    // Only take up space in the arena if text is measured in batches. A batch item is a text element, and holds at least one word.
+    uint32_t measureTextBatchWordCapacity = Clay__MeasureTextIsBatched() ? Clay__EphemeralCapacity(capacities->measureTextBatchWords) : 0;
+    uint32_t measureTextBatchItemCapacity = CLAY__MIN(measureTextBatchWordCapacity, Clay__EphemeralCapacity(capacities->textElementData));
+    context->measureTextBatchItems = Clay__MeasureTextBatchItemArray_Allocate_Arena(measureTextBatchItemCapacity, arena);
+    context->measureTextBatchWords = Clay__StringArray_Allocate_Arena(measureTextBatchWordCapacity, arena);
+    context->measureTextBatchConfigs = Clay__TextElementConfigPointerArray_Allocate_Arena(measureTextBatchWordCapacity, arena);
+    context->measureTextBatchDimensions = Clay__DimensionsArray_Allocate_Arena(measureTextBatchWordCapacity, arena);
+    context->measureTextBatchWordCacheIndexes = Clay__int32_tArray_Allocate_Arena(measureTextBatchWordCapacity, arena);
+    context->measureTextBatchResults = Clay__DimensionsArray_Allocate_Arena(measureTextBatchWordCapacity, arena);
+    context->measureTextBatchResultSources = Clay__int32_tArray_Allocate_Arena(measureTextBatchWordCapacity, arena);
+    context->textMeasurementDeferred = false;
+}
+
+// Only takes up space in the arena while render command deltas are enabled
+void Clay__InitializeRenderCommandFingerprintMemory(Clay_Arena *arena) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    uint32_t capacity = context->renderCommandDeltasEnabled ? context->maxElementCount : 0;
+    context->renderCommandFingerprints = Clay__RenderCommandFingerprintArray_Allocate_Arena(capacity, arena);
+    context->renderCommandFingerprintsHashMap = Clay__int32_tArray_Allocate_Arena(capacity, arena);
+    context->previousRenderCommandFingerprints = Clay__RenderCommandFingerprintArray_Allocate_Arena(capacity, arena);
+    context->previousRenderCommandFingerprintsHashMap = Clay__int32_tArray_Allocate_Arena(capacity, arena);
+}
+
+// Persistent memory whose size depends on maxElementCount, which is allocated again when the element capacity grows
+void Clay__InitializeElementCountPersistentMemory(Clay_Arena *arena) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->layoutElementsHashMapInternal = Clay__LayoutElementHashMapItemArray_Allocate_Arena(context->maxElementCount, arena);
+    context->layoutElementsHashMapInternalFreeList = Clay__int32_tArray_Allocate_Arena(context->maxElementCount, arena);
+    context->layoutElementsHashMap = Clay__LayoutElementHashMapSlotArray_Allocate_Arena(Clay__LayoutElementHashMapSlotCount(context->maxElementCount), arena);
+    context->measureTextHashMapInternal = Clay__MeasureTextCacheItemArray_Allocate_Arena(context->maxElementCount, arena);
+    context->measureTextHashMapInternalFreeList = Clay__int32_tArray_Allocate_Arena(context->maxElementCount, arena);
+    context->pointerOverIds = Clay__ElementIdArray_Allocate_Arena(context->maxElementCount, arena);
+    Clay__InitializeRenderCommandFingerprintMemory(arena);
+    context->debugElementData = Clay__DebugElementDataArray_Allocate_Arena(context->maxElementCount, arena);
 }
 
 void Clay__InitializePersistentMemory(Clay_Arena *arena) {
+    Clay_Context* context = Clay_GetCurrentContext();
     // Persistent memory - initialized once and not reset
-    Clay__scrollContainerDatas = Clay__ScrollContainerDataInternalArray_Allocate_Arena(10, arena);
-    Clay__layoutElementsHashMapInternal = Clay__LayoutElementHashMapItemArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__layoutElementsHashMap = Clay__int32_tArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__measureTextHashMapInternal = Clay__MeasureTextCacheItemArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__measureTextHashMapInternalFreeList = Clay__int32_tArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__measuredWordsFreeList = Clay__int32_tArray_Allocate_Arena(Clay__maxMeasureTextCacheWordCount, arena);
-    Clay__measureTextHashMap = Clay__int32_tArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__measuredWords = Clay__MeasuredWordArray_Allocate_Arena(Clay__maxMeasureTextCacheWordCount, arena);
-    Clay__pointerOverIds = Clay__ElementIdArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__debugElementData = Clay__DebugElementDataArray_Allocate_Arena(Clay__maxElementCount, arena);
-    Clay__arenaResetOffset = arena->nextAllocation;
+    context->fontMetrics = Clay__RegisteredFontMetricsArray_Allocate_Arena(32, arena);
+    context->scrollContainerDatas = Clay__ScrollContainerDataInternalArray_Allocate_Arena(context->maxScrollContainerCount, arena);
+    context->measuredWordsFreeList = Clay__int32_tArray_Allocate_Arena(context->maxMeasureTextCacheWordCount, arena);
+    context->measuredWords = Clay__MeasuredWordArray_Allocate_Arena(context->maxMeasureTextCacheWordCount, arena);
+    context->wrappedLineCache = Clay__MeasuredWordArray_Allocate_Arena(CLAY__MAX(context->maxMeasureTextCacheWordCount / 4, 1), arena);
+    context->wrappedLineCacheFreeList = Clay__int32_tArray_Allocate_Arena(CLAY__MAX(context->maxMeasureTextCacheWordCount / 4, 1), arena);
+    // Words shared between strings are only stored once, so the shared word cache needs far fewer slots than the per-string word lists
+    uint32_t measureWordCacheCapacity = CLAY__MAX(context->maxMeasureTextCacheWordCount / 4, 2);
+    context->measureWordHashMapInternal = Clay__MeasureWordCacheItemArray_Allocate_Arena(measureWordCacheCapacity, arena);
+    context->measureWordHashMapInternalFreeList = Clay__int32_tArray_Allocate_Arena(measureWordCacheCapacity, arena);
+    context->measureWordHashMap = Clay__int32_tArray_Allocate_Arena(CLAY__MAX(measureWordCacheCapacity / 4, 1), arena);
+    context->measureTextHashMap = Clay__int32_tArray_Allocate_Arena(CLAY__MAX(context->maxMeasureTextCacheWordCount / 32, 1), arena);
+    Clay__InitializeElementCountPersistentMemory(arena);
+    context->arenaResetOffset = arena->nextAllocation;
 }
 
 
@@ -2083,74 +3849,125 @@ typedef enum
     CLAY__SIZE_DISTRIBUTION_TYPE_GROW_CONTAINER,
 } Clay__SizeDistributionType;
 
+void Clay__SwapSizeDistributionEntries(int32_t *elementIndexes, float *capacities, int32_t a, int32_t b) {
+    int32_t elementIndex = elementIndexes[a];
+    float capacity = capacities[a];
+    elementIndexes[a] = elementIndexes[b];
+    capacities[a] = capacities[b];
+    elementIndexes[b] = elementIndex;
+    capacities[b] = capacity;
+}
+
+// Finds the share that every child which isn't clamped ends up with, which is the level where min(capacity, share) summed over all children equals sizeToDistribute.
+// Rather than fully sorting the children by capacity, each step partitions them around a pivot capacity like quickselect, and only continues on the side the share falls in.
+float Clay__FindSizeDistributionShare(int32_t *elementIndexes, float *capacities, int32_t count, float sizeToDistribute) {
+    int32_t start = 0, end = count, unclampedCount = 0;
+    float clampedSize = 0;
+    while (start < end) {
+        float pivot = capacities[start + (end - start) / 2];
+        // [start, lessEnd) < pivot, [lessEnd, equalEnd) == pivot, [greaterStart, end) > pivot
+        int32_t lessEnd = start, equalEnd = start, greaterStart = end;
+        float lessSize = 0;
+        while (equalEnd < greaterStart) {
+            if (capacities[equalEnd] < pivot) {
+                lessSize += capacities[equalEnd];
+                Clay__SwapSizeDistributionEntries(elementIndexes, capacities, lessEnd++, equalEnd++);
+            } else if (capacities[equalEnd] > pivot) {
+                Clay__SwapSizeDistributionEntries(elementIndexes, capacities, equalEnd, --greaterStart);
+            } else {
+                equalEnd++;
+            }
+        }
+        if (clampedSize + lessSize + pivot * (float)(unclampedCount + end - lessEnd) >= sizeToDistribute) {
+            // Every child with at least the pivot capacity takes the share without being clamped
+            unclampedCount += end - lessEnd;
+            end = lessEnd;
+        } else {
+            clampedSize += lessSize + pivot * (float)(equalEnd - lessEnd);
+            start = equalEnd;
+        }
+    }
+    return unclampedCount > 0 ? (sizeToDistribute - clampedSize) / (float)unclampedCount : CLAY__MAXFLOAT;
+}
+
+// Spreads sizeToDistribute evenly across the eligible children, with any child that hits its min or max size passing the rest of its share on to the others.
 float Clay__DistributeSizeAmongChildren(bool xAxis, float sizeToDistribute, Clay__int32_tArray resizableContainerBuffer, Clay__SizeDistributionType distributionType) {
-    Clay__int32_tArray remainingElements = Clay__openClipElementStack;
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__int32_tArray remainingElements = context->openClipElementStack;
+    Clay__floatArray capacities = context->sizeDistributionCapacities;
     remainingElements.length = 0;
-
-    for (int i = 0; i < resizableContainerBuffer.length; ++i) {
-        Clay__int32_tArray_Add(&remainingElements, Clay__int32_tArray_Get(&resizableContainerBuffer, i));
-    }
-
-    while (sizeToDistribute != 0 && remainingElements.length > 0) {
-        float dividedSize = sizeToDistribute / (float)remainingElements.length;
-        for (int childOffset = 0; childOffset < remainingElements.length; childOffset++) {
-            Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&Clay__layoutElements, Clay__int32_tArray_Get(&remainingElements, childOffset));
-            Clay_SizingAxis childSizing = xAxis ? childElement->layoutConfig->sizing.width : childElement->layoutConfig->sizing.height;
-            float *childSize = xAxis ? &childElement->dimensions.width : &childElement->dimensions.height;
-            float childMinSize = xAxis ? childElement->minDimensions.width : childElement->minDimensions.height;
-            bool canDistribute = true;
-
-            if ((sizeToDistribute < 0 && *childSize == childSizing.size.minMax.min) || (sizeToDistribute > 0 && *childSize == childSizing.size.minMax.max)) {
-                canDistribute = false;
-            }
-            // Currently, we don't support squishing aspect ratio images on their Y axis as it would break ratio
-            else if (!xAxis && Clay__ElementHasConfig(childElement, CLAY__ELEMENT_CONFIG_TYPE_IMAGE)) {
-                canDistribute = false;
-            }
-            else {
-                switch (distributionType) {
-                    case CLAY__SIZE_DISTRIBUTION_TYPE_RESIZEABLE_CONTAINER: break;
-                    case CLAY__SIZE_DISTRIBUTION_TYPE_GROW_CONTAINER: if (childSizing.type != CLAY__SIZING_TYPE_GROW) canDistribute = false; break;
-                    case CLAY__SIZE_DISTRIBUTION_TYPE_SCROLL_CONTAINER: {
-                        if (Clay__ElementHasConfig(childElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER)) {
-                            Clay_ScrollElementConfig *scrollConfig = Clay__FindElementConfigWithType(childElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER).scrollElementConfig;
-                            if ((xAxis && !scrollConfig->horizontal) || (!xAxis && !scrollConfig->vertical)) {
-                                Clay__int32_tArray_RemoveSwapback(&remainingElements, childOffset);
-                                childOffset--;
-                                continue;
-                            }
-                        }
+    capacities.length = 0;
+    if (sizeToDistribute == 0) {
+        return 0;
+    }
+    bool growing = sizeToDistribute > 0;
+    float remainingSize = growing ? sizeToDistribute : -sizeToDistribute;
+    float smallestCapacity = 0;
+
+    for (int32_t i = 0; i < (int32_t)resizableContainerBuffer.length; ++i) {
+        int32_t childElementIndex = Clay__int32_tArray_Get(&resizableContainerBuffer, i);
+        Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, childElementIndex);
+        Clay_SizingAxis childSizing = xAxis ? childElement->layoutConfig->sizing.width : childElement->layoutConfig->sizing.height;
+        float childSize = xAxis ? childElement->dimensions.width : childElement->dimensions.height;
+        float childMinSize = CLAY__MAX(childSizing.size.minMax.min, xAxis ? childElement->minDimensions.width : childElement->minDimensions.height);
+
+        if ((!growing && childSize == childSizing.size.minMax.min) || (growing && childSize == childSizing.size.minMax.max)) {
+            continue;
+        }
+        // Currently, we don't support squishing aspect ratio images on their Y axis as it would break ratio
+        if (!xAxis && Clay__ElementHasConfig(childElement, CLAY__ELEMENT_CONFIG_TYPE_IMAGE)) {
+            continue;
+        }
+        switch (distributionType) {
+            case CLAY__SIZE_DISTRIBUTION_TYPE_RESIZEABLE_CONTAINER: break;
+            case CLAY__SIZE_DISTRIBUTION_TYPE_GROW_CONTAINER: if (childSizing.type != CLAY__SIZING_TYPE_GROW) continue; break;
+            case CLAY__SIZE_DISTRIBUTION_TYPE_SCROLL_CONTAINER: {
+                if (Clay__ElementHasConfig(childElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER)) {
+                    Clay_ScrollElementConfig *scrollConfig = Clay__FindElementConfigWithType(childElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER).scrollElementConfig;
+                    if ((xAxis && !scrollConfig->horizontal) || (!xAxis && !scrollConfig->vertical)) {
+                        continue;
                     }
                 }
             }
-
-            if (!canDistribute) {
-                Clay__int32_tArray_RemoveSwapback(&remainingElements, childOffset);
-                childOffset--;
-                continue;
-            }
-
-            float oldChildSize = *childSize;
-            *childSize = CLAY__MAX(CLAY__MAX(CLAY__MIN(childSizing.size.minMax.max, *childSize + dividedSize), childSizing.size.minMax.min), childMinSize);
-            float diff = *childSize - oldChildSize;
-            if (diff > -0.01 && diff < 0.01) {
-                Clay__int32_tArray_RemoveSwapback(&remainingElements, childOffset);
-                childOffset--;
-                continue;
-            }
-            sizeToDistribute -= diff;
+        }
+        // A child that's below its min size is clamped up to it first, and the other children make up the difference
+        if (childSize < childMinSize) {
+            remainingSize += growing ? childSize - childMinSize : childMinSize - childSize;
+            childSize = childMinSize;
+            *(xAxis ? &childElement->dimensions.width : &childElement->dimensions.height) = childMinSize;
+        }
+        float capacity = growing ? CLAY__MAX(childSizing.size.minMax.max, childMinSize) - childSize : childSize - childMinSize;
+        if (capacity > 0) {
+            smallestCapacity = remainingElements.length == 0 ? capacity : CLAY__MIN(smallestCapacity, capacity);
+            Clay__int32_tArray_Add(&remainingElements, childElementIndex);
+            capacities.internalArray[capacities.length++] = capacity;
         }
     }
+
+    // If no child is clamped by an even share, there's no need to search for the share
+    float share = remainingElements.length > 0 && remainingSize > 0 ? remainingSize / (float)remainingElements.length : 0;
+    if (smallestCapacity < share) {
+        share = Clay__FindSizeDistributionShare(remainingElements.internalArray, capacities.internalArray, (int32_t)remainingElements.length, remainingSize);
+    }
+    for (int32_t childOffset = 0; childOffset < (int32_t)remainingElements.length; childOffset++) {
+        Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_Get(&remainingElements, childOffset));
+        float *childSize = xAxis ? &childElement->dimensions.width : &childElement->dimensions.height;
+        float change = CLAY__MIN(capacities.internalArray[childOffset], share);
+        *childSize += growing ? change : -change;
+        remainingSize -= change;
+    }
+    sizeToDistribute = growing ? remainingSize : -remainingSize;
     return (sizeToDistribute > -0.01 && sizeToDistribute < 0.01) ? 0 : sizeToDistribute;
 }
 
 void Clay__SizeContainersAlongAxis(bool xAxis) {
-    Clay__int32_tArray bfsBuffer = Clay__layoutElementChildrenBuffer;
-    Clay__int32_tArray resizableContainerBuffer = Clay__openLayoutElementStack;
-    for (int rootIndex = 0; rootIndex < Clay__layoutElementTreeRoots.length; ++rootIndex) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__int32_tArray bfsBuffer = context->layoutElementChildrenBuffer;
+    Clay__int32_tArray resizableContainerBuffer = context->openLayoutElementStack;
+    for (int32_t rootIndex = 0; rootIndex < (int32_t)context->layoutElementTreeRoots.length; ++rootIndex) {
         bfsBuffer.length = 0;
-        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&Clay__layoutElementTreeRoots, rootIndex);
-        Clay_LayoutElement *rootElement = Clay_LayoutElementArray_Get(&Clay__layoutElements, (int)root->layoutElementIndex);
+        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
+        Clay_LayoutElement *rootElement = Clay_LayoutElementArray_Get(&context->layoutElements, (int)root->layoutElementIndex);
         Clay__int32_tArray_Add(&bfsBuffer, (int32_t)root->layoutElementIndex);
 
         // Size floating containers to their parents
@@ -2173,7 +3990,7 @@ void Clay__SizeContainersAlongAxis(bool xAxis) {
 
         for (int i = 0; i < bfsBuffer.length; ++i) {
             int32_t parentIndex = Clay__int32_tArray_Get(&bfsBuffer, i);
-            Clay_LayoutElement *parent = Clay_LayoutElementArray_Get(&Clay__layoutElements, parentIndex);
+            Clay_LayoutElement *parent = Clay_LayoutElementArray_Get(&context->layoutElements, parentIndex);
             Clay_LayoutConfig *parentStyleConfig = parent->layoutConfig;
             int growContainerCount = 0;
             float parentSize = xAxis ? parent->dimensions.width : parent->dimensions.height;
@@ -2185,7 +4002,7 @@ void Clay__SizeContainersAlongAxis(bool xAxis) {
 
             for (int childOffset = 0; childOffset < parent->children.length; childOffset++) {
                 int32_t childElementIndex = parent->children.elements[childOffset];
-                Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&Clay__layoutElements, childElementIndex);
+                Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, childElementIndex);
                 Clay_SizingAxis childSizing = xAxis ? childElement->layoutConfig->sizing.width : childElement->layoutConfig->sizing.height;
                 float childSize = xAxis ? childElement->dimensions.width : childElement->dimensions.height;
 
@@ -2215,7 +4032,7 @@ void Clay__SizeContainersAlongAxis(bool xAxis) {
             // Expand percentage containers to size
             for (int childOffset = 0; childOffset < parent->children.length; childOffset++) {
                 int32_t childElementIndex = parent->children.elements[childOffset];
-                Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&Clay__layoutElements, childElementIndex);
+                Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, childElementIndex);
                 Clay_SizingAxis childSizing = xAxis ? childElement->layoutConfig->sizing.width : childElement->layoutConfig->sizing.height;
                 float *childSize = xAxis ? &childElement->dimensions.width : &childElement->dimensions.height;
                 if (childSizing.type == CLAY__SIZING_TYPE_PERCENT) {
@@ -2254,7 +4071,7 @@ void Clay__SizeContainersAlongAxis(bool xAxis) {
                 } else if (sizeToDistribute > 0 && growContainerCount > 0) {
                     float targetSize = (sizeToDistribute + growContainerContentSize) / growContainerCount;
                     for (int childOffset = 0; childOffset < resizableContainerBuffer.length; childOffset++) {
-                        Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&Clay__layoutElements, Clay__int32_tArray_Get(&resizableContainerBuffer, childOffset));
+                        Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_Get(&resizableContainerBuffer, childOffset));
                         Clay_SizingAxis childSizing = xAxis ? childElement->layoutConfig->sizing.width : childElement->layoutConfig->sizing.height;
                         if (childSizing.type == CLAY__SIZING_TYPE_GROW) {
                             float *childSize = xAxis ? &childElement->dimensions.width : &childElement->dimensions.height;
@@ -2274,7 +4091,7 @@ void Clay__SizeContainersAlongAxis(bool xAxis) {
             // Sizing along the non layout axis ("off axis")
             } else {
                 for (int childOffset = 0; childOffset < resizableContainerBuffer.length; childOffset++) {
-                    Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&Clay__layoutElements, Clay__int32_tArray_Get(&resizableContainerBuffer, childOffset));
+                    Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_Get(&resizableContainerBuffer, childOffset));
                     Clay_SizingAxis childSizing = xAxis ? childElement->layoutConfig->sizing.width : childElement->layoutConfig->sizing.height;
                     float *childSize = xAxis ? &childElement->dimensions.width : &childElement->dimensions.height;
 
@@ -2302,10 +4119,15 @@ void Clay__SizeContainersAlongAxis(bool xAxis) {
 }
 
 Clay_String Clay__IntToString(int integer) {
+    Clay_Context* context = Clay_GetCurrentContext();
     if (integer == 0) {
         return CLAY__INIT(Clay_String) { .length = 1, .chars = "0" };
     }
-    char *chars = (char *)(Clay__dynamicStringData.internalArray + Clay__dynamicStringData.length);
+    // Enough room for the longest possible int, including the sign
+    if (context->dynamicStringData.length + 11 > context->dynamicStringData.capacity) {
+        return CLAY_STRING("?");
+    }
+    char *chars = (char *)(context->dynamicStringData.internalArray + context->dynamicStringData.length);
     int length = 0;
     int sign = integer;
 
@@ -2327,44 +4149,673 @@ Clay_String Clay__IntToString(int integer) {
         chars[j] = chars[k];
         chars[k] = temp;
     }
-    Clay__dynamicStringData.length += length;
+    context->dynamicStringData.length += length;
     return CLAY__INIT(Clay_String) { .length = length, .chars = chars };
 }
 
-void Clay__AddRenderCommand(Clay_RenderCommand renderCommand) {
-    if (Clay__renderCommands.length < Clay__renderCommands.capacity - 1) {
-        Clay_RenderCommandArray_Add(&Clay__renderCommands, renderCommand);
+void Clay__AddRenderCommand(Clay_RenderCommandArray *renderCommands, Clay_RenderCommand renderCommand) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (renderCommands->length < renderCommands->capacity - 1) {
+        Clay_RenderCommandArray_Add(renderCommands, renderCommand);
     } else {
-        if (!Clay__booleanWarnings.maxRenderCommandsExceeded) {
-            Clay__booleanWarnings.maxRenderCommandsExceeded = true;
-            Clay__errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+        if (!context->booleanWarnings.maxRenderCommandsExceeded) {
+            context->booleanWarnings.maxRenderCommandsExceeded = true;
+            context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
                 .errorType = CLAY_ERROR_TYPE_ELEMENTS_CAPACITY_EXCEEDED,
                 .errorText = CLAY_STRING("Clay ran out of capacity while attempting to create render commands. This is usually caused by a large amount of wrapping text elements while close to the max element capacity. Try using Clay_SetMaxElementCount() with a higher value."),
-                .userData = Clay__errorHandler.userData });
+                .userData = context->errorHandler.userData });
+        }
+    }
+}
+
+bool Clay__ElementIsOffscreen(Clay_BoundingBox *boundingBox) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->disableCulling) {
+        return false;
+    }
+
+    return (boundingBox->x > (float)context->layoutDimensions.width) ||
+           (boundingBox->y > (float)context->layoutDimensions.height) ||
+           (boundingBox->x + boundingBox->width < 0) ||
+           (boundingBox->y + boundingBox->height < 0);
+}
+
+// Calculates final positions and generates render commands for a single layout tree root
+void Clay__CalculateRootLayout(Clay__LayoutElementTreeRoot *root, Clay__LayoutElementTreeNodeArray dfsBuffer, bool *treeNodeVisited, Clay_RenderCommandArray *renderCommands, Clay__RectangleElementConfigArray *rectangleConfigs, Clay_ScrollElementConfig *rootClipConfig) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    uint32_t firstRenderCommandIndex = renderCommands->length;
+    dfsBuffer.length = 0;
+    Clay_LayoutElement *rootElement = Clay_LayoutElementArray_Get(&context->layoutElements, (int)root->layoutElementIndex);
+    Clay_Vector2 rootPosition = CLAY__INIT(Clay_Vector2) {};
+    Clay_LayoutElementHashMapItem *parentHashMapItem = Clay__GetHashMapItem(root->parentId);
+    // Position root floating containers
+    if (Clay__ElementHasConfig(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING_CONTAINER) && parentHashMapItem) {
+        Clay_FloatingElementConfig *config = Clay__FindElementConfigWithType(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING_CONTAINER).floatingElementConfig;
+        Clay_Dimensions rootDimensions = rootElement->dimensions;
+        Clay_BoundingBox parentBoundingBox = parentHashMapItem->boundingBox;
+        // Set X position
+        Clay_Vector2 targetAttachPosition = CLAY__INIT(Clay_Vector2){};
+        switch (config->attachment.parent) {
+            case CLAY_ATTACH_POINT_LEFT_TOP:
+            case CLAY_ATTACH_POINT_LEFT_CENTER:
+            case CLAY_ATTACH_POINT_LEFT_BOTTOM: targetAttachPosition.x = parentBoundingBox.x; break;
+            case CLAY_ATTACH_POINT_CENTER_TOP:
+            case CLAY_ATTACH_POINT_CENTER_CENTER:
+            case CLAY_ATTACH_POINT_CENTER_BOTTOM: targetAttachPosition.x = parentBoundingBox.x + (parentBoundingBox.width / 2); break;
+            case CLAY_ATTACH_POINT_RIGHT_TOP:
+            case CLAY_ATTACH_POINT_RIGHT_CENTER:
+            case CLAY_ATTACH_POINT_RIGHT_BOTTOM: targetAttachPosition.x = parentBoundingBox.x + parentBoundingBox.width; break;
+        }
+        switch (config->attachment.element) {
+            case CLAY_ATTACH_POINT_LEFT_TOP:
+            case CLAY_ATTACH_POINT_LEFT_CENTER:
+            case CLAY_ATTACH_POINT_LEFT_BOTTOM: break;
+            case CLAY_ATTACH_POINT_CENTER_TOP:
+            case CLAY_ATTACH_POINT_CENTER_CENTER:
+            case CLAY_ATTACH_POINT_CENTER_BOTTOM: targetAttachPosition.x -= (rootDimensions.width / 2); break;
+            case CLAY_ATTACH_POINT_RIGHT_TOP:
+            case CLAY_ATTACH_POINT_RIGHT_CENTER:
+            case CLAY_ATTACH_POINT_RIGHT_BOTTOM: targetAttachPosition.x -= rootDimensions.width; break;
+        }
+        switch (config->attachment.parent) { // I know I could merge the x and y switch statements, but this is easier to read
+            case CLAY_ATTACH_POINT_LEFT_TOP:
+            case CLAY_ATTACH_POINT_RIGHT_TOP:
+            case CLAY_ATTACH_POINT_CENTER_TOP: targetAttachPosition.y = parentBoundingBox.y; break;
+            case CLAY_ATTACH_POINT_LEFT_CENTER:
+            case CLAY_ATTACH_POINT_CENTER_CENTER:
+            case CLAY_ATTACH_POINT_RIGHT_CENTER: targetAttachPosition.y = parentBoundingBox.y + (parentBoundingBox.height / 2); break;
+            case CLAY_ATTACH_POINT_LEFT_BOTTOM:
+            case CLAY_ATTACH_POINT_CENTER_BOTTOM:
+            case CLAY_ATTACH_POINT_RIGHT_BOTTOM: targetAttachPosition.y = parentBoundingBox.y + parentBoundingBox.height; break;
+        }
+        switch (config->attachment.element) {
+            case CLAY_ATTACH_POINT_LEFT_TOP:
+            case CLAY_ATTACH_POINT_RIGHT_TOP:
+            case CLAY_ATTACH_POINT_CENTER_TOP: break;
+            case CLAY_ATTACH_POINT_LEFT_CENTER:
+            case CLAY_ATTACH_POINT_CENTER_CENTER:
+            case CLAY_ATTACH_POINT_RIGHT_CENTER: targetAttachPosition.y -= (rootDimensions.height / 2); break;
+            case CLAY_ATTACH_POINT_LEFT_BOTTOM:
+            case CLAY_ATTACH_POINT_CENTER_BOTTOM:
+            case CLAY_ATTACH_POINT_RIGHT_BOTTOM: targetAttachPosition.y -= rootDimensions.height; break;
+        }
+        targetAttachPosition.x += config->offset.x;
+        targetAttachPosition.y += config->offset.y;
+        rootPosition = targetAttachPosition;
+    }
+    if (root->clipElementId) {
+        Clay_LayoutElementHashMapItem *clipHashMapItem = Clay__GetHashMapItem(root->clipElementId);
+        if (clipHashMapItem) {
+            // Floating elements that are attached to scrolling contents won't be correctly positioned if external scroll handling is enabled, fix here
+            if (context->externalScrollHandlingEnabled) {
+                Clay_ScrollElementConfig *scrollConfig = Clay__FindElementConfigWithType(clipHashMapItem->layoutElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER).scrollElementConfig;
+                Clay__ScrollContainerDataInternal *mapping = Clay__GetScrollContainerDataInternal(root->clipElementId);
+                if (mapping && mapping->layoutElement == clipHashMapItem->layoutElement) {
+                    root->pointerOffset = mapping->scrollPosition;
+                    if (scrollConfig->horizontal) {
+                        rootPosition.x += mapping->scrollPosition.x;
+                    }
+                    if (scrollConfig->vertical) {
+                        rootPosition.y += mapping->scrollPosition.y;
+                    }
+                }
+            }
+            Clay__AddRenderCommand(renderCommands, CLAY__INIT(Clay_RenderCommand) {
+                .boundingBox = clipHashMapItem->boundingBox,
+                .config = { .scrollElementConfig = rootClipConfig },
+                .id = Clay__RehashWithNumber(rootElement->id, 10), // TODO need a better strategy for managing derived ids
+                .commandType = CLAY_RENDER_COMMAND_TYPE_SCISSOR_START,
+            });
+        }
+    }
+    Clay__LayoutElementTreeNodeArray_Add(&dfsBuffer, CLAY__INIT(Clay__LayoutElementTreeNode) { .layoutElement = rootElement, .position = rootPosition, .nextChildOffset = CLAY__INIT(Clay_Vector2) { .x = (float)rootElement->layoutConfig->padding.x, .y = (float)rootElement->layoutConfig->padding.y } });
+
+    treeNodeVisited[0] = false;
+    while (dfsBuffer.length > 0) {
+        Clay__LayoutElementTreeNode *currentElementTreeNode = Clay__LayoutElementTreeNodeArray_Get(&dfsBuffer, (int)dfsBuffer.length - 1);
+        Clay_LayoutElement *currentElement = currentElementTreeNode->layoutElement;
+        Clay_LayoutConfig *layoutConfig = currentElement->layoutConfig;
+        Clay_Vector2 scrollOffset = {0};
+
+        // This will only be run a single time for each element in downwards DFS order
+        if (!treeNodeVisited[dfsBuffer.length - 1]) {
+            treeNodeVisited[dfsBuffer.length - 1] = true;
+
+            Clay_BoundingBox currentElementBoundingBox = CLAY__INIT(Clay_BoundingBox) { currentElementTreeNode->position.x, currentElementTreeNode->position.y, currentElement->dimensions.width, currentElement->dimensions.height };
+            if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING_CONTAINER)) {
+                Clay_FloatingElementConfig *floatingElementConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING_CONTAINER).floatingElementConfig;
+                Clay_Dimensions expand = floatingElementConfig->expand;
+                currentElementBoundingBox.x -= expand.width;
+                currentElementBoundingBox.width += expand.width * 2;
+                currentElementBoundingBox.y -= expand.height;
+                currentElementBoundingBox.height += expand.height * 2;
+            }
+
+            Clay__ScrollContainerDataInternal *scrollContainerData = CLAY__NULL;
+            // Apply scroll offsets to container
+            if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER)) {
+                Clay_ScrollElementConfig *scrollConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER).scrollElementConfig;
+
+                Clay__ScrollContainerDataInternal *mapping = Clay__GetScrollContainerDataInternal(currentElement->id);
+                if (mapping && mapping->layoutElement == currentElement) {
+                    scrollContainerData = mapping;
+                    mapping->boundingBox = currentElementBoundingBox;
+                    if (scrollConfig->horizontal) {
+                        scrollOffset.x = mapping->scrollPosition.x;
+                    }
+                    if (scrollConfig->vertical) {
+                        scrollOffset.y = mapping->scrollPosition.y;
+                    }
+                    if (context->externalScrollHandlingEnabled) {
+                        scrollOffset = CLAY__INIT(Clay_Vector2) {};
+                    }
+                }
+            }
+
+            Clay_LayoutElementHashMapItem *hashMapItem = Clay__GetHashMapItem(currentElement->id);
+            if (hashMapItem) {
+                hashMapItem->boundingBox = currentElementBoundingBox;
+            }
+
+            // Create the render commands for this element, with configs already in render order from Clay__SortElementConfigsForRendering
+            for (int32_t elementConfigIndex = 0; elementConfigIndex < (int32_t)currentElement->elementConfigs.length; ++elementConfigIndex) {
+                Clay_ElementConfig *elementConfig = Clay__ElementConfigArraySlice_Get(&currentElement->elementConfigs, elementConfigIndex);
+                Clay_RenderCommand renderCommand = CLAY__INIT(Clay_RenderCommand) {
+                    .boundingBox = currentElementBoundingBox,
+                    .config = elementConfig->config,
+                    .id = currentElement->id,
+                };
+
+                bool offscreen = Clay__ElementIsOffscreen(&currentElementBoundingBox);
+                // Culling - Don't bother to generate render commands for rectangles entirely outside the screen - this won't stop their children from being rendered if they overflow
+                bool shouldRender = !offscreen;
+                switch (elementConfig->type) {
+                    case CLAY__ELEMENT_CONFIG_TYPE_RECTANGLE: {
+                        renderCommand.commandType = CLAY_RENDER_COMMAND_TYPE_RECTANGLE;
+                        break;
+                    }
+                    case CLAY__ELEMENT_CONFIG_TYPE_BORDER_CONTAINER: {
+                        shouldRender = false;
+                        break;
+                    }
+                    case CLAY__ELEMENT_CONFIG_TYPE_FLOATING_CONTAINER: {
+                        renderCommand.commandType = CLAY_RENDER_COMMAND_TYPE_NONE;
+                        shouldRender = false;
+                        break;
+                    }
+                    case CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER: {
+                        renderCommand.commandType = CLAY_RENDER_COMMAND_TYPE_SCISSOR_START;
+                        shouldRender = true;
+                        break;
+                    }
+                    case CLAY__ELEMENT_CONFIG_TYPE_IMAGE: {
+                        renderCommand.commandType = CLAY_RENDER_COMMAND_TYPE_IMAGE;
+                        break;
+                    }
+                    case CLAY__ELEMENT_CONFIG_TYPE_TEXT: {
+                        if (!shouldRender) {
+                            break;
+                        }
+                        shouldRender = false;
+                        Clay_ElementConfigUnion configUnion = elementConfig->config;
+                        Clay_TextElementConfig *textElementConfig = configUnion.textElementConfig;
+                        float naturalLineHeight = currentElement->textElementData->preferredDimensions.height;
+                        float finalLineHeight = textElementConfig->lineHeight > 0 ? textElementConfig->lineHeight : naturalLineHeight;
+                        float lineHeightOffset = (finalLineHeight - naturalLineHeight) / 2;
+                        float yPosition = lineHeightOffset;
+                        for (int32_t lineIndex = 0; lineIndex < (int32_t)currentElement->textElementData->wrappedLines.length; ++lineIndex) {
+                            Clay__WrappedTextLine wrappedLine = currentElement->textElementData->wrappedLines.internalArray[lineIndex]; // todo range check
+                            if (wrappedLine.line.length == 0) {
+                                yPosition += finalLineHeight;
+                                continue;
+                            }
+                            Clay__AddRenderCommand(renderCommands, CLAY__INIT(Clay_RenderCommand) {
+                                .boundingBox = { currentElementBoundingBox.x, currentElementBoundingBox.y + yPosition, wrappedLine.dimensions.width, wrappedLine.dimensions.height }, // TODO width
+                                .config = configUnion,
+                                .text = wrappedLine.line,
+                                .id = Clay__HashNumber(lineIndex, currentElement->id).id,
+                                .commandType = CLAY_RENDER_COMMAND_TYPE_TEXT,
+                            });
+                            yPosition += finalLineHeight;
+
+                            if (!context->disableCulling && (currentElementBoundingBox.y + yPosition > context->layoutDimensions.height)) {
+                                break;
+                            }
+                        }
+                        break;
+                    }
+                    case CLAY__ELEMENT_CONFIG_TYPE_CUSTOM: {
+                        renderCommand.commandType = CLAY_RENDER_COMMAND_TYPE_CUSTOM;
+                        break;
+                    }
+                    default: break;
+                }
+                if (shouldRender) {
+                    Clay__AddRenderCommand(renderCommands, renderCommand);
+                }
+                if (offscreen) {
+                    // NOTE: You may be tempted to try an early return / continue if an element is off screen. Why bother calculating layout for its children, right?
+                    // Unfortunately, a FLOATING_CONTAINER may be defined that attaches to a child or grandchild of this element, which is large enough to still
+                    // be on screen, even if this element isn't. That depends on this element and it's children being laid out correctly (even if they are entirely off screen)
+                }
+            }
+
+            // Setup initial on-axis alignment
+            if (!Clay__ElementHasConfig(currentElementTreeNode->layoutElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT)) {
+                Clay_Dimensions contentSize = CLAY__INIT(Clay_Dimensions) {0,0};
+                if (layoutConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) {
+                    for (int i = 0; i < currentElement->children.length; ++i) {
+                        Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->children.elements[i]);
+                        contentSize.width += childElement->dimensions.width;
+                        contentSize.height = CLAY__MAX(contentSize.height, childElement->dimensions.height);
+                    }
+                    contentSize.width += (float)(CLAY__MAX(currentElement->children.length - 1, 0) * layoutConfig->childGap);
+                    float extraSpace = currentElement->dimensions.width - (float)layoutConfig->padding.x * 2 - contentSize.width;
+                    switch (layoutConfig->childAlignment.x) {
+                        case CLAY_ALIGN_X_LEFT: extraSpace = 0; break;
+                        case CLAY_ALIGN_X_CENTER: extraSpace /= 2; break;
+                        default: break;
+                    }
+                    currentElementTreeNode->nextChildOffset.x += extraSpace;
+                } else {
+                    for (int i = 0; i < currentElement->children.length; ++i) {
+                        Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->children.elements[i]);
+                        contentSize.width = CLAY__MAX(contentSize.width, childElement->dimensions.width);
+                        contentSize.height += childElement->dimensions.height;
+                    }
+                    contentSize.height += (float)(CLAY__MAX(currentElement->children.length - 1, 0) * layoutConfig->childGap);
+                    float extraSpace = currentElement->dimensions.height - (float)layoutConfig->padding.y * 2 - contentSize.height;
+                    switch (layoutConfig->childAlignment.y) {
+                        case CLAY_ALIGN_Y_TOP: extraSpace = 0; break;
+                        case CLAY_ALIGN_Y_CENTER: extraSpace /= 2; break;
+                        default: break;
+                    }
+                    currentElementTreeNode->nextChildOffset.y += extraSpace;
+                }
+
+                if (scrollContainerData) {
+                    scrollContainerData->contentSize = CLAY__INIT(Clay_Dimensions) { contentSize.width + layoutConfig->padding.x * 2, contentSize.height + layoutConfig->padding.y * 2 };
+                }
+            }
+        }
+        else {
+            // DFS is returning upwards backwards
+            bool closeScrollElement = false;
+            if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER)) {
+                closeScrollElement = true;
+                Clay_ScrollElementConfig *scrollConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER).scrollElementConfig;
+                Clay__ScrollContainerDataInternal *mapping = Clay__GetScrollContainerDataInternal(currentElement->id);
+                if (mapping && mapping->layoutElement == currentElement) {
+                    if (scrollConfig->horizontal) { scrollOffset.x = mapping->scrollPosition.x; }
+                    if (scrollConfig->vertical) { scrollOffset.y = mapping->scrollPosition.y; }
+                    if (context->externalScrollHandlingEnabled) {
+                        scrollOffset = CLAY__INIT(Clay_Vector2) {};
+                    }
+                }
+            }
+
+            if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_BORDER_CONTAINER)) {
+                Clay_LayoutElementHashMapItem *currentElementData = Clay__GetHashMapItem(currentElement->id);
+                Clay_BoundingBox currentElementBoundingBox = currentElementData->boundingBox;
+
+                // Culling - Don't bother to generate render commands for rectangles entirely outside the screen - this won't stop their children from being rendered if they overflow
+                if (!Clay__ElementIsOffscreen(&currentElementBoundingBox)) {
+                    Clay_BorderElementConfig *borderConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_BORDER_CONTAINER).borderElementConfig;
+                    Clay_RenderCommand renderCommand = CLAY__INIT(Clay_RenderCommand) {
+                            .boundingBox = currentElementBoundingBox,
+                            .config = { .borderElementConfig = borderConfig },
+                            .id = Clay__RehashWithNumber(currentElement->id, 4),
+                            .commandType = CLAY_RENDER_COMMAND_TYPE_BORDER,
+                    };
+                    Clay__AddRenderCommand(renderCommands, renderCommand);
+                    if (borderConfig->betweenChildren.width > 0 && borderConfig->betweenChildren.color.a > 0) {
+                        Clay_RectangleElementConfig *rectangleConfig = Clay__RectangleElementConfigArray_Add(rectangleConfigs, CLAY__INIT(Clay_RectangleElementConfig) {.color = borderConfig->betweenChildren.color});
+                        Clay_Vector2 borderOffset = { (float)layoutConfig->padding.x, (float)layoutConfig->padding.y };
+                        if (layoutConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) {
+                            for (int i = 0; i < currentElement->children.length; ++i) {
+                                Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->children.elements[i]);
+                                if (i > 0) {
+                                    Clay__AddRenderCommand(renderCommands, CLAY__INIT(Clay_RenderCommand) {
+                                        .boundingBox = { currentElementBoundingBox.x + borderOffset.x + scrollOffset.x, currentElementBoundingBox.y + scrollOffset.y, (float)borderConfig->betweenChildren.width, currentElement->dimensions.height },
+                                        .config = { rectangleConfig },
+                                        .id = Clay__RehashWithNumber(currentElement->id, 5 + i),
+                                        .commandType = CLAY_RENDER_COMMAND_TYPE_RECTANGLE,
+                                    });
+                                }
+                                borderOffset.x += (childElement->dimensions.width + (float)layoutConfig->childGap / 2);
+                            }
+                        } else {
+                            for (int i = 0; i < currentElement->children.length; ++i) {
+                                Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->children.elements[i]);
+                                if (i > 0) {
+                                    Clay__AddRenderCommand(renderCommands, CLAY__INIT(Clay_RenderCommand) {
+                                            .boundingBox = { currentElementBoundingBox.x + scrollOffset.x, currentElementBoundingBox.y + borderOffset.y + scrollOffset.y, currentElement->dimensions.width, (float)borderConfig->betweenChildren.width },
+                                            .config = { rectangleConfig },
+                                            .id = Clay__RehashWithNumber(currentElement->id, 5 + i),
+                                            .commandType = CLAY_RENDER_COMMAND_TYPE_RECTANGLE,
+                                    });
+                                }
+                                borderOffset.y += (childElement->dimensions.height + (float)layoutConfig->childGap / 2);
+                            }
+                        }
+                    }
+                }
+            }
+            // This exists because the scissor needs to end _after_ borders between elements
+            if (closeScrollElement) {
+                Clay__AddRenderCommand(renderCommands, CLAY__INIT(Clay_RenderCommand) {
+                    .id = Clay__RehashWithNumber(currentElement->id, 11),
+                   .commandType = CLAY_RENDER_COMMAND_TYPE_SCISSOR_END,
+                });
+            }
+
+            dfsBuffer.length--;
+            continue;
+        }
+
+        // Add children to the DFS buffer
+        if (!Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT)) {
+            dfsBuffer.length += currentElement->children.length;
+            for (int i = 0; i < currentElement->children.length; ++i) {
+                Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->children.elements[i]);
+                // Alignment along non layout axis
+                if (layoutConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) {
+                    currentElementTreeNode->nextChildOffset.y = currentElement->layoutConfig->padding.y;
+                    float whiteSpaceAroundChild = currentElement->dimensions.height - (float)currentElement->layoutConfig->padding.y * 2 - childElement->dimensions.height;
+                    switch (layoutConfig->childAlignment.y) {
+                        case CLAY_ALIGN_Y_TOP: break;
+                        case CLAY_ALIGN_Y_CENTER: currentElementTreeNode->nextChildOffset.y += whiteSpaceAroundChild / 2; break;
+                        case CLAY_ALIGN_Y_BOTTOM: currentElementTreeNode->nextChildOffset.y += whiteSpaceAroundChild; break;
+                    }
+                } else {
+                    currentElementTreeNode->nextChildOffset.x = currentElement->layoutConfig->padding.x;
+                    float whiteSpaceAroundChild = currentElement->dimensions.width - (float)currentElement->layoutConfig->padding.x * 2 - childElement->dimensions.width;
+                    switch (layoutConfig->childAlignment.x) {
+                        case CLAY_ALIGN_X_LEFT: break;
+                        case CLAY_ALIGN_X_CENTER: currentElementTreeNode->nextChildOffset.x += whiteSpaceAroundChild / 2; break;
+                        case CLAY_ALIGN_X_RIGHT: currentElementTreeNode->nextChildOffset.x += whiteSpaceAroundChild; break;
+                    }
+                }
+
+                Clay_Vector2 childPosition = CLAY__INIT(Clay_Vector2) {
+                    currentElementTreeNode->position.x + currentElementTreeNode->nextChildOffset.x + scrollOffset.x,
+                    currentElementTreeNode->position.y + currentElementTreeNode->nextChildOffset.y + scrollOffset.y,
+                };
+
+                // DFS buffer elements need to be added in reverse because stack traversal happens backwards
+                uint32_t newNodeIndex = dfsBuffer.length - 1 - i;
+                dfsBuffer.internalArray[newNodeIndex] = CLAY__INIT(Clay__LayoutElementTreeNode) {
+                    .layoutElement = childElement,
+                    .position = CLAY__INIT(Clay_Vector2) { childPosition.x, childPosition.y },
+                    .nextChildOffset = CLAY__INIT(Clay_Vector2) { .x = (float)childElement->layoutConfig->padding.x, .y = (float)childElement->layoutConfig->padding.y },
+                };
+                treeNodeVisited[newNodeIndex] = false;
+
+                // Update parent offsets
+                if (layoutConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) {
+                    currentElementTreeNode->nextChildOffset.x += childElement->dimensions.width + (float)layoutConfig->childGap;
+                } else {
+                    currentElementTreeNode->nextChildOffset.y += childElement->dimensions.height + (float)layoutConfig->childGap;
+                }
+            }
+        }
+    }
+
+    if (root->clipElementId) {
+        Clay__AddRenderCommand(renderCommands, CLAY__INIT(Clay_RenderCommand) { .id = Clay__RehashWithNumber(rootElement->id, 11), .commandType = CLAY_RENDER_COMMAND_TYPE_SCISSOR_END });
+    }
+    for (uint32_t i = firstRenderCommandIndex; i < renderCommands->length; ++i) {
+        renderCommands->internalArray[i].zIndex = root->zIndex;
+    }
+}
+
+int32_t Clay__GetElementRootIndex(uint32_t elementId, Clay__int32_tArray *elementRootIndexes) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_LayoutElementHashMapItem *hashMapItem = Clay__GetHashMapItem(elementId);
+    if (elementId == 0 || !hashMapItem->layoutElement) {
+        return 0;
+    }
+    // The hash map can still reference an element from a previous frame, which isn't part of any root this frame
+    int32_t elementIndex = (int32_t)(hashMapItem->layoutElement - context->layoutElements.internalArray);
+    if (elementIndex < 0 || elementIndex >= (int32_t)elementRootIndexes->length || hashMapItem->layoutElement->id != elementId) {
+        return 0;
+    }
+    return Clay__int32_tArray_Get(elementRootIndexes, elementIndex);
+}
+
+// Floating roots can only be laid out in parallel if everything they are positioned relative to belongs to the main root
+bool Clay__RootCanLayoutInParallel(Clay__LayoutElementTreeRoot *root, Clay__int32_tArray *elementRootIndexes) {
+    return Clay__GetElementRootIndex(root->parentId, elementRootIndexes) == 0 && Clay__GetElementRootIndex(root->clipElementId, elementRootIndexes) == 0;
+}
+
+void Clay__CalculateRootLayoutInRegion(Clay__LayoutElementTreeRoot *root, Clay_ScrollElementConfig *rootClipConfig) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__LayoutElementTreeNodeArray dfsBuffer = CLAY__INIT(Clay__LayoutElementTreeNodeArray) { .capacity = root->dfsBufferCapacity, .internalArray = context->layoutElementTreeNodeArray1.internalArray + root->dfsBufferOffset };
+    Clay_RenderCommandArray renderCommands = CLAY__INIT(Clay_RenderCommandArray) { .capacity = root->renderCommandsCapacity, .internalArray = context->renderCommands.internalArray + root->renderCommandsOffset };
+    Clay__RectangleElementConfigArray rectangleConfigs = CLAY__INIT(Clay__RectangleElementConfigArray) { .capacity = root->rectangleConfigsCapacity, .internalArray = context->rectangleElementConfigs.internalArray + root->rectangleConfigsOffset };
+    Clay__CalculateRootLayout(root, dfsBuffer, context->treeNodeVisited.internalArray + root->dfsBufferOffset, &renderCommands, &rectangleConfigs, rootClipConfig);
+    root->renderCommandsLength = renderCommands.length;
+}
+
+typedef struct
+{
+    Clay_Context *context;
+    Clay__int32_tArray rootIndexes;
+    Clay_ScrollElementConfig *rootClipConfig;
+} Clay__ParallelRootLayoutJobs;
+
+void Clay__ParallelRootLayoutJob(void *jobData, int32_t jobIndex) {
+    Clay__ParallelRootLayoutJobs *jobs = (Clay__ParallelRootLayoutJobs *)jobData;
+    // Jobs can run on any thread, so the context has to be made current here
+    Clay_Context* previousContext = Clay_GetCurrentContext();
+    Clay_SetCurrentContext(jobs->context);
+    int32_t rootIndex = Clay__int32_tArray_Get(&jobs->rootIndexes, jobIndex);
+    Clay__CalculateRootLayoutInRegion(Clay__LayoutElementTreeRootArray_Get(&jobs->context->layoutElementTreeRoots, rootIndex), jobs->rootClipConfig);
+    Clay_SetCurrentContext(previousContext);
+}
+
+// Lays out the main root first, then hands floating roots that only depend on the main root to the parallel layout handler.
+// Each root writes into its own region of the render command array, and the regions are compacted back together in root order afterwards.
+// Returns false if the layout should be done sequentially instead.
+bool Clay__CalculateRootLayoutsParallel(Clay_ScrollElementConfig *rootClipConfig) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (!context->parallelLayoutHandler.parallelForFunction || context->layoutElementTreeRoots.length < 3) {
+        return false;
+    }
+    // Work out an upper bound for the scratch memory and render commands each root can use, and which root each element belongs to
+    Clay__int32_tArray elementRootIndexes = context->reusableElementIndexBuffer;
+    elementRootIndexes.length = context->layoutElements.length;
+    Clay__int32_tArray dfsStack = context->layoutElementChildrenBuffer;
+    uint32_t dfsBufferOffset = 0;
+    uint32_t renderCommandsOffset = 0;
+    uint32_t rectangleConfigsOffset = context->rectangleElementConfigs.length;
+    for (int32_t rootIndex = 0; rootIndex < (int32_t)context->layoutElementTreeRoots.length; ++rootIndex) {
+        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
+        uint32_t elementCount = 0;
+        uint32_t renderCommandCount = 2; // Scissor start and end if the root is clipped
+        uint32_t rectangleConfigCount = 0;
+        dfsStack.length = 0;
+        Clay__int32_tArray_Add(&dfsStack, (int32_t)root->layoutElementIndex);
+        while (dfsStack.length > 0) {
+            int32_t elementIndex = Clay__int32_tArray_Get(&dfsStack, (int)dfsStack.length - 1);
+            dfsStack.length--;
+            Clay__int32_tArray_Set(&elementRootIndexes, elementIndex, rootIndex);
+            Clay_LayoutElement *element = Clay_LayoutElementArray_Get(&context->layoutElements, elementIndex);
+            elementCount++;
+            renderCommandCount += element->elementConfigs.length + 1;
+            if (Clay__ElementHasConfig(element, CLAY__ELEMENT_CONFIG_TYPE_TEXT)) {
+                renderCommandCount += element->textElementData->wrappedLines.length;
+                continue;
+            }
+            // Borders produce one command plus one rectangle between each pair of children
+            renderCommandCount += element->children.length;
+            if (Clay__ElementHasConfig(element, CLAY__ELEMENT_CONFIG_TYPE_BORDER_CONTAINER)) {
+                rectangleConfigCount++;
+            }
+            for (int i = 0; i < element->children.length; ++i) {
+                Clay__int32_tArray_Add(&dfsStack, element->children.elements[i]);
+            }
+        }
+        root->dfsBufferOffset = dfsBufferOffset;
+        root->dfsBufferCapacity = elementCount;
+        root->renderCommandsOffset = renderCommandsOffset;
+        root->renderCommandsCapacity = renderCommandCount + 1; // Clay__AddRenderCommand always leaves one free slot
+        root->renderCommandsLength = 0;
+        root->rectangleConfigsOffset = rectangleConfigsOffset;
+        root->rectangleConfigsCapacity = rectangleConfigCount;
+        dfsBufferOffset += root->dfsBufferCapacity;
+        renderCommandsOffset += root->renderCommandsCapacity;
+        rectangleConfigsOffset += root->rectangleConfigsCapacity;
+    }
+    if (renderCommandsOffset > context->renderCommands.capacity || rectangleConfigsOffset > context->rectangleElementConfigs.capacity) {
+        return false;
+    }
+
+    Clay__ParallelRootLayoutJobs jobs = CLAY__INIT(Clay__ParallelRootLayoutJobs) { .context = context, .rootIndexes = context->openClipElementStack, .rootClipConfig = rootClipConfig };
+    jobs.rootIndexes.length = 0;
+    for (int32_t rootIndex = 1; rootIndex < (int32_t)context->layoutElementTreeRoots.length; ++rootIndex) {
+        if (Clay__RootCanLayoutInParallel(Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex), &elementRootIndexes)) {
+            Clay__int32_tArray_Add(&jobs.rootIndexes, rootIndex);
+        }
+    }
+    if (jobs.rootIndexes.length < 2) {
+        return false;
+    }
+
+    Clay__CalculateRootLayoutInRegion(Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, 0), rootClipConfig);
+    context->parallelLayoutHandler.parallelForFunction(Clay__ParallelRootLayoutJob, &jobs, (int32_t)jobs.rootIndexes.length, context->parallelLayoutHandler.userData);
+    // Roots attached to other floating roots are laid out afterwards, in declaration order
+    for (int32_t rootIndex = 1; rootIndex < (int32_t)context->layoutElementTreeRoots.length; ++rootIndex) {
+        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
+        if (!Clay__RootCanLayoutInParallel(root, &elementRootIndexes)) {
+            Clay__CalculateRootLayoutInRegion(root, rootClipConfig);
+        }
+    }
+
+    // Merge the per root regions, regions only ever move towards the start of the array so this is safe in place
+    context->renderCommands.length = 0;
+    for (int32_t rootIndex = 0; rootIndex < (int32_t)context->layoutElementTreeRoots.length; ++rootIndex) {
+        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
+        uint32_t mergedOffset = context->renderCommands.length;
+        for (int32_t i = 0; i < (int32_t)root->renderCommandsLength; ++i) {
+            context->renderCommands.internalArray[context->renderCommands.length++] = context->renderCommands.internalArray[root->renderCommandsOffset + i];
+        }
+        root->renderCommandsOffset = mergedOffset;
+    }
+    context->rectangleElementConfigs.length = rectangleConfigsOffset;
+    return true;
+}
+
+// A stable radix sort over the 16 bit zIndex, one pass per byte, so that roots with the same zIndex stay in declaration order.
+// The main layout tree has a zIndex of 0 and is declared first, so it always stays at index 0.
+// Returns false if the roots were already in order.
+bool Clay__SortLayoutElementTreeRootsByZIndex(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__LayoutElementTreeRoot *roots = context->layoutElementTreeRoots.internalArray;
+    int32_t rootCount = (int32_t)context->layoutElementTreeRoots.length;
+    uint32_t zIndexBits = 0;
+    bool sorted = true;
+    for (int32_t i = 0; i < rootCount; ++i) {
+        zIndexBits |= roots[i].zIndex;
+        sorted = sorted && (i == 0 || roots[i - 1].zIndex <= roots[i].zIndex);
+    }
+    if (sorted) {
+        return false;
+    }
+    // Sort root indexes rather than the roots themselves, using two scratch arrays that aren't in use at this point in the frame
+    int32_t *order = context->openClipElementStack.internalArray;
+    int32_t *sortBuffer = context->reusableElementIndexBuffer.internalArray;
+    for (int32_t i = 0; i < rootCount; ++i) {
+        order[i] = i;
+    }
+    for (uint32_t shift = 0; shift < 16; shift += 8) {
+        if (((zIndexBits >> shift) & 0xFF) == 0) {
+            continue;
+        }
+        uint32_t offsets[256] = {0};
+        for (int32_t i = 0; i < rootCount; ++i) {
+            offsets[(roots[order[i]].zIndex >> shift) & 0xFF]++;
+        }
+        for (uint32_t digit = 0, total = 0; digit < 256; ++digit) {
+            uint32_t count = offsets[digit];
+            offsets[digit] = total;
+            total += count;
         }
+        for (int32_t i = 0; i < rootCount; ++i) {
+            sortBuffer[offsets[(roots[order[i]].zIndex >> shift) & 0xFF]++] = order[i];
+        }
+        int32_t *sortedOrder = sortBuffer;
+        sortBuffer = order;
+        order = sortedOrder;
+    }
+    // Move the roots into sorted order in place by following each cycle of the permutation
+    for (int32_t i = 0; i < rootCount; ++i) {
+        if (order[i] == i) {
+            continue;
+        }
+        Clay__LayoutElementTreeRoot firstRoot = roots[i];
+        int32_t current = i;
+        while (order[current] != i) {
+            int32_t next = order[current];
+            roots[current] = roots[next];
+            order[current] = current;
+            current = next;
+        }
+        roots[current] = firstRoot;
+        order[current] = current;
+    }
+    return true;
+}
+
+void Clay__ReverseRenderCommands(Clay_RenderCommand *commands, uint32_t start, uint32_t end) {
+    while (start + 1 < end) {
+        Clay_RenderCommand temp = commands[start];
+        commands[start++] = commands[--end];
+        commands[end] = temp;
     }
 }
 
-bool Clay__ElementIsOffscreen(Clay_BoundingBox *boundingBox) {
-    if (Clay__disableCulling) {
-        return false;
+// Roots are positioned in declaration order, because a floating root reads the final box of the element it's attached to, which can belong
+// to an earlier floating root with a higher zIndex. Once every root is positioned the roots are sorted by zIndex, for the hit test walk,
+// and each root's render commands are moved into the same order by rotating them into place, which needs no scratch memory.
+void Clay__SortRenderCommandsByZIndex(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (!Clay__SortLayoutElementTreeRootsByZIndex()) {
+        return;
+    }
+    Clay__LayoutElementTreeRoot *roots = context->layoutElementTreeRoots.internalArray;
+    Clay_RenderCommand *commands = context->renderCommands.internalArray;
+    uint32_t sortedEnd = 0;
+    for (int32_t rootIndex = 0; rootIndex < (int32_t)context->layoutElementTreeRoots.length; ++rootIndex) {
+        Clay__LayoutElementTreeRoot *root = &roots[rootIndex];
+        uint32_t start = root->renderCommandsOffset;
+        uint32_t end = start + root->renderCommandsLength;
+        if (start != sortedEnd) {
+            Clay__ReverseRenderCommands(commands, sortedEnd, start);
+            Clay__ReverseRenderCommands(commands, start, end);
+            Clay__ReverseRenderCommands(commands, sortedEnd, end);
+            // The commands of roots that haven't been placed yet and were between the two positions moved along by this root's length
+            for (int32_t laterIndex = rootIndex + 1; laterIndex < (int32_t)context->layoutElementTreeRoots.length; ++laterIndex) {
+                if (roots[laterIndex].renderCommandsOffset >= sortedEnd && roots[laterIndex].renderCommandsOffset < start) {
+                    roots[laterIndex].renderCommandsOffset += root->renderCommandsLength;
+                }
+            }
+            root->renderCommandsOffset = sortedEnd;
+        }
+        sortedEnd += root->renderCommandsLength;
     }
-
-    return (boundingBox->x > (float)Clay__layoutDimensions.width) ||
-           (boundingBox->y > (float)Clay__layoutDimensions.height) ||
-           (boundingBox->x + boundingBox->width < 0) ||
-           (boundingBox->y + boundingBox->height < 0);
 }
 
 void Clay__CalculateFinalLayout() {
+    Clay_Context* context = Clay_GetCurrentContext();
     // Calculate sizing along the X axis
     Clay__SizeContainersAlongAxis(true);
 
     // Wrap text
-    for (int textElementIndex = 0; textElementIndex < Clay__textElementData.length; ++textElementIndex) {
-        Clay__TextElementData *textElementData = Clay__TextElementDataArray_Get(&Clay__textElementData, textElementIndex);
-        textElementData->wrappedLines = CLAY__INIT(Clay__WrappedTextLineArraySlice) { .length = 0, .internalArray = &Clay__wrappedTextLines.internalArray[Clay__wrappedTextLines.length] };
-        Clay_LayoutElement *containerElement = Clay_LayoutElementArray_Get(&Clay__layoutElements, (int)textElementData->elementIndex);
+    for (int32_t textElementIndex = 0; textElementIndex < (int32_t)context->textElementData.length; ++textElementIndex) {
+        Clay__TextElementData *textElementData = Clay__TextElementDataArray_Get(&context->textElementData, textElementIndex);
+        textElementData->wrappedLines = CLAY__INIT(Clay__WrappedTextLineArraySlice) { .length = 0, .internalArray = &context->wrappedTextLines.internalArray[context->wrappedTextLines.length] };
+        Clay_LayoutElement *containerElement = Clay_LayoutElementArray_Get(&context->layoutElements, (int)textElementData->elementIndex);
         Clay_TextElementConfig *textConfig = Clay__FindElementConfigWithType(containerElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT).textElementConfig;
         Clay__MeasureTextCacheItem *measureTextCacheItem = Clay__MeasureTextCached(&textElementData->text, textConfig);
         float lineWidth = 0;
@@ -2372,26 +4823,37 @@ void Clay__CalculateFinalLayout() {
         uint32_t lineLengthChars = 0;
         uint32_t lineStartOffset = 0;
         if (textElementData->preferredDimensions.width <= containerElement->dimensions.width) {
-            Clay__WrappedTextLineArray_Add(&Clay__wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { containerElement->dimensions,  textElementData->text });
+            Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { containerElement->dimensions,  textElementData->text });
             textElementData->wrappedLines.length++;
             continue;
         }
+        if (measureTextCacheItem->wrappedLinesStartIndex != -1 && measureTextCacheItem->wrappedWidth == containerElement->dimensions.width) {
+            int32_t lineIndex = measureTextCacheItem->wrappedLinesStartIndex;
+            while (lineIndex != -1 && context->wrappedTextLines.length < context->wrappedTextLines.capacity) {
+                Clay__MeasuredWord *cachedLine = Clay__MeasuredWordArray_Get(&context->wrappedLineCache, lineIndex);
+                Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { CLAY__INIT(Clay_Dimensions) { cachedLine->width, lineHeight }, CLAY__INIT(Clay_String) { .length = (int)cachedLine->length, .chars = &textElementData->text.chars[cachedLine->startOffset] } });
+                textElementData->wrappedLines.length++;
+                lineIndex = cachedLine->next;
+            }
+            containerElement->dimensions.height = lineHeight * textElementData->wrappedLines.length;
+            continue;
+        }
         int32_t wordIndex = measureTextCacheItem->measuredWordsStartIndex;
         while (wordIndex != -1) {
-            if (Clay__wrappedTextLines.length > Clay__wrappedTextLines.capacity - 1) {
+            if (context->wrappedTextLines.length > context->wrappedTextLines.capacity - 1) {
                 break;
             }
-            Clay__MeasuredWord *measuredWord = Clay__MeasuredWordArray_Get(&Clay__measuredWords, wordIndex);
+            Clay__MeasuredWord *measuredWord = Clay__MeasuredWordArray_Get(&context->measuredWords, wordIndex);
             // Only word on the line is too large, just render it anyway
             if (lineLengthChars == 0 && lineWidth + measuredWord->width > containerElement->dimensions.width) {
-                Clay__WrappedTextLineArray_Add(&Clay__wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { CLAY__INIT(Clay_Dimensions) { measuredWord->width, lineHeight }, CLAY__INIT(Clay_String){ .length = (int)measuredWord->length, .chars = &textElementData->text.chars[measuredWord->startOffset] } });
+                Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { CLAY__INIT(Clay_Dimensions) { measuredWord->width, lineHeight }, CLAY__INIT(Clay_String){ .length = (int)measuredWord->length, .chars = &textElementData->text.chars[measuredWord->startOffset] } });
                 textElementData->wrappedLines.length++;
                 wordIndex = measuredWord->next;
             }
             // measuredWord->length == 0 means a newline character
             else if (measuredWord->length == 0 || lineWidth + measuredWord->width > containerElement->dimensions.width) {
                 // Wrapped text lines list has overflowed, just render out the line
-                Clay__WrappedTextLineArray_Add(&Clay__wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { CLAY__INIT(Clay_Dimensions) { lineWidth, lineHeight }, CLAY__INIT(Clay_String){ .length = (int)lineLengthChars, .chars = &textElementData->text.chars[lineStartOffset] } });
+                Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { CLAY__INIT(Clay_Dimensions) { lineWidth, lineHeight }, CLAY__INIT(Clay_String){ .length = (int)lineLengthChars, .chars = &textElementData->text.chars[lineStartOffset] } });
                 textElementData->wrappedLines.length++;
                 if (lineLengthChars == 0 || measuredWord->length == 0) {
                     wordIndex = measuredWord->next;
@@ -2406,32 +4868,35 @@ void Clay__CalculateFinalLayout() {
             }
         }
         if (lineLengthChars > 0) {
-            Clay__WrappedTextLineArray_Add(&Clay__wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { CLAY__INIT(Clay_Dimensions) { lineWidth, lineHeight }, CLAY__INIT(Clay_String) {.length = (int)lineLengthChars, .chars = &textElementData->text.chars[lineStartOffset] } });
+            Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { CLAY__INIT(Clay_Dimensions) { lineWidth, lineHeight }, CLAY__INIT(Clay_String) {.length = (int)lineLengthChars, .chars = &textElementData->text.chars[lineStartOffset] } });
             textElementData->wrappedLines.length++;
         }
+        if (measureTextCacheItem != &CLAY__MEASURE_TEXT_CACHE_ITEM_DEFAULT && context->wrappedTextLines.length < context->wrappedTextLines.capacity) {
+            Clay__CacheWrappedLines(measureTextCacheItem, &textElementData->text, textElementData->wrappedLines, containerElement->dimensions.width);
+        }
         containerElement->dimensions.height = lineHeight * textElementData->wrappedLines.length;
     }
 
     // Scale vertical image heights according to aspect ratio
-    for (int i = 0; i < Clay__imageElementPointers.length; ++i) {
-        Clay_LayoutElement* imageElement = Clay__LayoutElementPointerArray_Get(&Clay__imageElementPointers, i);
+    for (int32_t i = 0; i < (int32_t)context->imageElementPointers.length; ++i) {
+        Clay_LayoutElement* imageElement = Clay__LayoutElementPointerArray_Get(&context->imageElementPointers, i);
         Clay_ImageElementConfig *config = Clay__FindElementConfigWithType(imageElement, CLAY__ELEMENT_CONFIG_TYPE_IMAGE).imageElementConfig;
         imageElement->dimensions.height = (config->sourceDimensions.height / CLAY__MAX(config->sourceDimensions.width, 1)) * imageElement->dimensions.width;
     }
 
     // Propagate effect of text wrapping, image aspect scaling etc. on height of parents
-    Clay__LayoutElementTreeNodeArray dfsBuffer = Clay__layoutElementTreeNodeArray1;
+    Clay__LayoutElementTreeNodeArray dfsBuffer = context->layoutElementTreeNodeArray1;
     dfsBuffer.length = 0;
-    for (int i = 0; i < Clay__layoutElementTreeRoots.length; ++i) {
-        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&Clay__layoutElementTreeRoots, i);
-        Clay__treeNodeVisited.internalArray[dfsBuffer.length] = false;
-        Clay__LayoutElementTreeNodeArray_Add(&dfsBuffer, CLAY__INIT(Clay__LayoutElementTreeNode) { .layoutElement = Clay_LayoutElementArray_Get(&Clay__layoutElements, (int)root->layoutElementIndex) });
+    for (int32_t i = 0; i < (int32_t)context->layoutElementTreeRoots.length; ++i) {
+        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, i);
+        context->treeNodeVisited.internalArray[dfsBuffer.length] = false;
+        Clay__LayoutElementTreeNodeArray_Add(&dfsBuffer, CLAY__INIT(Clay__LayoutElementTreeNode) { .layoutElement = Clay_LayoutElementArray_Get(&context->layoutElements, (int)root->layoutElementIndex) });
     }
     while (dfsBuffer.length > 0) {
         Clay__LayoutElementTreeNode *currentElementTreeNode = Clay__LayoutElementTreeNodeArray_Get(&dfsBuffer, (int)dfsBuffer.length - 1);
         Clay_LayoutElement *currentElement = currentElementTreeNode->layoutElement;
-        if (!Clay__treeNodeVisited.internalArray[dfsBuffer.length - 1]) {
-            Clay__treeNodeVisited.internalArray[dfsBuffer.length - 1] = true;
+        if (!context->treeNodeVisited.internalArray[dfsBuffer.length - 1]) {
+            context->treeNodeVisited.internalArray[dfsBuffer.length - 1] = true;
             // If the element has no children or is the container for a text element, don't bother inspecting it
             if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT) || currentElement->children.length == 0) {
                 dfsBuffer.length--;
@@ -2439,8 +4904,8 @@ void Clay__CalculateFinalLayout() {
             }
             // Add the children to the DFS buffer (needs to be pushed in reverse so that stack traversal is in correct layout order)
             for (int i = 0; i < currentElement->children.length; i++) {
-                Clay__treeNodeVisited.internalArray[dfsBuffer.length] = false;
-                Clay__LayoutElementTreeNodeArray_Add(&dfsBuffer, CLAY__INIT(Clay__LayoutElementTreeNode) { .layoutElement = Clay_LayoutElementArray_Get(&Clay__layoutElements, currentElement->children.elements[i]) });
+                context->treeNodeVisited.internalArray[dfsBuffer.length] = false;
+                Clay__LayoutElementTreeNodeArray_Add(&dfsBuffer, CLAY__INIT(Clay__LayoutElementTreeNode) { .layoutElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->children.elements[i]) });
             }
             continue;
         }
@@ -2454,7 +4919,7 @@ void Clay__CalculateFinalLayout() {
         if (layoutConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) {
             // Resize any parent containers that have grown in height along their non layout axis
             for (int j = 0; j < currentElement->children.length; ++j) {
-                Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&Clay__layoutElements, currentElement->children.elements[j]);
+                Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->children.elements[j]);
                 float childHeightWithPadding = CLAY__MAX(childElement->dimensions.height + layoutConfig->padding.y * 2, currentElement->dimensions.height);
                 currentElement->dimensions.height = CLAY__MIN(CLAY__MAX(childHeightWithPadding, layoutConfig->sizing.height.size.minMax.min), layoutConfig->sizing.height.size.minMax.max);
             }
@@ -2462,7 +4927,7 @@ void Clay__CalculateFinalLayout() {
             // Resizing along the layout axis
             float contentHeight = (float)layoutConfig->padding.y * 2;
             for (int j = 0; j < currentElement->children.length; ++j) {
-                Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&Clay__layoutElements, currentElement->children.elements[j]);
+                Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->children.elements[j]);
                 contentHeight += childElement->dimensions.height;
             }
             contentHeight += (float)(CLAY__MAX(currentElement->children.length - 1, 0) * layoutConfig->childGap);
@@ -2474,454 +4939,75 @@ void Clay__CalculateFinalLayout() {
     Clay__SizeContainersAlongAxis(false);
 
     // Calculate final positions and generate render commands
-    Clay__renderCommands.length = 0;
-    dfsBuffer.length = 0;
-    for (int rootIndex = 0; rootIndex < Clay__layoutElementTreeRoots.length; ++rootIndex) {
-        dfsBuffer.length = 0;
-        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&Clay__layoutElementTreeRoots, rootIndex);
-        Clay_LayoutElement *rootElement = Clay_LayoutElementArray_Get(&Clay__layoutElements, (int)root->layoutElementIndex);
-        Clay_Vector2 rootPosition = CLAY__INIT(Clay_Vector2) {};
-        Clay_LayoutElementHashMapItem *parentHashMapItem = Clay__GetHashMapItem(root->parentId);
-        // Position root floating containers
-        if (Clay__ElementHasConfig(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING_CONTAINER) && parentHashMapItem) {
-            Clay_FloatingElementConfig *config = Clay__FindElementConfigWithType(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING_CONTAINER).floatingElementConfig;
-            Clay_Dimensions rootDimensions = rootElement->dimensions;
-            Clay_BoundingBox parentBoundingBox = parentHashMapItem->boundingBox;
-            // Set X position
-            Clay_Vector2 targetAttachPosition = CLAY__INIT(Clay_Vector2){};
-            switch (config->attachment.parent) {
-                case CLAY_ATTACH_POINT_LEFT_TOP:
-                case CLAY_ATTACH_POINT_LEFT_CENTER:
-                case CLAY_ATTACH_POINT_LEFT_BOTTOM: targetAttachPosition.x = parentBoundingBox.x; break;
-                case CLAY_ATTACH_POINT_CENTER_TOP:
-                case CLAY_ATTACH_POINT_CENTER_CENTER:
-                case CLAY_ATTACH_POINT_CENTER_BOTTOM: targetAttachPosition.x = parentBoundingBox.x + (parentBoundingBox.width / 2); break;
-                case CLAY_ATTACH_POINT_RIGHT_TOP:
-                case CLAY_ATTACH_POINT_RIGHT_CENTER:
-                case CLAY_ATTACH_POINT_RIGHT_BOTTOM: targetAttachPosition.x = parentBoundingBox.x + parentBoundingBox.width; break;
-            }
-            switch (config->attachment.element) {
-                case CLAY_ATTACH_POINT_LEFT_TOP:
-                case CLAY_ATTACH_POINT_LEFT_CENTER:
-                case CLAY_ATTACH_POINT_LEFT_BOTTOM: break;
-                case CLAY_ATTACH_POINT_CENTER_TOP:
-                case CLAY_ATTACH_POINT_CENTER_CENTER:
-                case CLAY_ATTACH_POINT_CENTER_BOTTOM: targetAttachPosition.x -= (rootDimensions.width / 2); break;
-                case CLAY_ATTACH_POINT_RIGHT_TOP:
-                case CLAY_ATTACH_POINT_RIGHT_CENTER:
-                case CLAY_ATTACH_POINT_RIGHT_BOTTOM: targetAttachPosition.x -= rootDimensions.width; break;
-            }
-            switch (config->attachment.parent) { // I know I could merge the x and y switch statements, but this is easier to read
-                case CLAY_ATTACH_POINT_LEFT_TOP:
-                case CLAY_ATTACH_POINT_RIGHT_TOP:
-                case CLAY_ATTACH_POINT_CENTER_TOP: targetAttachPosition.y = parentBoundingBox.y; break;
-                case CLAY_ATTACH_POINT_LEFT_CENTER:
-                case CLAY_ATTACH_POINT_CENTER_CENTER:
-                case CLAY_ATTACH_POINT_RIGHT_CENTER: targetAttachPosition.y = parentBoundingBox.y + (parentBoundingBox.height / 2); break;
-                case CLAY_ATTACH_POINT_LEFT_BOTTOM:
-                case CLAY_ATTACH_POINT_CENTER_BOTTOM:
-                case CLAY_ATTACH_POINT_RIGHT_BOTTOM: targetAttachPosition.y = parentBoundingBox.y + parentBoundingBox.height; break;
-            }
-            switch (config->attachment.element) {
-                case CLAY_ATTACH_POINT_LEFT_TOP:
-                case CLAY_ATTACH_POINT_RIGHT_TOP:
-                case CLAY_ATTACH_POINT_CENTER_TOP: break;
-                case CLAY_ATTACH_POINT_LEFT_CENTER:
-                case CLAY_ATTACH_POINT_CENTER_CENTER:
-                case CLAY_ATTACH_POINT_RIGHT_CENTER: targetAttachPosition.y -= (rootDimensions.height / 2); break;
-                case CLAY_ATTACH_POINT_LEFT_BOTTOM:
-                case CLAY_ATTACH_POINT_CENTER_BOTTOM:
-                case CLAY_ATTACH_POINT_RIGHT_BOTTOM: targetAttachPosition.y -= rootDimensions.height; break;
-            }
-            targetAttachPosition.x += config->offset.x;
-            targetAttachPosition.y += config->offset.y;
-            rootPosition = targetAttachPosition;
-        }
-        if (root->clipElementId) {
-            Clay_LayoutElementHashMapItem *clipHashMapItem = Clay__GetHashMapItem(root->clipElementId);
-            if (clipHashMapItem) {
-                // Floating elements that are attached to scrolling contents won't be correctly positioned if external scroll handling is enabled, fix here
-                if (Clay__externalScrollHandlingEnabled) {
-                    Clay_ScrollElementConfig *scrollConfig = Clay__FindElementConfigWithType(clipHashMapItem->layoutElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER).scrollElementConfig;
-                    for (int i = 0; i < Clay__scrollContainerDatas.length; i++) {
-                        Clay__ScrollContainerDataInternal *mapping = Clay__ScrollContainerDataInternalArray_Get(&Clay__scrollContainerDatas, i);
-                        if (mapping->layoutElement == clipHashMapItem->layoutElement) {
-                            root->pointerOffset = mapping->scrollPosition;
-                            if (scrollConfig->horizontal) {
-                                rootPosition.x += mapping->scrollPosition.x;
-                            }
-                            if (scrollConfig->vertical) {
-                                rootPosition.y += mapping->scrollPosition.y;
-                            }
-                            break;
-                        }
-                    }
-                }
-                Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
-                    .boundingBox = clipHashMapItem->boundingBox,
-                    .config = { .scrollElementConfig = Clay__StoreScrollElementConfig(CLAY__INIT(Clay_ScrollElementConfig){}) },
-                    .id = Clay__RehashWithNumber(rootElement->id, 10), // TODO need a better strategy for managing derived ids
-                    .commandType = CLAY_RENDER_COMMAND_TYPE_SCISSOR_START,
-                });
-            }
-        }
-        Clay__LayoutElementTreeNodeArray_Add(&dfsBuffer, CLAY__INIT(Clay__LayoutElementTreeNode) { .layoutElement = rootElement, .position = rootPosition, .nextChildOffset = CLAY__INIT(Clay_Vector2) { .x = (float)rootElement->layoutConfig->padding.x, .y = (float)rootElement->layoutConfig->padding.y } });
-
-        Clay__treeNodeVisited.internalArray[0] = false;
-        while (dfsBuffer.length > 0) {
-            Clay__LayoutElementTreeNode *currentElementTreeNode = Clay__LayoutElementTreeNodeArray_Get(&dfsBuffer, (int)dfsBuffer.length - 1);
-            Clay_LayoutElement *currentElement = currentElementTreeNode->layoutElement;
-            Clay_LayoutConfig *layoutConfig = currentElement->layoutConfig;
-            Clay_Vector2 scrollOffset = {0};
-
-            // This will only be run a single time for each element in downwards DFS order
-            if (!Clay__treeNodeVisited.internalArray[dfsBuffer.length - 1]) {
-                Clay__treeNodeVisited.internalArray[dfsBuffer.length - 1] = true;
-
-                Clay_BoundingBox currentElementBoundingBox = CLAY__INIT(Clay_BoundingBox) { currentElementTreeNode->position.x, currentElementTreeNode->position.y, currentElement->dimensions.width, currentElement->dimensions.height };
-                if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING_CONTAINER)) {
-                    Clay_FloatingElementConfig *floatingElementConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING_CONTAINER).floatingElementConfig;
-                    Clay_Dimensions expand = floatingElementConfig->expand;
-                    currentElementBoundingBox.x -= expand.width;
-                    currentElementBoundingBox.width += expand.width * 2;
-                    currentElementBoundingBox.y -= expand.height;
-                    currentElementBoundingBox.height += expand.height * 2;
-                }
-
-                Clay__ScrollContainerDataInternal *scrollContainerData = CLAY__NULL;
-                // Apply scroll offsets to container
-                if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER)) {
-                    Clay_ScrollElementConfig *scrollConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER).scrollElementConfig;
-
-                    // This linear scan could theoretically be slow under very strange conditions, but I can't imagine a real UI with more than a few 10's of scroll containers
-                    for (int i = 0; i < Clay__scrollContainerDatas.length; i++) {
-                        Clay__ScrollContainerDataInternal *mapping = Clay__ScrollContainerDataInternalArray_Get(&Clay__scrollContainerDatas, i);
-                        if (mapping->layoutElement == currentElement) {
-                            scrollContainerData = mapping;
-                            mapping->boundingBox = currentElementBoundingBox;
-                            if (scrollConfig->horizontal) {
-                                scrollOffset.x = mapping->scrollPosition.x;
-                            }
-                            if (scrollConfig->vertical) {
-                                scrollOffset.y = mapping->scrollPosition.y;
-                            }
-                            if (Clay__externalScrollHandlingEnabled) {
-                                scrollOffset = CLAY__INIT(Clay_Vector2) {};
-                            }
-                            break;
-                        }
-                    }
-                }
-
-                Clay_LayoutElementHashMapItem *hashMapItem = Clay__GetHashMapItem(currentElement->id);
-                if (hashMapItem) {
-                    hashMapItem->boundingBox = currentElementBoundingBox;
-                }
-
-                int sortedConfigIndexes[20];
-                for (int elementConfigIndex = 0; elementConfigIndex < currentElement->elementConfigs.length; ++elementConfigIndex) {
-                    sortedConfigIndexes[elementConfigIndex] = elementConfigIndex;
-                }
-                int sortMax = currentElement->elementConfigs.length - 1;
-                while (sortMax > 0) { // todo dumb bubble sort
-                    for (int i = 0; i < sortMax; ++i) {
-                        int current = sortedConfigIndexes[i];
-                        int next = sortedConfigIndexes[i + 1];
-                        Clay__ElementConfigType currentType = Clay__ElementConfigArraySlice_Get(&currentElement->elementConfigs, current)->type;
-                        Clay__ElementConfigType nextType = Clay__ElementConfigArraySlice_Get(&currentElement->elementConfigs, next)->type;
-                        if (nextType == CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER || currentType == CLAY__ELEMENT_CONFIG_TYPE_BORDER_CONTAINER) {
-                            sortedConfigIndexes[i] = next;
-                            sortedConfigIndexes[i + 1] = current;
-                        }
-                    }
-                    sortMax--;
-                }
-
-                // Create the render commands for this element
-                for (int elementConfigIndex = 0; elementConfigIndex < currentElement->elementConfigs.length; ++elementConfigIndex) {
-                    Clay_ElementConfig *elementConfig = Clay__ElementConfigArraySlice_Get(&currentElement->elementConfigs, sortedConfigIndexes[elementConfigIndex]);
-                    Clay_RenderCommand renderCommand = CLAY__INIT(Clay_RenderCommand) {
-                        .boundingBox = currentElementBoundingBox,
-                        .config = elementConfig->config,
-                        .id = currentElement->id,
-                    };
-
-                    bool offscreen = Clay__ElementIsOffscreen(&currentElementBoundingBox);
-                    // Culling - Don't bother to generate render commands for rectangles entirely outside the screen - this won't stop their children from being rendered if they overflow
-                    bool shouldRender = !offscreen;
-                    switch (elementConfig->type) {
-                        case CLAY__ELEMENT_CONFIG_TYPE_RECTANGLE: {
-                            renderCommand.commandType = CLAY_RENDER_COMMAND_TYPE_RECTANGLE;
-                            break;
-                        }
-                        case CLAY__ELEMENT_CONFIG_TYPE_BORDER_CONTAINER: {
-                            shouldRender = false;
-                            break;
-                        }
-                        case CLAY__ELEMENT_CONFIG_TYPE_FLOATING_CONTAINER: {
-                            renderCommand.commandType = CLAY_RENDER_COMMAND_TYPE_NONE;
-                            shouldRender = false;
-                            break;
-                        }
-                        case CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER: {
-                            renderCommand.commandType = CLAY_RENDER_COMMAND_TYPE_SCISSOR_START;
-                            shouldRender = true;
-                            break;
-                        }
-                        case CLAY__ELEMENT_CONFIG_TYPE_IMAGE: {
-                            renderCommand.commandType = CLAY_RENDER_COMMAND_TYPE_IMAGE;
-                            break;
-                        }
-                        case CLAY__ELEMENT_CONFIG_TYPE_TEXT: {
-                            if (!shouldRender) {
-                                break;
-                            }
-                            shouldRender = false;
-                            Clay_ElementConfigUnion configUnion = elementConfig->config;
-                            Clay_TextElementConfig *textElementConfig = configUnion.textElementConfig;
-                            float naturalLineHeight = currentElement->textElementData->preferredDimensions.height;
-                            float finalLineHeight = textElementConfig->lineHeight > 0 ? textElementConfig->lineHeight : naturalLineHeight;
-                            float lineHeightOffset = (finalLineHeight - naturalLineHeight) / 2;
-                            float yPosition = lineHeightOffset;
-                            for (int lineIndex = 0; lineIndex < currentElement->textElementData->wrappedLines.length; ++lineIndex) {
-                                Clay__WrappedTextLine wrappedLine = currentElement->textElementData->wrappedLines.internalArray[lineIndex]; // todo range check
-                                if (wrappedLine.line.length == 0) {
-                                    yPosition += finalLineHeight;
-                                    continue;
-                                }
-                                Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
-                                    .boundingBox = { currentElementBoundingBox.x, currentElementBoundingBox.y + yPosition, wrappedLine.dimensions.width, wrappedLine.dimensions.height }, // TODO width
-                                    .config = configUnion,
-                                    .text = wrappedLine.line,
-                                    .id = Clay__HashNumber(lineIndex, currentElement->id).id,
-                                    .commandType = CLAY_RENDER_COMMAND_TYPE_TEXT,
-                                });
-                                yPosition += finalLineHeight;
-
-                                if (!Clay__disableCulling && (currentElementBoundingBox.y + yPosition > Clay__layoutDimensions.height)) {
-                                    break;
-                                }
-                            }
-                            break;
-                        }
-                        case CLAY__ELEMENT_CONFIG_TYPE_CUSTOM: {
-                            renderCommand.commandType = CLAY_RENDER_COMMAND_TYPE_CUSTOM;
-                            break;
-                        }
-                        default: break;
-                    }
-                    if (shouldRender) {
-                        Clay__AddRenderCommand(renderCommand);
-                    }
-                    if (offscreen) {
-                        // NOTE: You may be tempted to try an early return / continue if an element is off screen. Why bother calculating layout for its children, right?
-                        // Unfortunately, a FLOATING_CONTAINER may be defined that attaches to a child or grandchild of this element, which is large enough to still
-                        // be on screen, even if this element isn't. That depends on this element and it's children being laid out correctly (even if they are entirely off screen)
-                    }
-                }
-
-                // Setup initial on-axis alignment
-                if (!Clay__ElementHasConfig(currentElementTreeNode->layoutElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT)) {
-                    Clay_Dimensions contentSize = CLAY__INIT(Clay_Dimensions) {0,0};
-                    if (layoutConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) {
-                        for (int i = 0; i < currentElement->children.length; ++i) {
-                            Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&Clay__layoutElements, currentElement->children.elements[i]);
-                            contentSize.width += childElement->dimensions.width;
-                            contentSize.height = CLAY__MAX(contentSize.height, childElement->dimensions.height);
-                        }
-                        contentSize.width += (float)(CLAY__MAX(currentElement->children.length - 1, 0) * layoutConfig->childGap);
-                        float extraSpace = currentElement->dimensions.width - (float)layoutConfig->padding.x * 2 - contentSize.width;
-                        switch (layoutConfig->childAlignment.x) {
-                            case CLAY_ALIGN_X_LEFT: extraSpace = 0; break;
-                            case CLAY_ALIGN_X_CENTER: extraSpace /= 2; break;
-                            default: break;
-                        }
-                        currentElementTreeNode->nextChildOffset.x += extraSpace;
-                    } else {
-                        for (int i = 0; i < currentElement->children.length; ++i) {
-                            Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&Clay__layoutElements, currentElement->children.elements[i]);
-                            contentSize.width = CLAY__MAX(contentSize.width, childElement->dimensions.width);
-                            contentSize.height += childElement->dimensions.height;
-                        }
-                        contentSize.height += (float)(CLAY__MAX(currentElement->children.length - 1, 0) * layoutConfig->childGap);
-                        float extraSpace = currentElement->dimensions.height - (float)layoutConfig->padding.y * 2 - contentSize.height;
-                        switch (layoutConfig->childAlignment.y) {
-                            case CLAY_ALIGN_Y_TOP: extraSpace = 0; break;
-                            case CLAY_ALIGN_Y_CENTER: extraSpace /= 2; break;
-                            default: break;
-                        }
-                        currentElementTreeNode->nextChildOffset.y += extraSpace;
-                    }
-
-                    if (scrollContainerData) {
-                        scrollContainerData->contentSize = CLAY__INIT(Clay_Dimensions) { contentSize.width + layoutConfig->padding.x * 2, contentSize.height + layoutConfig->padding.y * 2 };
-                    }
-                }
-            }
-            else {
-                // DFS is returning upwards backwards
-                bool closeScrollElement = false;
-                if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER)) {
-                    closeScrollElement = true;
-                    Clay_ScrollElementConfig *scrollConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER).scrollElementConfig;
-                    for (int i = 0; i < Clay__scrollContainerDatas.length; i++) {
-                        Clay__ScrollContainerDataInternal *mapping = Clay__ScrollContainerDataInternalArray_Get(&Clay__scrollContainerDatas, i);
-                        if (mapping->layoutElement == currentElement) {
-                            if (scrollConfig->horizontal) { scrollOffset.x = mapping->scrollPosition.x; }
-                            if (scrollConfig->vertical) { scrollOffset.y = mapping->scrollPosition.y; }
-                            if (Clay__externalScrollHandlingEnabled) {
-                                scrollOffset = CLAY__INIT(Clay_Vector2) {};
-                            }
-                            break;
-                        }
-                    }
-                }
-
-                if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_BORDER_CONTAINER)) {
-                    Clay_LayoutElementHashMapItem *currentElementData = Clay__GetHashMapItem(currentElement->id);
-                    Clay_BoundingBox currentElementBoundingBox = currentElementData->boundingBox;
-
-                    // Culling - Don't bother to generate render commands for rectangles entirely outside the screen - this won't stop their children from being rendered if they overflow
-                    if (!Clay__ElementIsOffscreen(&currentElementBoundingBox)) {
-                        Clay_BorderElementConfig *borderConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_BORDER_CONTAINER).borderElementConfig;
-                        Clay_RenderCommand renderCommand = CLAY__INIT(Clay_RenderCommand) {
-                                .boundingBox = currentElementBoundingBox,
-                                .config = { .borderElementConfig = borderConfig },
-                                .id = Clay__RehashWithNumber(currentElement->id, 4),
-                                .commandType = CLAY_RENDER_COMMAND_TYPE_BORDER,
-                        };
-                        Clay__AddRenderCommand(renderCommand);
-                        if (borderConfig->betweenChildren.width > 0 && borderConfig->betweenChildren.color.a > 0) {
-                            Clay_RectangleElementConfig *rectangleConfig = Clay__StoreRectangleElementConfig(CLAY__INIT(Clay_RectangleElementConfig) {.color = borderConfig->betweenChildren.color});
-                            Clay_Vector2 borderOffset = { (float)layoutConfig->padding.x, (float)layoutConfig->padding.y };
-                            if (layoutConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) {
-                                for (int i = 0; i < currentElement->children.length; ++i) {
-                                    Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&Clay__layoutElements, currentElement->children.elements[i]);
-                                    if (i > 0) {
-                                        Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
-                                            .boundingBox = { currentElementBoundingBox.x + borderOffset.x + scrollOffset.x, currentElementBoundingBox.y + scrollOffset.y, (float)borderConfig->betweenChildren.width, currentElement->dimensions.height },
-                                            .config = { rectangleConfig },
-                                            .id = Clay__RehashWithNumber(currentElement->id, 5 + i),
-                                            .commandType = CLAY_RENDER_COMMAND_TYPE_RECTANGLE,
-                                        });
-                                    }
-                                    borderOffset.x += (childElement->dimensions.width + (float)layoutConfig->childGap / 2);
-                                }
-                            } else {
-                                for (int i = 0; i < currentElement->children.length; ++i) {
-                                    Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&Clay__layoutElements, currentElement->children.elements[i]);
-                                    if (i > 0) {
-                                        Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
-                                                .boundingBox = { currentElementBoundingBox.x + scrollOffset.x, currentElementBoundingBox.y + borderOffset.y + scrollOffset.y, currentElement->dimensions.width, (float)borderConfig->betweenChildren.width },
-                                                .config = { rectangleConfig },
-                                                .id = Clay__RehashWithNumber(currentElement->id, 5 + i),
-                                                .commandType = CLAY_RENDER_COMMAND_TYPE_RECTANGLE,
-                                        });
-                                    }
-                                    borderOffset.y += (childElement->dimensions.height + (float)layoutConfig->childGap / 2);
-                                }
-                            }
-                        }
-                    }
-                }
-                // This exists because the scissor needs to end _after_ borders between elements
-                if (closeScrollElement) {
-                    Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
-                        .id = Clay__RehashWithNumber(currentElement->id, 11),
-                       .commandType = CLAY_RENDER_COMMAND_TYPE_SCISSOR_END,
-                    });
-                }
-
-                dfsBuffer.length--;
-                continue;
-            }
-
-            // Add children to the DFS buffer
-            if (!Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT)) {
-                dfsBuffer.length += currentElement->children.length;
-                for (int i = 0; i < currentElement->children.length; ++i) {
-                    Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&Clay__layoutElements, currentElement->children.elements[i]);
-                    // Alignment along non layout axis
-                    if (layoutConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) {
-                        currentElementTreeNode->nextChildOffset.y = currentElement->layoutConfig->padding.y;
-                        float whiteSpaceAroundChild = currentElement->dimensions.height - (float)currentElement->layoutConfig->padding.y * 2 - childElement->dimensions.height;
-                        switch (layoutConfig->childAlignment.y) {
-                            case CLAY_ALIGN_Y_TOP: break;
-                            case CLAY_ALIGN_Y_CENTER: currentElementTreeNode->nextChildOffset.y += whiteSpaceAroundChild / 2; break;
-                            case CLAY_ALIGN_Y_BOTTOM: currentElementTreeNode->nextChildOffset.y += whiteSpaceAroundChild; break;
-                        }
-                    } else {
-                        currentElementTreeNode->nextChildOffset.x = currentElement->layoutConfig->padding.x;
-                        float whiteSpaceAroundChild = currentElement->dimensions.width - (float)currentElement->layoutConfig->padding.x * 2 - childElement->dimensions.width;
-                        switch (layoutConfig->childAlignment.x) {
-                            case CLAY_ALIGN_X_LEFT: break;
-                            case CLAY_ALIGN_X_CENTER: currentElementTreeNode->nextChildOffset.x += whiteSpaceAroundChild / 2; break;
-                            case CLAY_ALIGN_X_RIGHT: currentElementTreeNode->nextChildOffset.x += whiteSpaceAroundChild; break;
-                        }
-                    }
-
-                    Clay_Vector2 childPosition = CLAY__INIT(Clay_Vector2) {
-                        currentElementTreeNode->position.x + currentElementTreeNode->nextChildOffset.x + scrollOffset.x,
-                        currentElementTreeNode->position.y + currentElementTreeNode->nextChildOffset.y + scrollOffset.y,
-                    };
-
-                    // DFS buffer elements need to be added in reverse because stack traversal happens backwards
-                    uint32_t newNodeIndex = dfsBuffer.length - 1 - i;
-                    dfsBuffer.internalArray[newNodeIndex] = CLAY__INIT(Clay__LayoutElementTreeNode) {
-                        .layoutElement = childElement,
-                        .position = CLAY__INIT(Clay_Vector2) { childPosition.x, childPosition.y },
-                        .nextChildOffset = CLAY__INIT(Clay_Vector2) { .x = (float)childElement->layoutConfig->padding.x, .y = (float)childElement->layoutConfig->padding.y },
-                    };
-                    Clay__treeNodeVisited.internalArray[newNodeIndex] = false;
-
-                    // Update parent offsets
-                    if (layoutConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) {
-                        currentElementTreeNode->nextChildOffset.x += childElement->dimensions.width + (float)layoutConfig->childGap;
-                    } else {
-                        currentElementTreeNode->nextChildOffset.y += childElement->dimensions.height + (float)layoutConfig->childGap;
-                    }
-                }
-            }
-        }
-
-        if (root->clipElementId) {
-            Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) { .id = Clay__RehashWithNumber(rootElement->id, 11), .commandType = CLAY_RENDER_COMMAND_TYPE_SCISSOR_END });
+    context->renderCommands.length = 0;
+    Clay_ScrollElementConfig *rootClipConfig = Clay__StoreScrollElementConfig(CLAY__INIT(Clay_ScrollElementConfig){});
+    if (!Clay__CalculateRootLayoutsParallel(rootClipConfig)) {
+        for (int32_t rootIndex = 0; rootIndex < (int32_t)context->layoutElementTreeRoots.length; ++rootIndex) {
+            Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
+            root->renderCommandsOffset = context->renderCommands.length;
+            Clay__CalculateRootLayout(root, context->layoutElementTreeNodeArray1, context->treeNodeVisited.internalArray, &context->renderCommands, &context->rectangleElementConfigs, rootClipConfig);
+            root->renderCommandsLength = context->renderCommands.length - root->renderCommandsOffset;
         }
     }
+    Clay__SortRenderCommandsByZIndex();
 }
 
 void Clay__AttachId(Clay_ElementId elementId) {
-    if (Clay__booleanWarnings.maxElementsExceeded) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->booleanWarnings.maxElementsExceeded) {
         return;
     }
     Clay_LayoutElement *openLayoutElement = Clay__GetOpenLayoutElement();
     openLayoutElement->id = elementId.id;
     Clay__AddHashMapItem(elementId, openLayoutElement);
-    Clay__StringArray_Add(&Clay__layoutElementIdStrings, elementId.stringId);
+    Clay__StringArray_Add(&context->layoutElementIdStrings, elementId.stringId);
+    if (context->idleFrameSkippingEnabled) {
+        Clay__HashDeclaration(&elementId.id, sizeof(uint32_t));
+    }
 }
 
 void Clay__AttachLayoutConfig(Clay_LayoutConfig *config) {
-    if (Clay__booleanWarnings.maxElementsExceeded) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->booleanWarnings.maxElementsExceeded) {
         return;
     }
     Clay__GetOpenLayoutElement()->layoutConfig = config;
+    if (context->idleFrameSkippingEnabled) {
+        Clay__HashDeclaration(config, sizeof(Clay_LayoutConfig));
+    }
 }
 void Clay__AttachElementConfig(Clay_ElementConfigUnion config, Clay__ElementConfigType type) {
-    if (Clay__booleanWarnings.maxElementsExceeded) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->booleanWarnings.maxElementsExceeded) {
         return;
     }
     Clay_LayoutElement *openLayoutElement = Clay__GetOpenLayoutElement();
     openLayoutElement->elementConfigs.length++;
-    Clay__ElementConfigArray_Add(&Clay__elementConfigBuffer, CLAY__INIT(Clay_ElementConfig) { .type = type, .config = config });
+    Clay__ElementConfigArray_Add(&context->elementConfigBuffer, CLAY__INIT(Clay_ElementConfig) { .type = type, .config = config });
+    if (context->idleFrameSkippingEnabled) {
+        int32_t configSize = 0;
+        switch (type) {
+            case CLAY__ELEMENT_CONFIG_TYPE_RECTANGLE: configSize = sizeof(Clay_RectangleElementConfig); break;
+            case CLAY__ELEMENT_CONFIG_TYPE_BORDER_CONTAINER: configSize = sizeof(Clay_BorderElementConfig); break;
+            case CLAY__ELEMENT_CONFIG_TYPE_FLOATING_CONTAINER: configSize = sizeof(Clay_FloatingElementConfig); break;
+            case CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER: configSize = sizeof(Clay_ScrollElementConfig); break;
+            case CLAY__ELEMENT_CONFIG_TYPE_IMAGE: configSize = sizeof(Clay_ImageElementConfig); break;
+            case CLAY__ELEMENT_CONFIG_TYPE_TEXT: configSize = sizeof(Clay_TextElementConfig); break;
+            case CLAY__ELEMENT_CONFIG_TYPE_CUSTOM: configSize = sizeof(Clay_CustomElementConfig); break;
+        }
+        Clay__HashDeclaration(&type, sizeof(Clay__ElementConfigType));
+        Clay__HashDeclaration(&config, sizeof(Clay_ElementConfigUnion));
+        Clay__HashDeclaration(config.rectangleElementConfig, configSize);
+    }
 }
-Clay_LayoutConfig * Clay__StoreLayoutConfig(Clay_LayoutConfig config) {  return Clay__booleanWarnings.maxElementsExceeded ? &CLAY_LAYOUT_DEFAULT : Clay__LayoutConfigArray_Add(&Clay__layoutConfigs, config); }
-Clay_RectangleElementConfig * Clay__StoreRectangleElementConfig(Clay_RectangleElementConfig config) {  return Clay__booleanWarnings.maxElementsExceeded ? &CLAY__RECTANGLE_ELEMENT_CONFIG_DEFAULT : Clay__RectangleElementConfigArray_Add(&Clay__rectangleElementConfigs, config); }
-Clay_TextElementConfig * Clay__StoreTextElementConfig(Clay_TextElementConfig config) {  return Clay__booleanWarnings.maxElementsExceeded ? &CLAY__TEXT_ELEMENT_CONFIG_DEFAULT : Clay__TextElementConfigArray_Add(&Clay__textElementConfigs, config); }
-Clay_ImageElementConfig * Clay__StoreImageElementConfig(Clay_ImageElementConfig config) {  return Clay__booleanWarnings.maxElementsExceeded ? &CLAY__IMAGE_ELEMENT_CONFIG_DEFAULT : Clay__ImageElementConfigArray_Add(&Clay__imageElementConfigs, config); }
-Clay_FloatingElementConfig * Clay__StoreFloatingElementConfig(Clay_FloatingElementConfig config) {  return Clay__booleanWarnings.maxElementsExceeded ? &CLAY__FLOATING_ELEMENT_CONFIG_DEFAULT : Clay__FloatingElementConfigArray_Add(&Clay__floatingElementConfigs, config); }
-Clay_CustomElementConfig * Clay__StoreCustomElementConfig(Clay_CustomElementConfig config) {  return Clay__booleanWarnings.maxElementsExceeded ? &CLAY__CUSTOM_ELEMENT_CONFIG_DEFAULT : Clay__CustomElementConfigArray_Add(&Clay__customElementConfigs, config); }
-Clay_ScrollElementConfig * Clay__StoreScrollElementConfig(Clay_ScrollElementConfig config) {  return Clay__booleanWarnings.maxElementsExceeded ? &CLAY__SCROLL_ELEMENT_CONFIG_DEFAULT : Clay__ScrollElementConfigArray_Add(&Clay__scrollElementConfigs, config); }
-Clay_BorderElementConfig * Clay__StoreBorderElementConfig(Clay_BorderElementConfig config) {  return Clay__booleanWarnings.maxElementsExceeded ? &CLAY__BORDER_ELEMENT_CONFIG_DEFAULT : Clay__BorderElementConfigArray_Add(&Clay__borderElementConfigs, config); }
+Clay_LayoutConfig * Clay__StoreLayoutConfig(Clay_LayoutConfig config) { Clay_Context* context = Clay_GetCurrentContext(); return context->booleanWarnings.maxElementsExceeded ? &CLAY_LAYOUT_DEFAULT : Clay__LayoutConfigArray_Add(&context->layoutConfigs, config); }
+Clay_RectangleElementConfig * Clay__StoreRectangleElementConfig(Clay_RectangleElementConfig config) { Clay_Context* context = Clay_GetCurrentContext(); return context->booleanWarnings.maxElementsExceeded ? &CLAY__RECTANGLE_ELEMENT_CONFIG_DEFAULT : Clay__RectangleElementConfigArray_Add(&context->rectangleElementConfigs, config); }
+Clay_TextElementConfig * Clay__StoreTextElementConfig(Clay_TextElementConfig config) { Clay_Context* context = Clay_GetCurrentContext(); return context->booleanWarnings.maxElementsExceeded ? &CLAY__TEXT_ELEMENT_CONFIG_DEFAULT : Clay__TextElementConfigArray_Add(&context->textElementConfigs, config); }
+Clay_ImageElementConfig * Clay__StoreImageElementConfig(Clay_ImageElementConfig config) { Clay_Context* context = Clay_GetCurrentContext(); return context->booleanWarnings.maxElementsExceeded ? &CLAY__IMAGE_ELEMENT_CONFIG_DEFAULT : Clay__ImageElementConfigArray_Add(&context->imageElementConfigs, config); }
+Clay_FloatingElementConfig * Clay__StoreFloatingElementConfig(Clay_FloatingElementConfig config) { Clay_Context* context = Clay_GetCurrentContext(); return context->booleanWarnings.maxElementsExceeded ? &CLAY__FLOATING_ELEMENT_CONFIG_DEFAULT : Clay__FloatingElementConfigArray_Add(&context->floatingElementConfigs, config); }
+Clay_CustomElementConfig * Clay__StoreCustomElementConfig(Clay_CustomElementConfig config) { Clay_Context* context = Clay_GetCurrentContext(); return context->booleanWarnings.maxElementsExceeded ? &CLAY__CUSTOM_ELEMENT_CONFIG_DEFAULT : Clay__CustomElementConfigArray_Add(&context->customElementConfigs, config); }
+Clay_ScrollElementConfig * Clay__StoreScrollElementConfig(Clay_ScrollElementConfig config) { Clay_Context* context = Clay_GetCurrentContext(); return context->booleanWarnings.maxElementsExceeded ? &CLAY__SCROLL_ELEMENT_CONFIG_DEFAULT : Clay__ScrollElementConfigArray_Add(&context->scrollElementConfigs, config); }
+Clay_BorderElementConfig * Clay__StoreBorderElementConfig(Clay_BorderElementConfig config) { Clay_Context* context = Clay_GetCurrentContext(); return context->booleanWarnings.maxElementsExceeded ? &CLAY__BORDER_ELEMENT_CONFIG_DEFAULT : Clay__BorderElementConfigArray_Add(&context->borderElementConfigs, config); }
 
 #pragma region DebugTools
 Clay_Color CLAY__DEBUGVIEW_COLOR_1 = CLAY__INIT(Clay_Color) {58, 56, 52, 255};
@@ -2962,7 +5048,8 @@ typedef struct
 
 // Returns row count
 Clay__RenderDebugLayoutData Clay__RenderDebugLayoutElementsList(int32_t initialRootsLength, int32_t highlightedRowIndex) {
-    Clay__int32_tArray dfsBuffer = Clay__reusableElementIndexBuffer;
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__int32_tArray dfsBuffer = context->reusableElementIndexBuffer;
     Clay__DebugView_ScrollViewItemLayoutConfig = CLAY__INIT(Clay_LayoutConfig) { .sizing = { .height = CLAY_SIZING_FIXED(CLAY__DEBUGVIEW_ROW_HEIGHT) }, .childGap = 6, .childAlignment = { .y = CLAY_ALIGN_Y_CENTER }};
     Clay__RenderDebugLayoutData layoutData = {};
 
@@ -2970,9 +5057,9 @@ Clay__RenderDebugLayoutData Clay__RenderDebugLayoutElementsList(int32_t initialR
 
     for (int rootIndex = 0; rootIndex < initialRootsLength; ++rootIndex) {
         dfsBuffer.length = 0;
-        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&Clay__layoutElementTreeRoots, rootIndex);
+        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
         Clay__int32_tArray_Add(&dfsBuffer, (int32_t)root->layoutElementIndex);
-        Clay__treeNodeVisited.internalArray[0] = false;
+        context->treeNodeVisited.internalArray[0] = false;
         if (rootIndex > 0) {
             CLAY(CLAY_IDI("Clay__DebugView_EmptyRowOuter", rootIndex), CLAY_LAYOUT({ .sizing = {.width = CLAY_SIZING_GROW({})}, .padding = {CLAY__DEBUGVIEW_INDENT_WIDTH / 2} })) {
                 CLAY(CLAY_IDI("Clay__DebugView_EmptyRow", rootIndex), CLAY_LAYOUT({ .sizing = { .width = CLAY_SIZING_GROW({}), .height = CLAY_SIZING_FIXED((float)CLAY__DEBUGVIEW_ROW_HEIGHT) }}), CLAY_BORDER({ .top = { .width = 1, .color = CLAY__DEBUGVIEW_COLOR_3 } })) {}
@@ -2981,8 +5068,8 @@ Clay__RenderDebugLayoutData Clay__RenderDebugLayoutElementsList(int32_t initialR
         }
         while (dfsBuffer.length > 0) {
             uint32_t currentElementIndex = Clay__int32_tArray_Get(&dfsBuffer, (int)dfsBuffer.length - 1);
-            Clay_LayoutElement *currentElement = Clay_LayoutElementArray_Get(&Clay__layoutElements, (int)currentElementIndex);
-            if (Clay__treeNodeVisited.internalArray[dfsBuffer.length - 1]) {
+            Clay_LayoutElement *currentElement = Clay_LayoutElementArray_Get(&context->layoutElements, (int)currentElementIndex);
+            if (context->treeNodeVisited.internalArray[dfsBuffer.length - 1]) {
                 if (!Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT) && currentElement->children.length > 0) {
                     Clay__CloseElement();
                     Clay__CloseElement();
@@ -2993,16 +5080,16 @@ Clay__RenderDebugLayoutData Clay__RenderDebugLayoutElementsList(int32_t initialR
             }
 
             if (highlightedRowIndex == layoutData.rowCount) {
-                if (Clay__pointerInfo.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
-                    Clay__debugSelectedElementId = currentElement->id;
+                if (context->pointerInfo.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
+                    context->debugSelectedElementId = currentElement->id;
                 }
                 highlightedElementId = currentElement->id;
             }
 
-            Clay__treeNodeVisited.internalArray[dfsBuffer.length - 1] = true;
+            context->treeNodeVisited.internalArray[dfsBuffer.length - 1] = true;
             Clay_LayoutElementHashMapItem *currentElementData = Clay__GetHashMapItem(currentElement->id);
             bool offscreen = Clay__ElementIsOffscreen(&currentElementData->boundingBox);
-            if (Clay__debugSelectedElementId == currentElement->id) {
+            if (context->debugSelectedElementId == currentElement->id) {
                 layoutData.selectedElementRowIndex = layoutData.rowCount;
             }
             CLAY(CLAY_IDI("Clay__DebugView_ElementOuter", currentElement->id), Clay__AttachLayoutConfig(&Clay__DebugView_ScrollViewItemLayoutConfig)) {
@@ -3032,7 +5119,7 @@ Clay__RenderDebugLayoutData Clay__RenderDebugLayoutElementsList(int32_t initialR
                         }
                     }
                 }
-                Clay_String idString = Clay__layoutElementIdStrings.internalArray[currentElementIndex];
+                Clay_String idString = context->layoutElementIdStrings.internalArray[currentElementIndex];
                 if (idString.length > 0) {
                     CLAY_TEXT(idString, offscreen ? CLAY_TEXT_CONFIG({ .textColor = CLAY__DEBUGVIEW_COLOR_3, .fontSize = 16 }) : &Clay__DebugView_TextNameConfig);
                 }
@@ -3078,16 +5165,16 @@ Clay__RenderDebugLayoutData Clay__RenderDebugLayoutElementsList(int32_t initialR
             if (!(Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT) || (currentElementData && currentElementData->debugData->collapsed))) {
                 for (int i = currentElement->children.length - 1; i >= 0; --i) {
                     Clay__int32_tArray_Add(&dfsBuffer, currentElement->children.elements[i]);
-                    Clay__treeNodeVisited.internalArray[dfsBuffer.length - 1] = false; // TODO needs to be ranged checked
+                    context->treeNodeVisited.internalArray[dfsBuffer.length - 1] = false; // TODO needs to be ranged checked
                 }
             }
         }
     }
 
-    if (Clay__pointerInfo.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
+    if (context->pointerInfo.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
         Clay_ElementId collapseButtonId = Clay__HashString(CLAY_STRING("Clay__DebugView_CollapseElement"), 0, 0);
-        for (int i = (int)Clay__pointerOverIds.length - 1; i >= 0; i--) {
-            Clay_ElementId *elementId = Clay__ElementIdArray_Get(&Clay__pointerOverIds, i);
+        for (int32_t i = 0; i < (int32_t)context->pointerOverIds.length; ++i) {
+            Clay_ElementId *elementId = Clay__ElementIdArray_Get(&context->pointerOverIds, i);
             if (elementId->baseId == collapseButtonId.baseId) {
                 Clay_LayoutElementHashMapItem *highlightedItem = Clay__GetHashMapItem(elementId->offset);
                 highlightedItem->debugData->collapsed = !highlightedItem->debugData->collapsed;
@@ -3185,48 +5272,46 @@ void Clay__RenderDebugViewBorder(int index, Clay_Border border, Clay_TextElement
 }
 
 void HandleDebugViewCloseButtonInteraction(Clay_ElementId elementId, Clay_PointerData pointerInfo, intptr_t userData) {
+    Clay_Context* context = Clay_GetCurrentContext();
     if (pointerInfo.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
-        Clay__debugModeEnabled = false;
+        context->debugModeEnabled = false;
     }
 }
 
 void Clay__RenderDebugView() {
+    Clay_Context* context = Clay_GetCurrentContext();
     Clay_ElementId closeButtonId = Clay__HashString(CLAY_STRING("Clay__DebugViewTopHeaderCloseButtonOuter"), 0, 0);
-    if (Clay__pointerInfo.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
-        for (int i = 0; i < Clay__pointerOverIds.length; ++i) {
-            Clay_ElementId *elementId = Clay__ElementIdArray_Get(&Clay__pointerOverIds, i);
+    if (context->pointerInfo.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
+        for (int32_t i = 0; i < (int32_t)context->pointerOverIds.length; ++i) {
+            Clay_ElementId *elementId = Clay__ElementIdArray_Get(&context->pointerOverIds, i);
             if (elementId->id == closeButtonId.id) {
-                Clay__debugModeEnabled = false;
+                context->debugModeEnabled = false;
                 return;
             }
         }
     }
 
-    uint32_t initialRootsLength = Clay__layoutElementTreeRoots.length;
-    uint32_t initialElementsLength = Clay__layoutElements.length;
-    Clay_TextElementConfig *infoTextConfig = CLAY_TEXT_CONFIG({ .textColor = CLAY__DEBUGVIEW_COLOR_4, .fontSize = 16, .wrapMode = CLAY_TEXT_WRAP_NONE });
-    Clay_TextElementConfig *infoTitleConfig = CLAY_TEXT_CONFIG({ .textColor = CLAY__DEBUGVIEW_COLOR_3, .fontSize = 16, .wrapMode = CLAY_TEXT_WRAP_NONE });
+    uint32_t initialRootsLength = context->layoutElementTreeRoots.length;
+    uint32_t initialElementsLength = context->layoutElements.length;
+    // Numbers are written to the same scratch buffer every frame, so they have to be cached by contents
+    Clay_TextElementConfig *infoTextConfig = CLAY_TEXT_CONFIG({ .textColor = CLAY__DEBUGVIEW_COLOR_4, .fontSize = 16, .wrapMode = CLAY_TEXT_WRAP_NONE, .hashStringContents = true });
+    Clay_TextElementConfig *infoTitleConfig = CLAY_TEXT_CONFIG({ .textColor = CLAY__DEBUGVIEW_COLOR_3, .fontSize = 16, .wrapMode = CLAY_TEXT_WRAP_NONE, .hashStringContents = true });
     Clay_ElementId scrollId = Clay__HashString(CLAY_STRING("Clay__DebugViewOuterScrollPane"), 0, 0);
     float scrollYOffset = 0;
-    for (int i = 0; i < Clay__scrollContainerDatas.length; ++i) {
-        Clay__ScrollContainerDataInternal *scrollContainerData = Clay__ScrollContainerDataInternalArray_Get(&Clay__scrollContainerDatas, i);
-        if (scrollContainerData->elementId == scrollId.id) {
-            if (!Clay__externalScrollHandlingEnabled) {
-                scrollYOffset = scrollContainerData->scrollPosition.y;
-            }
-            break;
-        }
+    Clay__ScrollContainerDataInternal *scrollContainerData = Clay__GetScrollContainerDataInternal(scrollId.id);
+    if (scrollContainerData && !context->externalScrollHandlingEnabled) {
+        scrollYOffset = scrollContainerData->scrollPosition.y;
     }
-    int32_t highlightedRow = Clay__pointerInfo.position.y < Clay__layoutDimensions.height - 300
-            ? (int32_t)((Clay__pointerInfo.position.y - scrollYOffset) / (float)CLAY__DEBUGVIEW_ROW_HEIGHT) - 1
+    int32_t highlightedRow = context->pointerInfo.position.y < context->layoutDimensions.height - 300
+            ? (int32_t)((context->pointerInfo.position.y - scrollYOffset) / (float)CLAY__DEBUGVIEW_ROW_HEIGHT) - 1
             : -1;
-    if (Clay__pointerInfo.position.x < Clay__layoutDimensions.width - (float)Clay__debugViewWidth) {
+    if (context->pointerInfo.position.x < context->layoutDimensions.width - (float)Clay__debugViewWidth) {
         highlightedRow = -1;
     }
     Clay__RenderDebugLayoutData layoutData = {};
     CLAY(CLAY_ID("Clay__DebugView"),
         CLAY_FLOATING({ .parentId = Clay__HashString(CLAY_STRING("Clay__RootContainer"), 0, 0).id, .attachment = { .element = CLAY_ATTACH_POINT_LEFT_CENTER, .parent = CLAY_ATTACH_POINT_RIGHT_CENTER }}),
-        CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIXED((float)Clay__debugViewWidth) , CLAY_SIZING_FIXED(Clay__layoutDimensions.height) }, .layoutDirection = CLAY_TOP_TO_BOTTOM }),
+        CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIXED((float)Clay__debugViewWidth) , CLAY_SIZING_FIXED(context->layoutDimensions.height) }, .layoutDirection = CLAY_TOP_TO_BOTTOM }),
         CLAY_BORDER({ .bottom = { .width = 1, .color = CLAY__DEBUGVIEW_COLOR_3 }})
     ) {
         CLAY(CLAY_LAYOUT({ .sizing = {CLAY_SIZING_GROW({}), CLAY_SIZING_FIXED(CLAY__DEBUGVIEW_ROW_HEIGHT)}, .padding = {CLAY__DEBUGVIEW_OUTER_PADDING}, .childAlignment = {.y = CLAY_ALIGN_Y_CENTER} }), CLAY_RECTANGLE({ .color = CLAY__DEBUGVIEW_COLOR_2 })) {
@@ -3251,7 +5336,13 @@ void Clay__RenderDebugView() {
                         layoutData = Clay__RenderDebugLayoutElementsList((int32_t)initialRootsLength, highlightedRow);
                     }
                 }
-                float contentWidth = Clay__GetHashMapItem(panelContentsId.id)->layoutElement->dimensions.width;
+                Clay_LayoutElement *panelContents = Clay__GetHashMapItem(panelContentsId.id)->layoutElement;
+                if (context->textMeasurementDeferred) {
+                    // The list's width is needed right away, so its text can't wait until the end of the frame to be measured
+                    Clay__ResolveMeasureTextBatch();
+                    Clay__UpdateDeferredTextDimensions((int32_t)(panelContents - context->layoutElements.internalArray));
+                }
+                float contentWidth = panelContents->dimensions.width;
                 CLAY(CLAY_LAYOUT({ .sizing = {CLAY_SIZING_FIXED(contentWidth)}, .layoutDirection = CLAY_TOP_TO_BOTTOM })) {}
                 for (uint32_t i = 0; i < layoutData.rowCount; i++) {
                     Clay_Color rowColor = (i & 1) == 0 ? CLAY__DEBUGVIEW_COLOR_2 : CLAY__DEBUGVIEW_COLOR_1;
@@ -3268,8 +5359,8 @@ void Clay__RenderDebugView() {
             }
         }
         CLAY(CLAY_LAYOUT({ .sizing = {.width = CLAY_SIZING_GROW({}), .height = CLAY_SIZING_FIXED(1)} }), CLAY_RECTANGLE({ .color = CLAY__DEBUGVIEW_COLOR_3 })) {}
-        if (Clay__debugSelectedElementId != 0) {
-            Clay_LayoutElementHashMapItem *selectedItem = Clay__GetHashMapItem(Clay__debugSelectedElementId);
+        if (context->debugSelectedElementId != 0) {
+            Clay_LayoutElementHashMapItem *selectedItem = Clay__GetHashMapItem(context->debugSelectedElementId);
             CLAY(
                 CLAY_SCROLL({ .vertical = true }),
                 CLAY_LAYOUT({ .sizing = {CLAY_SIZING_GROW({}), CLAY_SIZING_FIXED(300)}, .layoutDirection = CLAY_TOP_TO_BOTTOM }),
@@ -3495,9 +5586,9 @@ void Clay__RenderDebugView() {
                     CLAY_TEXT(CLAY_STRING("Warnings"), warningConfig);
                 }
                 CLAY(CLAY_ID("Clay__DebugViewWarningsTopBorder"), CLAY_LAYOUT({ .sizing = { .width = CLAY_SIZING_GROW({}), .height = CLAY_SIZING_FIXED(1)} }), CLAY_RECTANGLE({ .color = {200, 200, 200, 255} })) {}
-                int previousWarningsLength = (int)Clay_warnings.length;
+                int previousWarningsLength = (int)context->warnings.length;
                 for (int i = 0; i < previousWarningsLength; i++) {
-                    Clay__Warning warning = Clay_warnings.internalArray[i];
+                    Clay__Warning warning = context->warnings.internalArray[i];
                     CLAY(CLAY_IDI("Clay__DebugViewWarningItem", i), CLAY_LAYOUT({ .sizing = {.height = CLAY_SIZING_FIXED(CLAY__DEBUGVIEW_ROW_HEIGHT)}, .padding = {CLAY__DEBUGVIEW_OUTER_PADDING}, .childGap = 8, .childAlignment = {.y = CLAY_ALIGN_Y_CENTER} })) {
                         CLAY_TEXT(warning.baseMessage, warningConfig);
                         if (warning.dynamicMessage.length > 0) {
@@ -3508,143 +5599,903 @@ void Clay__RenderDebugView() {
             }
         }
     }
-}
-#pragma endregion
+}
+#pragma endregion
+
+// PUBLIC API FROM HERE ---------------------------------------
+
+CLAY_WASM_EXPORT("Clay_MinMemorySize")
+uint32_t Clay_MinMemorySize(void) {
+    Clay_Context fakeContext = CLAY__INIT(Clay_Context) {
+        .maxElementCount = Clay__defaultMaxElementCount,
+        .maxMeasureTextCacheWordCount = Clay__defaultMaxMeasureTextCacheWordCount,
+        .maxScrollContainerCount = Clay__defaultMaxScrollContainerCount,
+        .ephemeralCapacities = Clay__defaultEphemeralCapacities,
+        .measureTextBatchFunction = Clay__defaultMeasureTextBatchFunction,
+        .renderCommandDeltasEnabled = Clay__defaultRenderCommandDeltasEnabled,
+        .compactRenderCommandsEnabled = Clay__defaultCompactRenderCommandsEnabled,
+        .pointerHitGridEnabled = Clay__defaultPointerHitGridEnabled,
+        .internalArena = { .capacity = SIZE_MAX },
+    };
+    Clay_Context* currentContext = Clay_GetCurrentContext();
+    if (currentContext) {
+        fakeContext.maxElementCount = currentContext->maxElementCount;
+        fakeContext.maxMeasureTextCacheWordCount = currentContext->maxMeasureTextCacheWordCount;
+        fakeContext.maxScrollContainerCount = currentContext->maxScrollContainerCount;
+        fakeContext.ephemeralCapacities = currentContext->ephemeralCapacities;
+        fakeContext.measureTextBatchFunction = currentContext->measureTextBatchFunction;
+        fakeContext.compactRenderCommandsEnabled = currentContext->compactRenderCommandsEnabled;
+        fakeContext.pointerHitGridEnabled = currentContext->pointerHitGridEnabled;
+        fakeContext.renderCommandDeltasEnabled = currentContext->renderCommandDeltasEnabled;
+        fakeContext.errorHandler = currentContext->errorHandler;
+    }
+    // The context itself is stored at the start of the arena
+    Clay__Context_Allocate_Arena(&fakeContext.internalArena);
+    Clay_SetCurrentContext(&fakeContext);
+    Clay__InitializePersistentMemory(&fakeContext.internalArena);
+    Clay__InitializeEphemeralMemory(&fakeContext.internalArena);
+    Clay_SetCurrentContext(currentContext);
+    return fakeContext.internalArena.nextAllocation;
+}
+
+CLAY_WASM_EXPORT("Clay_CreateArenaWithCapacityAndMemory")
+Clay_Arena Clay_CreateArenaWithCapacityAndMemory(uint32_t capacity, void *offset) {
+    Clay_Arena arena = CLAY__INIT(Clay_Arena) {
+        .capacity = capacity,
+        .memory = (char *)offset
+    };
+    return arena;
+}
+
+#ifndef CLAY_WASM
+void Clay_SetMeasureTextFunction(Clay_Dimensions (*measureTextFunction)(Clay_String *text, Clay_TextElementConfig *config)) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (!context) {
+        Clay__defaultMeasureTextFunction = measureTextFunction;
+        return;
+    }
+    context->measureTextFunction = measureTextFunction;
+}
+void Clay_SetMeasureTextBatchFunction(void (*measureTextBatchFunction)(Clay_String *words, Clay_TextElementConfig **configs, Clay_Dimensions *outDimensions, uint32_t count)) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (!context) {
+        Clay__defaultMeasureTextBatchFunction = measureTextBatchFunction;
+        return;
+    }
+    if (measureTextBatchFunction && !context->measureTextBatchFunction) {
+        // The batch arrays are allocated from the next frame, if there's room for them
+        Clay_Context settings = *context;
+        settings.measureTextBatchFunction = measureTextBatchFunction;
+        if (!Clay__EphemeralMemoryFits(&settings, CLAY_STRING("Clay couldn't start measuring text in batches, since the arena doesn't have room for the batch. Set the batch measure text function before calling Clay_MinMemorySize() and Clay_Initialize(), or pass a larger arena."))) {
+            return;
+        }
+    }
+    context->measureTextBatchFunction = measureTextBatchFunction;
+}
+#endif
+
+CLAY_WASM_EXPORT("Clay_RegisterFontMetrics")
+void Clay_RegisterFontMetrics(uint16_t fontId, Clay_FontMetrics metrics) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    // Strings in this font may have already been measured, with the font's previous metrics or with the measure text function.
+    // The layout also has to be redone even if the declarations don't change.
+    context->measureTextCachesStale = true;
+    context->previousDeclarationHashValid = false;
+    Clay_FontMetrics *existing = Clay__GetFontMetrics(fontId);
+    if (existing) {
+        *existing = metrics;
+        return;
+    }
+    if (context->fontMetrics.length == context->fontMetrics.capacity) {
+        context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+            .errorType = CLAY_ERROR_TYPE_TEXT_MEASUREMENT_CAPACITY_EXCEEDED,
+            .errorText = CLAY_STRING("Clay_RegisterFontMetrics() was called for more than 32 different fonts."),
+            .userData = context->errorHandler.userData });
+        return;
+    }
+    Clay__RegisteredFontMetricsArray_Add(&context->fontMetrics, CLAY__INIT(Clay__RegisteredFontMetrics) { .fontId = fontId, .metrics = metrics });
+}
+
+#ifndef CLAY_WASM
+void Clay_SetQueryScrollOffsetFunction(Clay_Vector2 (*queryScrollOffsetFunction)(uint32_t elementId)) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (!context) {
+        Clay__defaultQueryScrollOffsetFunction = queryScrollOffsetFunction;
+        return;
+    }
+    context->queryScrollOffsetFunction = queryScrollOffsetFunction;
+}
+#endif
+
+CLAY_WASM_EXPORT("Clay_SetLayoutDimensions")
+void Clay_SetLayoutDimensions(Clay_Dimensions dimensions) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->layoutDimensions = dimensions;
+}
+
+// Returns the range of grid cells covered by [start, end] along one axis. It's monotonic, so a point inside a box always lands in one of the box's cells.
+void Clay__PointerHitGridCellRange(float start, float end, float gridStart, float cellScale, int32_t cellCount, int32_t *firstCell, int32_t *lastCell) {
+    *firstCell = (int32_t)CLAY__MAX(0, CLAY__MIN((start - gridStart) * cellScale, (float)(cellCount - 1)));
+    *lastCell = (int32_t)CLAY__MAX(0, CLAY__MIN((end - gridStart) * cellScale, (float)(cellCount - 1)));
+}
+
+float Clay__PointerHitGridCellScale(float size, int32_t cellCount) {
+    return size > 0 ? (float)cellCount / size : 0;
+}
+
+// Within a root, later hits are deeper or drawn over earlier siblings, so each root's hits are reversed in place once the root is done.
+// The hash map items are marked as well, so that hover queries don't have to search the list.
+void Clay__OrderPointerOverRootByPriority(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_ElementId *rootIds = context->pointerOverIds.internalArray + context->pointerOverRootStart;
+    int32_t rootIdCount = (int32_t)(context->pointerOverIds.length - context->pointerOverRootStart);
+    for (int32_t i = 0; i < rootIdCount / 2; ++i) {
+        Clay_ElementId elementId = rootIds[i];
+        rootIds[i] = rootIds[rootIdCount - 1 - i];
+        rootIds[rootIdCount - 1 - i] = elementId;
+    }
+    for (int32_t i = (int32_t)context->pointerOverRootStart; i < (int32_t)context->pointerOverIds.length; ++i) {
+        Clay_LayoutElementHashMapItem *hashItem = Clay__GetHashMapItem(context->pointerOverIds.internalArray[i].id);
+        if (hashItem != &CLAY__LAYOUT_ELEMENT_HASH_MAP_ITEM_DEFAULT && hashItem->pointerOverGeneration != context->pointerOverGeneration) {
+            hashItem->pointerOverGeneration = context->pointerOverGeneration;
+            hashItem->pointerOverPriority = (uint32_t)i;
+        }
+    }
+    context->pointerOverRootStart = context->pointerOverIds.length;
+}
+
+bool Clay__PointerIsOver(uint32_t id) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_LayoutElementHashMapItem *hashItem = Clay__GetHashMapItem(id);
+    return context->pointerOverGeneration != 0 && hashItem != &CLAY__LAYOUT_ELEMENT_HASH_MAP_ITEM_DEFAULT && hashItem->pointerOverGeneration == context->pointerOverGeneration;
+}
+
+void Clay__AddPointerHit(Clay_LayoutElementHashMapItem *mapItem, int32_t rootIndex) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (rootIndex != context->pointerOverRootIndex) {
+        Clay__OrderPointerOverRootByPriority();
+        context->pointerOverRootIndex = rootIndex;
+    }
+    if (mapItem->onHoverFunction) {
+        mapItem->onHoverFunction(mapItem->elementId, context->pointerInfo, mapItem->hoverFunctionUserData);
+    }
+    Clay__ElementIdArray_Add(&context->pointerOverIds, mapItem->elementId);
+}
+
+bool Clay__PointerHitRootCapturesPointer(int32_t rootIndex) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
+    Clay_LayoutElement *rootElement = Clay_LayoutElementArray_Get(&context->layoutElements, root->layoutElementIndex);
+    return Clay__ElementHasConfig(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING_CONTAINER) &&
+        Clay__FindElementConfigWithType(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING_CONTAINER).floatingElementConfig->pointerCaptureMode == CLAY_POINTER_CAPTURE_MODE_CAPTURE;
+}
+
+// Tests every element, visiting roots from last to first and then depth first with children in order. While the grid is enabled, each element is
+// also recorded in that order, so that later queries against the same layout can use the grid instead. Without a position the elements are only recorded.
+void Clay__PointerHitTestTree(Clay_Vector2 *position) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->pointerHitRecords.length = 0;
+    bool recording = context->pointerHitGridEnabled && context->pointerHitRecords.capacity > 0;
+    bool captured = position == CLAY__NULL;
+    Clay__int32_tArray dfsBuffer = context->layoutElementChildrenBuffer;
+    for (int rootIndex = context->layoutElementTreeRoots.length - 1; rootIndex >= 0; --rootIndex) {
+        dfsBuffer.length = 0;
+        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
+        Clay__int32_tArray_Add(&dfsBuffer, (int32_t)root->layoutElementIndex);
+        bool found = false;
+        while (dfsBuffer.length > 0) {
+            Clay_LayoutElement *currentElement = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_Get(&dfsBuffer, (int)dfsBuffer.length - 1));
+            dfsBuffer.length--;
+            Clay_LayoutElementHashMapItem *mapItem = Clay__GetHashMapItem(currentElement->id);
+            Clay_BoundingBox elementBox = mapItem->boundingBox;
+            elementBox.x -= root->pointerOffset.x;
+            elementBox.y -= root->pointerOffset.y;
+            if (recording) {
+                Clay__PointerHitRecordArray_Add(&context->pointerHitRecords, CLAY__INIT(Clay__PointerHitRecord) { .boundingBox = elementBox, .hashMapItem = mapItem, .rootIndex = rootIndex });
+            }
+            // Once a root has captured the pointer, the remaining roots are still recorded for the grid
+            if (!captured && Clay__PointIsInsideRect(*position, elementBox)) {
+                Clay__AddPointerHit(mapItem, rootIndex);
+                found = true;
+            }
+            if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT)) {
+                continue;
+            }
+            for (int i = currentElement->children.length - 1; i >= 0; --i) {
+                Clay__int32_tArray_Add(&dfsBuffer, currentElement->children.elements[i]);
+            }
+        }
+        if (found && Clay__PointerHitRootCapturesPointer(rootIndex)) {
+            captured = true;
+            if (!recording) {
+                break;
+            }
+        }
+    }
+    context->pointerHitRecordsValid = recording;
+}
+
+// Bins the recorded elements into a uniform grid, so that a pointer query only has to test the elements that overlap its cell
+void Clay__BuildPointerHitGrid(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_BoundingBox bounds = CLAY__INIT(Clay_BoundingBox) {};
+    float averageWidth = 0;
+    float averageHeight = 0;
+    for (int32_t i = 0; i < (int32_t)context->pointerHitRecords.length; ++i) {
+        Clay_BoundingBox box = context->pointerHitRecords.internalArray[i].boundingBox;
+        averageWidth += box.width / (float)context->pointerHitRecords.length;
+        averageHeight += box.height / (float)context->pointerHitRecords.length;
+        if (i == 0) {
+            bounds = box;
+            continue;
+        }
+        float right = CLAY__MAX(bounds.x + bounds.width, box.x + box.width);
+        float bottom = CLAY__MAX(bounds.y + bounds.height, box.y + box.height);
+        bounds.x = CLAY__MIN(bounds.x, box.x);
+        bounds.y = CLAY__MIN(bounds.y, box.y);
+        bounds.width = right - bounds.x;
+        bounds.height = bottom - bounds.y;
+    }
+    context->pointerHitGridBounds = bounds;
+
+    // Cells start out about twice the size of an average element, so that most elements only land in a few of them
+    int32_t maxCellCount = CLAY__MAX(1, CLAY__MIN((int32_t)context->pointerHitRecords.length, (int32_t)context->pointerHitGridCells.capacity));
+    float cellWidth = CLAY__MAX(averageWidth * 2, 1);
+    float cellHeight = CLAY__MAX(averageHeight * 2, 1);
+    int32_t columns, rows;
+    while (true) {
+        columns = (int32_t)CLAY__MIN(bounds.width / cellWidth + 1, (float)maxCellCount);
+        rows = (int32_t)CLAY__MIN(bounds.height / cellHeight + 1, (float)maxCellCount);
+        if ((float)columns * (float)rows <= (float)maxCellCount) {
+            break;
+        }
+        cellWidth *= 1.25f;
+        cellHeight *= 1.25f;
+    }
+
+    // Elements that cover many cells can still overflow the entries, in which case the grid gets coarser until they fit
+    Clay__int32_tArray *cells = &context->pointerHitGridCells;
+    Clay__int32_tArray *entries = &context->pointerHitGridEntries;
+    while (true) {
+        float columnScale = Clay__PointerHitGridCellScale(bounds.width, columns);
+        float rowScale = Clay__PointerHitGridCellScale(bounds.height, rows);
+        cells->length = columns * rows;
+        for (int32_t i = 0; i < (int32_t)cells->length; ++i) {
+            cells->internalArray[i] = 0;
+        }
+        int32_t entryCount = 0;
+        for (int32_t i = 0; i < (int32_t)context->pointerHitRecords.length && entryCount <= (int32_t)entries->capacity; ++i) {
+            Clay_BoundingBox box = context->pointerHitRecords.internalArray[i].boundingBox;
+            int32_t firstColumn, lastColumn, firstRow, lastRow;
+            Clay__PointerHitGridCellRange(box.x, box.x + box.width, bounds.x, columnScale, columns, &firstColumn, &lastColumn);
+            Clay__PointerHitGridCellRange(box.y, box.y + box.height, bounds.y, rowScale, rows, &firstRow, &lastRow);
+            for (int32_t row = firstRow; row <= lastRow; ++row) {
+                for (int32_t column = firstColumn; column <= lastColumn; ++column) {
+                    cells->internalArray[row * columns + column]++;
+                }
+            }
+            entryCount += (lastColumn - firstColumn + 1) * (lastRow - firstRow + 1);
+        }
+        // A single cell holds each element exactly once, which always fits
+        if (entryCount <= (int32_t)entries->capacity || (columns == 1 && rows == 1)) {
+            entries->length = entryCount;
+            break;
+        }
+        columns = CLAY__MAX(1, columns / 2);
+        rows = CLAY__MAX(1, rows / 2);
+    }
+    context->pointerHitGridColumns = columns;
+    context->pointerHitGridRows = rows;
+
+    // Each cell starts at the previous cell's end, and the ends are moved into place as the entries are written
+    int32_t cellStart = 0;
+    for (int32_t i = 0; i < (int32_t)cells->length; ++i) {
+        int32_t count = cells->internalArray[i];
+        cells->internalArray[i] = cellStart;
+        cellStart += count;
+    }
+    float columnScale = Clay__PointerHitGridCellScale(bounds.width, columns);
+    float rowScale = Clay__PointerHitGridCellScale(bounds.height, rows);
+    for (int32_t i = 0; i < (int32_t)context->pointerHitRecords.length; ++i) {
+        Clay_BoundingBox box = context->pointerHitRecords.internalArray[i].boundingBox;
+        int32_t firstColumn, lastColumn, firstRow, lastRow;
+        Clay__PointerHitGridCellRange(box.x, box.x + box.width, bounds.x, columnScale, columns, &firstColumn, &lastColumn);
+        Clay__PointerHitGridCellRange(box.y, box.y + box.height, bounds.y, rowScale, rows, &firstRow, &lastRow);
+        for (int32_t row = firstRow; row <= lastRow; ++row) {
+            for (int32_t column = firstColumn; column <= lastColumn; ++column) {
+                entries->internalArray[cells->internalArray[row * columns + column]++] = i;
+            }
+        }
+    }
+    context->pointerHitGridValid = true;
+}
+
+// Produces the same hits in the same order as Clay__PointerHitTestTree, since each cell's entries are in the order the elements were recorded.
+// Hits go to pointerOverIds and the hover functions, or only to hitIds if it's provided. Returns the index of the root that captured the point, or -1.
+int32_t Clay__PointerHitTestGrid(Clay_Vector2 position, Clay__ElementIdArray *hitIds) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->pointerHitRecords.length == 0) {
+        return -1;
+    }
+    Clay_BoundingBox bounds = context->pointerHitGridBounds;
+    int32_t column, row, unused;
+    Clay__PointerHitGridCellRange(position.x, position.x, bounds.x, Clay__PointerHitGridCellScale(bounds.width, context->pointerHitGridColumns), context->pointerHitGridColumns, &column, &unused);
+    Clay__PointerHitGridCellRange(position.y, position.y, bounds.y, Clay__PointerHitGridCellScale(bounds.height, context->pointerHitGridRows), context->pointerHitGridRows, &row, &unused);
+    int32_t cellIndex = row * context->pointerHitGridColumns + column;
+    int32_t entryEnd = context->pointerHitGridCells.internalArray[cellIndex];
+    int32_t capturingRootIndex = -1;
+    for (int32_t entryIndex = cellIndex > 0 ? context->pointerHitGridCells.internalArray[cellIndex - 1] : 0; entryIndex < entryEnd; ++entryIndex) {
+        Clay__PointerHitRecord *record = &context->pointerHitRecords.internalArray[context->pointerHitGridEntries.internalArray[entryIndex]];
+        if (!Clay__PointIsInsideRect(position, record->boundingBox)) {
+            continue;
+        }
+        // A capturing root stops the search once the hits move on to the next root
+        if (capturingRootIndex != -1 && record->rootIndex != capturingRootIndex) {
+            break;
+        }
+        if (hitIds) {
+            Clay__ElementIdArray_Add(hitIds, record->hashMapItem->elementId);
+        } else {
+            Clay__AddPointerHit(record->hashMapItem, record->rootIndex);
+        }
+        if (capturingRootIndex == -1 && Clay__PointerHitRootCapturesPointer(record->rootIndex)) {
+            capturingRootIndex = record->rootIndex;
+        }
+    }
+    return capturingRootIndex;
+}
+
+CLAY_WASM_EXPORT("Clay_SetPointerState")
+void Clay_SetPointerState(Clay_Vector2 position, bool isPointerDown) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->booleanWarnings.maxElementsExceeded) {
+        return;
+    }
+    context->pointerInfo.position = position;
+    context->pointerOverIds.length = 0;
+    context->pointerOverGeneration++;
+    context->pointerOverRootIndex = -1;
+    context->pointerOverRootStart = 0;
+    // The first query after a layout walks the tree, since building the grid costs more than a single walk.
+    // Further queries against the same layout, e.g. from high rate pointer or pen input, use the grid if it's enabled.
+    if (!context->pointerHitRecordsValid) {
+        Clay__PointerHitTestTree(&position);
+    } else {
+        if (!context->pointerHitGridValid) {
+            Clay__BuildPointerHitGrid();
+        }
+        Clay__PointerHitTestGrid(position, CLAY__NULL);
+    }
+    Clay__OrderPointerOverRootByPriority();
 
-// PUBLIC API FROM HERE ---------------------------------------
+    if (isPointerDown) {
+        if (context->pointerInfo.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
+            context->pointerInfo.state = CLAY_POINTER_DATA_PRESSED;
+        } else if (context->pointerInfo.state != CLAY_POINTER_DATA_PRESSED) {
+            context->pointerInfo.state = CLAY_POINTER_DATA_PRESSED_THIS_FRAME;
+        }
+    } else {
+        if (context->pointerInfo.state == CLAY_POINTER_DATA_RELEASED_THIS_FRAME) {
+            context->pointerInfo.state = CLAY_POINTER_DATA_RELEASED;
+        } else if (context->pointerInfo.state != CLAY_POINTER_DATA_RELEASED)  {
+            context->pointerInfo.state = CLAY_POINTER_DATA_RELEASED_THIS_FRAME;
+        }
+    }
+}
 
-CLAY_WASM_EXPORT("Clay_MinMemorySize")
-uint32_t Clay_MinMemorySize(void) {
-    Clay_Arena fakeArena = CLAY__INIT(Clay_Arena) { .capacity = SIZE_MAX };
-    Clay__InitializePersistentMemory(&fakeArena);
-    Clay__InitializeEphemeralMemory(&fakeArena);
-    return fakeArena.nextAllocation;
+CLAY_WASM_EXPORT("Clay_HitTestPoints")
+void Clay_HitTestPoints(Clay_Vector2 *points, int32_t count, Clay_PointHitTestResult *results) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->pointHitTestIds.length = 0;
+    if (!context->pointerHitGridEnabled || context->pointHitTestIds.capacity == 0) {
+        context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+            .errorType = CLAY_ERROR_TYPE_INTERNAL_ERROR,
+            .errorText = CLAY_STRING("Clay_HitTestPoints() was called without the pointer hit grid. Call Clay_SetPointerHitGridEnabled(true) first, ideally before Clay_MinMemorySize() and Clay_Initialize()."),
+            .userData = context->errorHandler.userData });
+    }
+    if (context->booleanWarnings.maxElementsExceeded || context->pointHitTestIds.capacity == 0) {
+        for (int i = 0; i < count; ++i) {
+            results[i] = CLAY__INIT(Clay_PointHitTestResult) { .position = points[i] };
+        }
+        return;
+    }
+    // All of the points share one walk of the tree to record the elements, and one grid built from them
+    if (!context->pointerHitRecordsValid) {
+        Clay__PointerHitTestTree(CLAY__NULL);
+    }
+    if (!context->pointerHitGridValid) {
+        Clay__BuildPointerHitGrid();
+    }
+    for (int i = 0; i < count; ++i) {
+        uint32_t firstId = context->pointHitTestIds.length;
+        int32_t capturingRootIndex = Clay__PointerHitTestGrid(points[i], &context->pointHitTestIds);
+        results[i] = CLAY__INIT(Clay_PointHitTestResult) {
+            .position = points[i],
+            .pointerOverIds = CLAY__INIT(Clay_ElementIdArraySlice) { .length = context->pointHitTestIds.length - firstId, .internalArray = context->pointHitTestIds.internalArray + firstId },
+        };
+        if (capturingRootIndex != -1) {
+            Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, capturingRootIndex);
+            results[i].capturingElementId = Clay__GetHashMapItem(Clay_LayoutElementArray_Get(&context->layoutElements, root->layoutElementIndex)->id)->elementId;
+        }
+    }
 }
 
-CLAY_WASM_EXPORT("Clay_CreateArenaWithCapacityAndMemory")
-Clay_Arena Clay_CreateArenaWithCapacityAndMemory(uint32_t capacity, void *offset) {
-    Clay_Arena arena = CLAY__INIT(Clay_Arena) {
-        .capacity = capacity,
-        .memory = (char *)offset
-    };
-    return arena;
+void Clay__ResetRenderCommandFingerprints(Clay__RenderCommandFingerprintArray *fingerprints, Clay__int32_tArray *hashMap) {
+    fingerprints->length = 0;
+    for (int32_t i = 0; i < (int32_t)hashMap->capacity; ++i) {
+        hashMap->internalArray[i] = -1;
+    }
 }
 
-#ifndef CLAY_WASM
-void Clay_SetMeasureTextFunction(Clay_Dimensions (*measureTextFunction)(Clay_String *text, Clay_TextElementConfig *config)) {
-    Clay__MeasureText = measureTextFunction;
+void Clay__AddBorderFingerprintFields(float *fields, Clay_Border border) {
+    fields[0] = (float)border.width;
+    fields[1] = border.color.r;
+    fields[2] = border.color.g;
+    fields[3] = border.color.b;
+    fields[4] = border.color.a;
+}
+
+// Summarises everything about a render command that affects how it's drawn. Configs are hashed field by field, since the bytes of a
+// whole struct include padding. Fields added with the CLAY_EXTEND_CONFIG macros aren't part of the fingerprint.
+uint64_t Clay__FingerprintRenderCommand(Clay_RenderCommand *renderCommand) {
+    Clay_BoundingBox boundingBox = renderCommand->boundingBox;
+    float boxFields[4] = { boundingBox.x, boundingBox.y, boundingBox.width, boundingBox.height };
+    uint64_t hash = Clay__HashBytes(boxFields, sizeof(boxFields), renderCommand->commandType | (uint64_t)renderCommand->zIndex << 32);
+    Clay_ElementConfigUnion config = renderCommand->config;
+    switch (renderCommand->commandType) {
+        case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
+            Clay_RectangleElementConfig *rectangleConfig = config.rectangleElementConfig;
+            Clay_Color color = rectangleConfig->color;
+            Clay_CornerRadius cornerRadius = rectangleConfig->cornerRadius;
+            float fields[8] = { color.r, color.g, color.b, color.a, cornerRadius.topLeft, cornerRadius.topRight, cornerRadius.bottomLeft, cornerRadius.bottomRight };
+            return Clay__HashBytes(fields, sizeof(fields), hash);
+        }
+        case CLAY_RENDER_COMMAND_TYPE_BORDER: {
+            Clay_BorderElementConfig *borderConfig = config.borderElementConfig;
+            Clay_CornerRadius cornerRadius = borderConfig->cornerRadius;
+            float fields[29] = { cornerRadius.topLeft, cornerRadius.topRight, cornerRadius.bottomLeft, cornerRadius.bottomRight };
+            Clay__AddBorderFingerprintFields(&fields[4], borderConfig->left);
+            Clay__AddBorderFingerprintFields(&fields[9], borderConfig->right);
+            Clay__AddBorderFingerprintFields(&fields[14], borderConfig->top);
+            Clay__AddBorderFingerprintFields(&fields[19], borderConfig->bottom);
+            Clay__AddBorderFingerprintFields(&fields[24], borderConfig->betweenChildren);
+            return Clay__HashBytes(fields, sizeof(fields), hash);
+        }
+        case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
+            Clay_ImageElementConfig *imageConfig = config.imageElementConfig;
+            float fields[2] = { imageConfig->sourceDimensions.width, imageConfig->sourceDimensions.height };
+            return Clay__HashBytes(fields, sizeof(fields), hash ^ (uint64_t)(uintptr_t)imageConfig->imageData);
+        }
+        #ifndef CLAY_EXTEND_CONFIG_CUSTOM
+        case CLAY_RENDER_COMMAND_TYPE_CUSTOM: {
+            uint64_t customData = (uint64_t)(uintptr_t)config.customElementConfig->customData;
+            return Clay__HashBytes(&customData, sizeof(customData), hash);
+        }
+        #endif
+        case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+            Clay_TextElementConfig *textConfig = config.textElementConfig;
+            Clay_Color color = textConfig->textColor;
+            uint64_t fontValues = (uint64_t)textConfig->fontId | (uint64_t)textConfig->fontSize << 16 | (uint64_t)textConfig->letterSpacing << 32 | (uint64_t)textConfig->lineHeight << 48;
+            float fields[4] = { color.r, color.g, color.b, color.a };
+            hash = Clay__HashBytes(fields, sizeof(fields), hash ^ fontValues);
+            return Clay__HashStringContents(&renderCommand->text, hash);
+        }
+        default: return hash;
+    }
 }
-void Clay_SetQueryScrollOffsetFunction(Clay_Vector2 (*queryScrollOffsetFunction)(uint32_t elementId)) {
-    Clay__QueryScrollOffset = queryScrollOffsetFunction;
+
+Clay__RenderCommandFingerprint *Clay__GetRenderCommandFingerprint(Clay__RenderCommandFingerprintArray *fingerprints, Clay__int32_tArray *hashMap, uint64_t key) {
+    int32_t fingerprintIndex = hashMap->internalArray[key % hashMap->capacity];
+    while (fingerprintIndex != -1) {
+        Clay__RenderCommandFingerprint *fingerprint = Clay__RenderCommandFingerprintArray_Get(fingerprints, fingerprintIndex);
+        if (fingerprint->key == key) {
+            return fingerprint;
+        }
+        fingerprintIndex = fingerprint->nextIndex;
+    }
+    return CLAY__NULL;
 }
-#endif
 
-CLAY_WASM_EXPORT("Clay_SetLayoutDimensions")
-void Clay_SetLayoutDimensions(Clay_Dimensions dimensions) {
-    Clay__layoutDimensions = dimensions;
+Clay_BoundingBox Clay__BoundingBoxUnion(Clay_BoundingBox a, Clay_BoundingBox b) {
+    float left = CLAY__MIN(a.x, b.x);
+    float top = CLAY__MIN(a.y, b.y);
+    return CLAY__INIT(Clay_BoundingBox) { left, top, CLAY__MAX(a.x + a.width, b.x + b.width) - left, CLAY__MAX(a.y + a.height, b.y + b.height) - top };
 }
 
-CLAY_WASM_EXPORT("Clay_SetPointerState")
-void Clay_SetPointerState(Clay_Vector2 position, bool isPointerDown) {
-    if (Clay__booleanWarnings.maxElementsExceeded) {
+// Adds an area that needs to be redrawn, merging it with existing damage rects when that doesn't add much undamaged area
+void Clay__AddDamageRect(Clay_BoundingBox rect) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    float left = CLAY__MAX(rect.x, 0);
+    float top = CLAY__MAX(rect.y, 0);
+    float right = CLAY__MIN(rect.x + rect.width, context->layoutDimensions.width);
+    float bottom = CLAY__MIN(rect.y + rect.height, context->layoutDimensions.height);
+    if (right <= left || bottom <= top) {
         return;
     }
-    Clay__pointerInfo.position = position;
-    Clay__pointerOverIds.length = 0;
-    Clay__int32_tArray dfsBuffer = Clay__layoutElementChildrenBuffer;
-    for (int rootIndex = Clay__layoutElementTreeRoots.length - 1; rootIndex >= 0; --rootIndex) {
-        dfsBuffer.length = 0;
-        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&Clay__layoutElementTreeRoots, rootIndex);
-        Clay__int32_tArray_Add(&dfsBuffer, (int32_t)root->layoutElementIndex);
-        Clay__treeNodeVisited.internalArray[0] = false;
-        bool found = false;
-        while (dfsBuffer.length > 0) {
-            if (Clay__treeNodeVisited.internalArray[dfsBuffer.length - 1]) {
-                dfsBuffer.length--;
-                continue;
+    rect = CLAY__INIT(Clay_BoundingBox) { left, top, right - left, bottom - top };
+    Clay_DamageRectArray *damageRects = &context->damageRects;
+    while (true) {
+        int32_t mergeIndex = -1;
+        float smallestGrowth = 0;
+        for (int32_t i = 0; i < (int32_t)damageRects->length; ++i) {
+            Clay_BoundingBox existing = damageRects->internalArray[i];
+            Clay_BoundingBox merged = Clay__BoundingBoxUnion(existing, rect);
+            float growth = merged.width * merged.height - existing.width * existing.height - rect.width * rect.height;
+            if (growth <= 0) {
+                mergeIndex = i;
+                break;
             }
-            Clay__treeNodeVisited.internalArray[dfsBuffer.length - 1] = true;
-            Clay_LayoutElement *currentElement = Clay_LayoutElementArray_Get(&Clay__layoutElements, Clay__int32_tArray_Get(&dfsBuffer, (int)dfsBuffer.length - 1));
-            Clay_LayoutElementHashMapItem *mapItem = Clay__GetHashMapItem(currentElement->id); // TODO think of a way around this, maybe the fact that it's essentially a binary tree limits the cost, but the worst case is not great
-            Clay_BoundingBox elementBox = mapItem->boundingBox;
-            elementBox.x -= root->pointerOffset.x;
-            elementBox.y -= root->pointerOffset.y;
-            if (mapItem) {
-                if ((Clay__PointIsInsideRect(position, elementBox))) {
-                    if (mapItem->onHoverFunction) {
-                        mapItem->onHoverFunction(mapItem->elementId, Clay__pointerInfo, mapItem->hoverFunctionUserData);
-                    }
-                    Clay__ElementIdArray_Add(&Clay__pointerOverIds, mapItem->elementId);
-                    found = true;
-                }
-                if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT)) {
-                    dfsBuffer.length--;
-                    continue;
-                }
-                for (int i = currentElement->children.length - 1; i >= 0; --i) {
-                    Clay__int32_tArray_Add(&dfsBuffer, currentElement->children.elements[i]);
-                    Clay__treeNodeVisited.internalArray[dfsBuffer.length - 1] = false; // TODO needs to be ranged checked
-                }
-            } else {
-                dfsBuffer.length--;
+            // Once the list is full, the new rect is merged into whichever damage rect it grows the least
+            if (damageRects->length == damageRects->capacity && (mergeIndex == -1 || growth < smallestGrowth)) {
+                mergeIndex = i;
+                smallestGrowth = growth;
             }
         }
-
-        Clay_LayoutElement *rootElement = Clay_LayoutElementArray_Get(&Clay__layoutElements, root->layoutElementIndex);
-        if (found && Clay__ElementHasConfig(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING_CONTAINER) &&
-                Clay__FindElementConfigWithType(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING_CONTAINER).floatingElementConfig->pointerCaptureMode == CLAY_POINTER_CAPTURE_MODE_CAPTURE) {
+        if (mergeIndex == -1) {
             break;
         }
+        // The merged rect may now overlap others, so it's removed and added again
+        rect = Clay__BoundingBoxUnion(damageRects->internalArray[mergeIndex], rect);
+        damageRects->internalArray[mergeIndex] = damageRects->internalArray[--damageRects->length];
+    }
+    Clay_DamageRectArray_Add(damageRects, rect);
+}
+
+// Compares a fingerprint of each render command against the one with the same id and type from the previous frame. Commands that share
+// an id and type, such as the lines of wrapped text, are matched by the order they appear in.
+void Clay__CalculateRenderCommandDeltas(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__RenderCommandFingerprintArray previousFingerprints = context->renderCommandFingerprints;
+    Clay__int32_tArray previousHashMap = context->renderCommandFingerprintsHashMap;
+    context->renderCommandFingerprints = context->previousRenderCommandFingerprints;
+    context->renderCommandFingerprintsHashMap = context->previousRenderCommandFingerprintsHashMap;
+    context->previousRenderCommandFingerprints = previousFingerprints;
+    context->previousRenderCommandFingerprintsHashMap = previousHashMap;
+    Clay__ResetRenderCommandFingerprints(&context->renderCommandFingerprints, &context->renderCommandFingerprintsHashMap);
+
+    uint64_t previousCommandKey = UINT64_MAX;
+    uint32_t previousCommandOccurrence = 0;
+    for (int32_t i = 0; i < (int32_t)context->renderCommands.length; ++i) {
+        Clay_RenderCommand *renderCommand = Clay_RenderCommandArray_Get(&context->renderCommands, i);
+        uint64_t commandKey = (uint64_t)renderCommand->commandType << 32 | renderCommand->id;
+        // Commands with the same id and type are almost always next to each other, otherwise the earlier ones are counted
+        uint32_t occurrence = 0;
+        if (commandKey == previousCommandKey) {
+            occurrence = previousCommandOccurrence + 1;
+        } else {
+            while (Clay__GetRenderCommandFingerprint(&context->renderCommandFingerprints, &context->renderCommandFingerprintsHashMap, commandKey | (uint64_t)occurrence << 40)) {
+                occurrence++;
+            }
+        }
+        previousCommandKey = commandKey;
+        previousCommandOccurrence = occurrence;
+        uint64_t key = commandKey | (uint64_t)occurrence << 40;
+        uint64_t fingerprint = Clay__FingerprintRenderCommand(renderCommand);
+        Clay_RenderCommandDelta delta = CLAY__INIT(Clay_RenderCommandDelta) { .deltaType = CLAY_RENDER_COMMAND_DELTA_ADDED, .commandType = renderCommand->commandType, .id = renderCommand->id, .renderCommandIndex = i };
+        int32_t *hashBucket = &context->renderCommandFingerprintsHashMap.internalArray[key % context->renderCommandFingerprintsHashMap.capacity];
+        Clay__RenderCommandFingerprintArray_Add(&context->renderCommandFingerprints, CLAY__INIT(Clay__RenderCommandFingerprint) { .key = key, .fingerprint = fingerprint, .boundingBox = renderCommand->boundingBox, .nextIndex = *hashBucket });
+        *hashBucket = context->renderCommandFingerprints.length - 1;
+
+        Clay__RenderCommandFingerprint *previous = Clay__GetRenderCommandFingerprint(&context->previousRenderCommandFingerprints, &context->previousRenderCommandFingerprintsHashMap, key);
+        if (previous) {
+            previous->matched = true;
+            if (previous->fingerprint == fingerprint) {
+                continue;
+            }
+            delta.deltaType = CLAY_RENDER_COMMAND_DELTA_MODIFIED;
+            delta.previousBoundingBox = previous->boundingBox;
+            Clay__AddDamageRect(previous->boundingBox);
+        }
+        Clay_RenderCommandDeltaArray_Add(&context->renderCommandDeltas, delta);
+        Clay__AddDamageRect(renderCommand->boundingBox);
     }
 
-    if (isPointerDown) {
-        if (Clay__pointerInfo.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
-            Clay__pointerInfo.state = CLAY_POINTER_DATA_PRESSED;
-        } else if (Clay__pointerInfo.state != CLAY_POINTER_DATA_PRESSED) {
-            Clay__pointerInfo.state = CLAY_POINTER_DATA_PRESSED_THIS_FRAME;
+    for (int32_t i = 0; i < (int32_t)context->previousRenderCommandFingerprints.length; ++i) {
+        Clay__RenderCommandFingerprint *previous = Clay__RenderCommandFingerprintArray_Get(&context->previousRenderCommandFingerprints, i);
+        if (!previous->matched) {
+            Clay_RenderCommandDeltaArray_Add(&context->renderCommandDeltas, CLAY__INIT(Clay_RenderCommandDelta) {
+                .deltaType = CLAY_RENDER_COMMAND_DELTA_REMOVED,
+                .commandType = (Clay_RenderCommandType)((previous->key >> 32) & 0xFF),
+                .id = (uint32_t)previous->key,
+                .renderCommandIndex = -1,
+                .previousBoundingBox = previous->boundingBox,
+            });
+            Clay__AddDamageRect(previous->boundingBox);
         }
-    } else {
-        if (Clay__pointerInfo.state == CLAY_POINTER_DATA_RELEASED_THIS_FRAME) {
-            Clay__pointerInfo.state = CLAY_POINTER_DATA_RELEASED;
-        } else if (Clay__pointerInfo.state != CLAY_POINTER_DATA_RELEASED)  {
-            Clay__pointerInfo.state = CLAY_POINTER_DATA_RELEASED_THIS_FRAME;
+    }
+}
+
+void Clay__CopyArrayContents(void *destination, const void *source, uint32_t count, uint32_t itemSize) {
+    for (uintptr_t i = 0; i < (uintptr_t)count * itemSize; ++i) {
+        ((char *)destination)[i] = ((const char *)source)[i];
+    }
+}
+
+// Checks that the next frame's ephemeral memory fits in the arena with the settings of `settings`, committing more of the arena if
+// the context has a commit handler. Otherwise reports an error with the given text and returns false.
+bool Clay__EphemeralMemoryFits(Clay_Context *settings, Clay_String errorText) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_Context fakeContext = *settings;
+    fakeContext.internalArena = CLAY__INIT(Clay_Arena) { .capacity = SIZE_MAX, .memory = context->internalArena.memory };
+    Clay_SetCurrentContext(&fakeContext);
+    Clay__InitializeEphemeralMemory(&fakeContext.internalArena);
+    Clay_SetCurrentContext(context);
+    uintptr_t requiredSize = fakeContext.internalArena.nextAllocation;
+    if (requiredSize <= context->internalArena.capacity && (!context->arenaCommitHandler.commitFunction || context->arenaCommitHandler.commitFunction(context->internalArena.memory, requiredSize, context->arenaCommitHandler.userData))) {
+        return true;
+    }
+    context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+        .errorType = CLAY_ERROR_TYPE_ARENA_CAPACITY_EXCEEDED,
+        .errorText = errorText,
+        .userData = context->errorHandler.userData });
+    return false;
+}
+
+// Moves every array sized by maxElementCount to a larger allocation. The new persistent arrays are placed where ephemeral memory
+// used to start, so this can only be called between frames. The space used by the old persistent arrays is not reused.
+bool Clay__GrowElementCapacity(uint32_t maxElementCount) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    // Find out how much memory the grown layout will need without touching the real arena
+    Clay_Context fakeContext = CLAY__INIT(Clay_Context) {
+        .maxElementCount = maxElementCount,
+        .maxMeasureTextCacheWordCount = context->maxMeasureTextCacheWordCount,
+        .ephemeralCapacities = context->ephemeralCapacities,
+        .adaptiveEphemeralCapacities = context->adaptiveEphemeralCapacities,
+        .errorHandler = context->errorHandler,
+        .measureTextBatchFunction = context->measureTextBatchFunction,
+        .renderCommandDeltasEnabled = context->renderCommandDeltasEnabled,
+        .compactRenderCommandsEnabled = context->compactRenderCommandsEnabled,
+        .pointerHitGridEnabled = context->pointerHitGridEnabled,
+        .internalArena = { .nextAllocation = context->arenaResetOffset, .capacity = SIZE_MAX, .memory = context->internalArena.memory },
+    };
+    Clay_SetCurrentContext(&fakeContext);
+    Clay__InitializeElementCountPersistentMemory(&fakeContext.internalArena);
+    fakeContext.arenaResetOffset = fakeContext.internalArena.nextAllocation;
+    Clay__InitializeEphemeralMemory(&fakeContext.internalArena);
+    Clay_SetCurrentContext(context);
+    uintptr_t requiredSize = fakeContext.internalArena.nextAllocation;
+    if (requiredSize > context->internalArena.capacity || !context->arenaCommitHandler.commitFunction(context->internalArena.memory, requiredSize, context->arenaCommitHandler.userData)) {
+        context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+            .errorType = CLAY_ERROR_TYPE_ARENA_CAPACITY_EXCEEDED,
+            .errorText = CLAY_STRING("Clay attempted to grow its element capacity, but the arena couldn't provide enough memory. Try reserving a larger arena."),
+            .userData = context->errorHandler.userData });
+        return false;
+    }
+
+    Clay_Context previous = *context;
+    context->maxElementCount = maxElementCount;
+    context->internalArena.nextAllocation = context->arenaResetOffset;
+    Clay__InitializeElementCountPersistentMemory(&context->internalArena);
+    context->arenaResetOffset = context->internalArena.nextAllocation;
+
+    // Layout element hash map - items keep their indices, but need to be inserted into the larger slot table
+    Clay__CopyArrayContents(context->layoutElementsHashMapInternal.internalArray, previous.layoutElementsHashMapInternal.internalArray, previous.layoutElementsHashMapInternal.length, sizeof(Clay_LayoutElementHashMapItem));
+    context->layoutElementsHashMapInternal.length = previous.layoutElementsHashMapInternal.length;
+    Clay__CopyArrayContents(context->debugElementData.internalArray, previous.debugElementData.internalArray, previous.debugElementData.length, sizeof(Clay__DebugElementData));
+    context->debugElementData.length = previous.debugElementData.length;
+    for (int32_t i = 0; i < (int32_t)context->layoutElementsHashMap.capacity; ++i) {
+        context->layoutElementsHashMap.internalArray[i] = CLAY__INIT(Clay__LayoutElementHashMapSlot) { .itemIndex = -1 };
+    }
+    Clay__CopyArrayContents(context->layoutElementsHashMapInternalFreeList.internalArray, previous.layoutElementsHashMapInternalFreeList.internalArray, previous.layoutElementsHashMapInternalFreeList.length, sizeof(int32_t));
+    context->layoutElementsHashMapInternalFreeList.length = previous.layoutElementsHashMapInternalFreeList.length;
+    for (int32_t i = 0; i < (int32_t)context->layoutElementsHashMapInternal.length; ++i) {
+        Clay_LayoutElementHashMapItem *item = Clay__LayoutElementHashMapItemArray_Get(&context->layoutElementsHashMapInternal, i);
+        if (item->debugData) {
+            item->debugData = context->debugElementData.internalArray + (item->debugData - previous.debugElementData.internalArray);
+        }
+        // Items on the free list aren't in the slot table
+        if (item->generation == 0) {
+            continue;
+        }
+        Clay__InsertHashMapSlot(item->elementId.id, i);
+    }
+
+    // Measure text cache - the buckets depend on maxMeasureTextCacheWordCount and haven't moved, so item indices stay valid
+    Clay__CopyArrayContents(context->measureTextHashMapInternal.internalArray, previous.measureTextHashMapInternal.internalArray, previous.measureTextHashMapInternal.length, sizeof(Clay__MeasureTextCacheItem));
+    context->measureTextHashMapInternal.length = previous.measureTextHashMapInternal.length;
+    Clay__CopyArrayContents(context->measureTextHashMapInternalFreeList.internalArray, previous.measureTextHashMapInternalFreeList.internalArray, previous.measureTextHashMapInternalFreeList.length, sizeof(int32_t));
+    context->measureTextHashMapInternalFreeList.length = previous.measureTextHashMapInternalFreeList.length;
+
+    Clay__CopyArrayContents(context->pointerOverIds.internalArray, previous.pointerOverIds.internalArray, previous.pointerOverIds.length, sizeof(Clay_ElementId));
+    context->pointerOverIds.length = previous.pointerOverIds.length;
+
+    // Only the most recent render command fingerprints are needed to calculate the next frame's deltas
+    Clay__ResetRenderCommandFingerprints(&context->previousRenderCommandFingerprints, &context->previousRenderCommandFingerprintsHashMap);
+    Clay__ResetRenderCommandFingerprints(&context->renderCommandFingerprints, &context->renderCommandFingerprintsHashMap);
+    // Fingerprints kept from before deltas were disabled are stale, and have no space to be copied to
+    if (context->renderCommandDeltasEnabled) {
+        Clay__CopyArrayContents(context->renderCommandFingerprints.internalArray, previous.renderCommandFingerprints.internalArray, previous.renderCommandFingerprints.length, sizeof(Clay__RenderCommandFingerprint));
+        context->renderCommandFingerprints.length = previous.renderCommandFingerprints.length;
+    }
+    for (int32_t i = 0; i < (int32_t)context->renderCommandFingerprints.length; ++i) {
+        Clay__RenderCommandFingerprint *fingerprint = Clay__RenderCommandFingerprintArray_Get(&context->renderCommandFingerprints, i);
+        int32_t *hashBucket = &context->renderCommandFingerprintsHashMap.internalArray[fingerprint->key % context->renderCommandFingerprintsHashMap.capacity];
+        fingerprint->nextIndex = *hashBucket;
+        *hashBucket = i;
+    }
+
+    // The previous frame's render commands were in ephemeral memory, which has just been reused
+    context->previousDeclarationHashValid = false;
+    return true;
+}
+
+// Moves the scroll container data to a larger allocation where ephemeral memory used to start, so this can only be called between frames.
+// Hash map items refer to scroll containers by index, which doesn't change. The space used by the old array is not reused.
+bool Clay__GrowScrollContainerCapacity(uint32_t maxScrollContainerCount) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_Context settings = *context;
+    settings.internalArena = CLAY__INIT(Clay_Arena) { .nextAllocation = context->arenaResetOffset, .capacity = SIZE_MAX, .memory = context->internalArena.memory };
+    Clay__ScrollContainerDataInternalArray_Allocate_Arena(maxScrollContainerCount, &settings.internalArena);
+    settings.arenaResetOffset = settings.internalArena.nextAllocation;
+    if (!Clay__EphemeralMemoryFits(&settings, CLAY_STRING("Clay attempted to grow its scroll container capacity, but the arena couldn't provide enough memory. Try passing a larger arena."))) {
+        return false;
+    }
+    Clay__ScrollContainerDataInternalArray previous = context->scrollContainerDatas;
+    context->internalArena.nextAllocation = context->arenaResetOffset;
+    context->scrollContainerDatas = Clay__ScrollContainerDataInternalArray_Allocate_Arena(maxScrollContainerCount, &context->internalArena);
+    context->arenaResetOffset = context->internalArena.nextAllocation;
+    context->maxScrollContainerCount = maxScrollContainerCount;
+    Clay__CopyArrayContents(context->scrollContainerDatas.internalArray, previous.internalArray, previous.length, sizeof(Clay__ScrollContainerDataInternal));
+    context->scrollContainerDatas.length = previous.length;
+    return true;
+}
+
+void Clay__AdaptEphemeralCapacity(uint32_t *grown, uint32_t *shrunk, uint32_t *highWaterMark, uint32_t minimumCapacity, uint32_t capacity, uint32_t length) {
+    minimumCapacity = Clay__EphemeralCapacity(minimumCapacity);
+    // The high water mark decays slowly, so that a few light frames in a row don't cause the next heavy one to run out of space
+    *highWaterMark = CLAY__MAX(length, *highWaterMark - *highWaterMark / 16);
+    *grown = capacity;
+    *shrunk = capacity;
+    if (length > capacity - capacity / 4) {
+        *grown = capacity * 2;
+    } else if (*highWaterMark < capacity / 4 && capacity / 2 >= minimumCapacity) {
+        *grown = capacity / 2;
+        *shrunk = capacity / 2;
+    }
+}
+
+// Moves space in the ephemeral part of the arena from arrays that were mostly empty last frame to arrays that were nearly full
+void Clay__AdaptEphemeralCapacities(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_EphemeralCapacities grown = context->adaptiveEphemeralCapacities;
+    Clay_EphemeralCapacities shrunk = context->adaptiveEphemeralCapacities;
+    Clay__AdaptEphemeralCapacity(&grown.rectangleElementConfigs, &shrunk.rectangleElementConfigs, &context->adaptiveEphemeralHighWaterMarks.rectangleElementConfigs, context->ephemeralCapacities.rectangleElementConfigs, context->rectangleElementConfigs.capacity, context->rectangleElementConfigs.length);
+    Clay__AdaptEphemeralCapacity(&grown.textElementConfigs, &shrunk.textElementConfigs, &context->adaptiveEphemeralHighWaterMarks.textElementConfigs, context->ephemeralCapacities.textElementConfigs, context->textElementConfigs.capacity, context->textElementConfigs.length);
+    Clay__AdaptEphemeralCapacity(&grown.imageElementConfigs, &shrunk.imageElementConfigs, &context->adaptiveEphemeralHighWaterMarks.imageElementConfigs, context->ephemeralCapacities.imageElementConfigs, context->imageElementConfigs.capacity, context->imageElementConfigs.length);
+    Clay__AdaptEphemeralCapacity(&grown.floatingElementConfigs, &shrunk.floatingElementConfigs, &context->adaptiveEphemeralHighWaterMarks.floatingElementConfigs, context->ephemeralCapacities.floatingElementConfigs, context->floatingElementConfigs.capacity, context->floatingElementConfigs.length);
+    Clay__AdaptEphemeralCapacity(&grown.scrollElementConfigs, &shrunk.scrollElementConfigs, &context->adaptiveEphemeralHighWaterMarks.scrollElementConfigs, context->ephemeralCapacities.scrollElementConfigs, context->scrollElementConfigs.capacity, context->scrollElementConfigs.length);
+    Clay__AdaptEphemeralCapacity(&grown.customElementConfigs, &shrunk.customElementConfigs, &context->adaptiveEphemeralHighWaterMarks.customElementConfigs, context->ephemeralCapacities.customElementConfigs, context->customElementConfigs.capacity, context->customElementConfigs.length);
+    Clay__AdaptEphemeralCapacity(&grown.borderElementConfigs, &shrunk.borderElementConfigs, &context->adaptiveEphemeralHighWaterMarks.borderElementConfigs, context->ephemeralCapacities.borderElementConfigs, context->borderElementConfigs.capacity, context->borderElementConfigs.length);
+    Clay__AdaptEphemeralCapacity(&grown.imageElementPointers, &shrunk.imageElementPointers, &context->adaptiveEphemeralHighWaterMarks.imageElementPointers, context->ephemeralCapacities.imageElementPointers, context->imageElementPointers.capacity, context->imageElementPointers.length);
+    Clay__AdaptEphemeralCapacity(&grown.textElementData, &shrunk.textElementData, &context->adaptiveEphemeralHighWaterMarks.textElementData, context->ephemeralCapacities.textElementData, context->textElementData.capacity, context->textElementData.length);
+    Clay__AdaptEphemeralCapacity(&grown.wrappedTextLines, &shrunk.wrappedTextLines, &context->adaptiveEphemeralHighWaterMarks.wrappedTextLines, context->ephemeralCapacities.wrappedTextLines, context->wrappedTextLines.capacity, context->wrappedTextLines.length);
+    Clay__AdaptEphemeralCapacity(&grown.layoutElementTreeRoots, &shrunk.layoutElementTreeRoots, &context->adaptiveEphemeralHighWaterMarks.layoutElementTreeRoots, context->ephemeralCapacities.layoutElementTreeRoots, context->layoutElementTreeRoots.capacity, context->layoutElementTreeRoots.length);
+    Clay__AdaptEphemeralCapacity(&grown.dynamicStringData, &shrunk.dynamicStringData, &context->adaptiveEphemeralHighWaterMarks.dynamicStringData, context->ephemeralCapacities.dynamicStringData, context->dynamicStringData.capacity, context->dynamicStringData.length);
+    // Shrinking never needs more memory, but there might not be enough room left in the arena to grow
+    Clay_Context fakeContext = CLAY__INIT(Clay_Context) {
+        .maxElementCount = context->maxElementCount,
+        .ephemeralCapacities = context->ephemeralCapacities,
+        .adaptiveEphemeralCapacities = grown,
+        .errorHandler = context->errorHandler,
+        .measureTextBatchFunction = context->measureTextBatchFunction,
+        .renderCommandDeltasEnabled = context->renderCommandDeltasEnabled,
+        .compactRenderCommandsEnabled = context->compactRenderCommandsEnabled,
+        .pointerHitGridEnabled = context->pointerHitGridEnabled,
+        .internalArena = { .capacity = SIZE_MAX, .memory = context->internalArena.memory },
+    };
+    fakeContext.arenaResetOffset = context->arenaResetOffset;
+    Clay_SetCurrentContext(&fakeContext);
+    Clay__InitializeEphemeralMemory(&fakeContext.internalArena);
+    Clay_SetCurrentContext(context);
+    Clay_EphemeralCapacities adapted = fakeContext.internalArena.nextAllocation <= context->internalArena.capacity ? grown : shrunk;
+    for (int32_t i = 0; i < (int32_t)offsetof(Clay_EphemeralCapacities, adaptive); ++i) {
+        if (((char *)&adapted)[i] != ((char *)&context->adaptiveEphemeralCapacities)[i]) {
+            // Arrays are about to move, so configs from the previous frame can't be reused
+            context->previousDeclarationHashValid = false;
+            break;
         }
     }
+    context->adaptiveEphemeralCapacities = adapted;
 }
 
-CLAY_WASM_EXPORT("Clay_Initialize")
-void Clay_Initialize(Clay_Arena arena, Clay_Dimensions layoutDimensions, Clay_ErrorHandler errorHandler) {
-    Clay__internalArena = arena;
-    Clay__InitializePersistentMemory(&Clay__internalArena);
-    Clay__InitializeEphemeralMemory(&Clay__internalArena);
-    for (int i = 0; i < Clay__layoutElementsHashMap.capacity; ++i) {
-        Clay__layoutElementsHashMap.internalArray[i] = -1;
+CLAY_WASM_EXPORT("Clay_CreateContext")
+Clay_Context* Clay_CreateContext(Clay_Arena arena, Clay_Dimensions layoutDimensions, Clay_ErrorHandler errorHandler) {
+    Clay_Context* previousContext = Clay_GetCurrentContext();
+    if (!errorHandler.errorHandlerFunction) {
+        errorHandler.errorHandlerFunction = Clay__ErrorHandlerFunctionDefault;
+    }
+    Clay_ArenaCommitHandler arenaCommitHandler = previousContext ? previousContext->arenaCommitHandler : Clay__defaultArenaCommitHandler;
+    Clay_EphemeralCapacities ephemeralCapacities = previousContext ? previousContext->ephemeralCapacities : Clay__defaultEphemeralCapacities;
+    if (arenaCommitHandler.commitFunction && !arenaCommitHandler.commitFunction(arena.memory, arena.nextAllocation + Clay_MinMemorySize(), arenaCommitHandler.userData)) {
+        errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+            .errorType = CLAY_ERROR_TYPE_ARENA_CAPACITY_EXCEEDED,
+            .errorText = CLAY_STRING("Clay's arena commit function failed to provide the initial memory for a new context."),
+            .userData = errorHandler.userData });
+        return CLAY__NULL;
+    }
+    Clay_Context* context = Clay__Context_Allocate_Arena(&arena);
+    if (!context) {
+        errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+            .errorType = CLAY_ERROR_TYPE_ARENA_CAPACITY_EXCEEDED,
+            .errorText = CLAY_STRING("Clay attempted to allocate memory in its arena, but ran out of capacity. Try increasing the capacity of the arena passed to Clay_Initialize()"),
+            .userData = errorHandler.userData });
+        return CLAY__NULL;
     }
-    for (int i = 0; i < Clay__measureTextHashMap.capacity; ++i) {
-        Clay__measureTextHashMap.internalArray[i] = 0;
+    // New contexts inherit capacity settings from the current context, so that Clay_SetMaxElementCount -> Clay_MinMemorySize -> Clay_Initialize keeps working
+    *context = CLAY__INIT(Clay_Context) {
+        .maxElementCount = previousContext ? previousContext->maxElementCount : Clay__defaultMaxElementCount,
+        .maxMeasureTextCacheWordCount = previousContext ? previousContext->maxMeasureTextCacheWordCount : Clay__defaultMaxMeasureTextCacheWordCount,
+        .maxScrollContainerCount = previousContext ? previousContext->maxScrollContainerCount : Clay__defaultMaxScrollContainerCount,
+        .ephemeralCapacities = ephemeralCapacities,
+        .adaptiveEphemeralCapacities = ephemeralCapacities,
+        .warningsEnabled = true,
+        .errorHandler = errorHandler,
+        .arenaCommitHandler = arenaCommitHandler,
+        .measureTextFunction = previousContext ? previousContext->measureTextFunction : Clay__defaultMeasureTextFunction,
+        .measureTextBatchFunction = previousContext ? previousContext->measureTextBatchFunction : Clay__defaultMeasureTextBatchFunction,
+        .queryScrollOffsetFunction = previousContext ? previousContext->queryScrollOffsetFunction : Clay__defaultQueryScrollOffsetFunction,
+        .pointerInfo = { .position = {-1, -1} },
+        .layoutDimensions = layoutDimensions,
+        .renderCommandDeltasEnabled = previousContext ? previousContext->renderCommandDeltasEnabled : Clay__defaultRenderCommandDeltasEnabled,
+        .compactRenderCommandsEnabled = previousContext ? previousContext->compactRenderCommandsEnabled : Clay__defaultCompactRenderCommandsEnabled,
+        .pointerHitGridEnabled = previousContext ? previousContext->pointerHitGridEnabled : Clay__defaultPointerHitGridEnabled,
+        .internalArena = arena,
+    };
+    Clay_SetCurrentContext(context);
+    Clay__InitializePersistentMemory(&context->internalArena);
+    Clay__InitializeEphemeralMemory(&context->internalArena);
+    if (context->arenaAllocationFailed) {
+        // The error has already been reported by the allocation that failed
+        Clay_SetCurrentContext(previousContext);
+        return CLAY__NULL;
+    }
+    for (int32_t i = 0; i < (int32_t)context->layoutElementsHashMap.capacity; ++i) {
+        context->layoutElementsHashMap.internalArray[i] = CLAY__INIT(Clay__LayoutElementHashMapSlot) { .itemIndex = -1 };
+    }
+    Clay__ResetMeasureTextCaches();
+    Clay__ResetRenderCommandFingerprints(&context->renderCommandFingerprints, &context->renderCommandFingerprintsHashMap);
+    Clay__ResetRenderCommandFingerprints(&context->previousRenderCommandFingerprints, &context->previousRenderCommandFingerprintsHashMap);
+    Clay_SetCurrentContext(previousContext);
+    return context;
+}
+
+CLAY_WASM_EXPORT("Clay_Initialize")
+Clay_Context* Clay_Initialize(Clay_Arena arena, Clay_Dimensions layoutDimensions, Clay_ErrorHandler errorHandler) {
+    Clay_Context* context = Clay_CreateContext(arena, layoutDimensions, errorHandler);
+    if (context) {
+        Clay_SetCurrentContext(context);
     }
-    Clay__measureTextHashMapInternal.length = 1; // Reserve the 0 value to mean "no next element"
-    Clay__layoutDimensions = layoutDimensions;
-    Clay__errorHandler = errorHandler;
+    return context;
+}
+
+CLAY_WASM_EXPORT("Clay_GetCurrentContext")
+Clay_Context* Clay_GetCurrentContext(void) {
+    return Clay__currentContext;
+}
+
+CLAY_WASM_EXPORT("Clay_SetCurrentContext")
+void Clay_SetCurrentContext(Clay_Context* context) {
+    Clay__currentContext = context;
 }
 
 CLAY_WASM_EXPORT("Clay_UpdateScrollContainers")
 void Clay_UpdateScrollContainers(bool enableDragScrolling, Clay_Vector2 scrollDelta, float deltaTime) {
-    bool isPointerActive = enableDragScrolling && (Clay__pointerInfo.state == CLAY_POINTER_DATA_PRESSED || Clay__pointerInfo.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME);
+    Clay_Context* context = Clay_GetCurrentContext();
+    bool isPointerActive = enableDragScrolling && (context->pointerInfo.state == CLAY_POINTER_DATA_PRESSED || context->pointerInfo.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME);
     // Don't apply scroll events to ancestors of the inner element
     int32_t highestPriorityElementIndex = -1;
     Clay__ScrollContainerDataInternal *highestPriorityScrollData = CLAY__NULL;
-    for (int i = 0; i < Clay__scrollContainerDatas.length; i++) {
-        Clay__ScrollContainerDataInternal *scrollData = Clay__ScrollContainerDataInternalArray_Get(&Clay__scrollContainerDatas, i);
+    for (int32_t i = 0; i < (int32_t)context->scrollContainerDatas.length; i++) {
+        Clay__ScrollContainerDataInternal *scrollData = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
         if (!scrollData->openThisFrame) {
-            Clay__ScrollContainerDataInternalArray_RemoveSwapback(&Clay__scrollContainerDatas, i);
+            Clay__RemoveScrollContainerData(i);
             continue;
         }
         scrollData->openThisFrame = false;
         Clay_LayoutElementHashMapItem *hashMapItem = Clay__GetHashMapItem(scrollData->elementId);
         // Element isn't rendered this frame but scroll offset has been retained
         if (!hashMapItem) {
-            Clay__ScrollContainerDataInternalArray_RemoveSwapback(&Clay__scrollContainerDatas, i);
+            Clay__RemoveScrollContainerData(i);
             continue;
         }
 
@@ -3681,11 +6532,9 @@ void Clay_UpdateScrollContainers(bool enableDragScrolling, Clay_Vector2 scrollDe
         }
         scrollData->scrollPosition.y = CLAY__MIN(CLAY__MAX(scrollData->scrollPosition.y, -(CLAY__MAX(scrollData->contentSize.height - scrollData->layoutElement->dimensions.height, 0))), 0);
 
-        for (int j = 0; j < Clay__pointerOverIds.length; ++j) { // TODO n & m are small here but this being n*m gives me the creeps
-            if (scrollData->layoutElement->id == Clay__ElementIdArray_Get(&Clay__pointerOverIds, j)->id) {
-                highestPriorityElementIndex = j;
-                highestPriorityScrollData = scrollData;
-            }
+        if (Clay__PointerIsOver(scrollData->elementId) && (highestPriorityElementIndex == -1 || hashMapItem->pointerOverPriority < (uint32_t)highestPriorityElementIndex)) {
+            highestPriorityElementIndex = (int32_t)hashMapItem->pointerOverPriority;
+            highestPriorityScrollData = scrollData;
         }
     }
 
@@ -3705,26 +6554,26 @@ void Clay_UpdateScrollContainers(bool enableDragScrolling, Clay_Vector2 scrollDe
         if (isPointerActive) {
             highestPriorityScrollData->scrollMomentum = CLAY__INIT(Clay_Vector2){0};
             if (!highestPriorityScrollData->pointerScrollActive) {
-                highestPriorityScrollData->pointerOrigin = Clay__pointerInfo.position;
+                highestPriorityScrollData->pointerOrigin = context->pointerInfo.position;
                 highestPriorityScrollData->scrollOrigin = highestPriorityScrollData->scrollPosition;
                 highestPriorityScrollData->pointerScrollActive = true;
             } else {
                 float scrollDeltaX = 0, scrollDeltaY = 0;
                 if (canScrollHorizontally) {
                     float oldXScrollPosition = highestPriorityScrollData->scrollPosition.x;
-                    highestPriorityScrollData->scrollPosition.x = highestPriorityScrollData->scrollOrigin.x + (Clay__pointerInfo.position.x - highestPriorityScrollData->pointerOrigin.x);
+                    highestPriorityScrollData->scrollPosition.x = highestPriorityScrollData->scrollOrigin.x + (context->pointerInfo.position.x - highestPriorityScrollData->pointerOrigin.x);
                     highestPriorityScrollData->scrollPosition.x = CLAY__MAX(CLAY__MIN(highestPriorityScrollData->scrollPosition.x, 0), -(highestPriorityScrollData->contentSize.width - highestPriorityScrollData->boundingBox.width));
                     scrollDeltaX = highestPriorityScrollData->scrollPosition.x - oldXScrollPosition;
                 }
                 if (canScrollVertically) {
                     float oldYScrollPosition = highestPriorityScrollData->scrollPosition.y;
-                    highestPriorityScrollData->scrollPosition.y = highestPriorityScrollData->scrollOrigin.y + (Clay__pointerInfo.position.y - highestPriorityScrollData->pointerOrigin.y);
+                    highestPriorityScrollData->scrollPosition.y = highestPriorityScrollData->scrollOrigin.y + (context->pointerInfo.position.y - highestPriorityScrollData->pointerOrigin.y);
                     highestPriorityScrollData->scrollPosition.y = CLAY__MAX(CLAY__MIN(highestPriorityScrollData->scrollPosition.y, 0), -(highestPriorityScrollData->contentSize.height - highestPriorityScrollData->boundingBox.height));
                     scrollDeltaY = highestPriorityScrollData->scrollPosition.y - oldYScrollPosition;
                 }
                 if (scrollDeltaX > -0.1f && scrollDeltaX < 0.1f && scrollDeltaY > -0.1f && scrollDeltaY < 0.1f && highestPriorityScrollData->momentumTime > 0.15f) {
                     highestPriorityScrollData->momentumTime = 0;
-                    highestPriorityScrollData->pointerOrigin = Clay__pointerInfo.position;
+                    highestPriorityScrollData->pointerOrigin = context->pointerInfo.position;
                     highestPriorityScrollData->scrollOrigin = highestPriorityScrollData->scrollPosition;
                 } else {
                      highestPriorityScrollData->momentumTime += deltaTime;
@@ -3743,41 +6592,212 @@ void Clay_UpdateScrollContainers(bool enableDragScrolling, Clay_Vector2 scrollDe
 
 CLAY_WASM_EXPORT("Clay_BeginLayout")
 void Clay_BeginLayout(void) {
-    Clay__InitializeEphemeralMemory(&Clay__internalArena);
-    Clay__generation++;
-    Clay__dynamicElementIndex = 0;
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->pendingMaxElementCount > context->maxElementCount) {
+        // Don't retry (and report an error every frame) once the arena has refused a capacity at least this large
+        if (!context->failedMaxElementCount || context->pendingMaxElementCount < context->failedMaxElementCount) {
+            if (!Clay__GrowElementCapacity(context->pendingMaxElementCount)) {
+                context->failedMaxElementCount = context->pendingMaxElementCount;
+            }
+        }
+        context->pendingMaxElementCount = 0;
+    }
+    // Arrays from the previous frame are only partly filled when its layout was skipped
+    if (context->ephemeralCapacities.adaptive && !context->layoutUnchanged) {
+        Clay__AdaptEphemeralCapacities();
+    }
+    context->arenaAllocationFailed = false;
+    if (context->renderCommandDeltasEnabled && context->renderCommandFingerprints.capacity == 0) {
+        // Deltas were enabled after initialization, so their fingerprints go where ephemeral memory used to start
+        context->internalArena.nextAllocation = context->arenaResetOffset;
+        Clay__InitializeRenderCommandFingerprintMemory(&context->internalArena);
+        Clay__ResetRenderCommandFingerprints(&context->renderCommandFingerprints, &context->renderCommandFingerprintsHashMap);
+        Clay__ResetRenderCommandFingerprints(&context->previousRenderCommandFingerprints, &context->previousRenderCommandFingerprintsHashMap);
+        context->arenaResetOffset = context->internalArena.nextAllocation;
+    }
+    if (context->pendingMaxScrollContainerCount > context->maxScrollContainerCount) {
+        // As with the element capacity, don't retry once the arena has refused a capacity at least this large
+        if (!context->failedMaxScrollContainerCount || context->pendingMaxScrollContainerCount < context->failedMaxScrollContainerCount) {
+            if (!Clay__GrowScrollContainerCapacity(CLAY__MAX(context->pendingMaxScrollContainerCount, context->maxScrollContainerCount * 2))) {
+                context->failedMaxScrollContainerCount = context->pendingMaxScrollContainerCount;
+            }
+        }
+        context->pendingMaxScrollContainerCount = 0;
+    }
+    Clay__InitializeEphemeralMemory(&context->internalArena);
+    if (context->measureTextCachesStale) {
+        Clay__ResetMeasureTextCaches();
+    }
+    context->generation++;
+    context->dynamicElementIndex = 0;
     // Set up the root container that covers the entire window
-    Clay_Dimensions rootDimensions = CLAY__INIT(Clay_Dimensions) {Clay__layoutDimensions.width, Clay__layoutDimensions.height};
-    if (Clay__debugModeEnabled) {
+    Clay_Dimensions rootDimensions = CLAY__INIT(Clay_Dimensions) {context->layoutDimensions.width, context->layoutDimensions.height};
+    if (context->debugModeEnabled) {
         rootDimensions.width -= (float)Clay__debugViewWidth;
     }
-    Clay__booleanWarnings.maxElementsExceeded = false;
-    Clay__booleanWarnings.maxTextMeasureCacheExceeded = false;
-    Clay__booleanWarnings.maxRenderCommandsExceeded = false;
+    context->booleanWarnings.maxElementsExceeded = false;
+    context->droppedElementCount = 0;
+    context->booleanWarnings.maxTextMeasureCacheExceeded = false;
+    context->booleanWarnings.arrayCapacityExceeded = false;
+    context->booleanWarnings.maxRenderCommandsExceeded = false;
+    context->memoryStats.measureWordCache.hitCount += context->measureWordCacheStats.hitCount;
+    context->memoryStats.measureWordCache.missCount += context->measureWordCacheStats.missCount;
+    context->measureWordCacheStats = CLAY__INIT(Clay_MeasureWordCacheStats) {};
+    context->declarationHash = 0;
+    if (context->arenaAllocationFailed) {
+        // Some of this frame's arrays have no memory, e.g. after raising the max element count without reinitializing, so nothing is laid out
+        context->booleanWarnings.maxElementsExceeded = true;
+        return;
+    }
     Clay__OpenElement();
     CLAY_ID("Clay__RootContainer");
     CLAY_LAYOUT({ .sizing = {CLAY_SIZING_FIXED((rootDimensions.width)), CLAY_SIZING_FIXED(rootDimensions.height)} });
     Clay__ElementPostConfiguration();
-    Clay__int32_tArray_Add(&Clay__openLayoutElementStack, 0);
-    Clay__LayoutElementTreeRootArray_Add(&Clay__layoutElementTreeRoots, CLAY__INIT(Clay__LayoutElementTreeRoot) { .layoutElementIndex = 0 });
+    Clay__int32_tArray_Add(&context->openLayoutElementStack, 0);
+    Clay__LayoutElementTreeRootArray_Add(&context->layoutElementTreeRoots, CLAY__INIT(Clay__LayoutElementTreeRoot) { .layoutElementIndex = 0 });
+}
+
+// Compares the hash of this frame's declarations and other layout inputs against the previous frame's
+bool Clay__LayoutMatchesPreviousFrame(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    // Externally handled scroll positions are also used while positioning floating elements, which isn't repeated for skipped frames
+    if (!context->idleFrameSkippingEnabled || context->externalScrollHandlingEnabled) {
+        context->previousDeclarationHashValid = false;
+        return false;
+    }
+    bool layoutFlags[2] = { context->debugModeEnabled, context->disableCulling };
+    Clay__HashDeclaration(&context->layoutDimensions, sizeof(Clay_Dimensions));
+    Clay__HashDeclaration(layoutFlags, sizeof(layoutFlags));
+    for (int32_t i = 0; i < (int32_t)context->scrollContainerDatas.length; ++i) {
+        Clay__ScrollContainerDataInternal *scrollContainerData = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
+        Clay__HashDeclaration(&scrollContainerData->elementId, sizeof(uint32_t));
+        Clay__HashDeclaration(&scrollContainerData->scrollPosition, sizeof(Clay_Vector2));
+    }
+    bool matches = context->previousDeclarationHashValid && context->declarationHash == context->previousDeclarationHash;
+    context->previousDeclarationHash = context->declarationHash;
+    context->previousDeclarationHashValid = true;
+    return matches;
 }
 
 Clay_TextElementConfig Clay__DebugView_ErrorTextConfig = CLAY__INIT(Clay_TextElementConfig) {.textColor = {255, 0, 0, 255}, .fontSize = 16, .wrapMode = CLAY_TEXT_WRAP_NONE };
 
+void Clay__BuildCompactRenderCommands(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    // The arrays have no capacity if compact render commands were enabled after this frame's Clay_BeginLayout
+    if (context->compactRenderCommands.capacity < context->renderCommands.length) {
+        return;
+    }
+    // Every command and text fits, so write them directly rather than range checking each one
+    Clay_CompactRenderCommand *compactCommands = context->compactRenderCommands.internalArray;
+    Clay_CompactRenderCommandText *compactTexts = context->compactRenderCommandTexts.internalArray;
+    uint32_t textCount = 0;
+    for (int32_t i = 0; i < (int32_t)context->renderCommands.length; ++i) {
+        Clay_RenderCommand *renderCommand = &context->renderCommands.internalArray[i];
+        Clay_CompactRenderCommand *compactCommand = &compactCommands[i];
+        compactCommand->boundingBox = renderCommand->boundingBox;
+        compactCommand->id = renderCommand->id;
+        compactCommand->commandType = (uint16_t)renderCommand->commandType;
+        compactCommand->zIndex = (uint16_t)renderCommand->zIndex;
+        if (renderCommand->commandType == CLAY_RENDER_COMMAND_TYPE_TEXT) {
+            compactCommand->payload.textIndex = textCount;
+            compactTexts[textCount++] = CLAY__INIT(Clay_CompactRenderCommandText) { .text = renderCommand->text, .config = renderCommand->config.textElementConfig };
+        } else {
+            compactCommand->payload.config = renderCommand->config;
+        }
+    }
+    context->compactRenderCommands.length = context->renderCommands.length;
+    context->compactRenderCommandTexts.length = textCount;
+}
+
+void Clay__UpdateArrayMemoryStats(Clay_ArrayMemoryStats *stats, uint32_t capacity, uint32_t length) {
+    stats->capacity = capacity;
+    stats->length = length;
+    stats->peakLength = CLAY__MAX(stats->peakLength, length);
+}
+
+// Records how full each array is at the end of the layout, which is when the ephemeral arrays are at their longest
+void Clay__UpdateMemoryStats(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_MemoryStats *stats = &context->memoryStats;
+    stats->arenaCapacity = context->internalArena.capacity;
+    stats->arenaUsed = context->internalArena.nextAllocation;
+    stats->persistentMemorySize = context->arenaResetOffset;
+    Clay__UpdateArrayMemoryStats(&stats->layoutElements, context->layoutElements.capacity, context->layoutElements.length);
+    Clay__UpdateArrayMemoryStats(&stats->renderCommands, context->renderCommands.capacity, context->renderCommands.length);
+    Clay__UpdateArrayMemoryStats(&stats->wrappedTextLines, context->wrappedTextLines.capacity, context->wrappedTextLines.length);
+    Clay__UpdateArrayMemoryStats(&stats->layoutConfigs, context->layoutConfigs.capacity, context->layoutConfigs.length);
+    Clay__UpdateArrayMemoryStats(&stats->elementConfigs, context->elementConfigs.capacity, context->elementConfigs.length);
+    Clay__UpdateArrayMemoryStats(&stats->textElementData, context->textElementData.capacity, context->textElementData.length);
+    Clay__UpdateArrayMemoryStats(&stats->layoutElementIdStrings, context->layoutElementIdStrings.capacity, context->layoutElementIdStrings.length);
+    Clay__UpdateArrayMemoryStats(&stats->dynamicStringData, context->dynamicStringData.capacity, context->dynamicStringData.length);
+    Clay__UpdateArrayMemoryStats(&stats->renderCommandDeltas, context->renderCommandDeltas.capacity, context->renderCommandDeltas.length);
+    Clay__UpdateArrayMemoryStats(&stats->warnings, context->warnings.capacity, context->warnings.length);
+    // Items on a free list are allocated, but not in use
+    Clay__UpdateArrayMemoryStats(&stats->layoutElementsHashMapInternal, context->layoutElementsHashMapInternal.capacity, context->layoutElementsHashMapInternal.length - context->layoutElementsHashMapInternalFreeList.length);
+    Clay__UpdateArrayMemoryStats(&stats->measureTextHashMapInternal, context->measureTextHashMapInternal.capacity, context->measureTextHashMapInternal.length - context->measureTextHashMapInternalFreeList.length);
+    Clay__UpdateArrayMemoryStats(&stats->measuredWords, context->measuredWords.capacity, context->measuredWords.length - context->measuredWordsFreeList.length);
+    Clay__UpdateArrayMemoryStats(&stats->measureWordHashMapInternal, context->measureWordHashMapInternal.capacity, context->measureWordHashMapInternal.length - context->measureWordHashMapInternalFreeList.length);
+    Clay__UpdateArrayMemoryStats(&stats->wrappedLineCache, context->wrappedLineCache.capacity, context->wrappedLineCache.length - context->wrappedLineCacheFreeList.length);
+    Clay__UpdateArrayMemoryStats(&stats->scrollContainerDatas, context->scrollContainerDatas.capacity, context->scrollContainerDatas.length);
+}
+
 CLAY_WASM_EXPORT("Clay_EndLayout")
 Clay_RenderCommandArray Clay_EndLayout(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
     Clay__CloseElement();
-    if (Clay__debugModeEnabled) {
-        Clay__warningsEnabled = false;
+    context->pointerHitRecordsValid = false;
+    context->pointerHitGridValid = false;
+    if (context->debugModeEnabled) {
+        context->warningsEnabled = false;
         Clay__RenderDebugView();
-        Clay__warningsEnabled = true;
+        context->warningsEnabled = true;
     }
-    if (Clay__booleanWarnings.maxElementsExceeded) {
-        Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand ) { .boundingBox = { Clay__layoutDimensions.width / 2 - 59 * 4, Clay__layoutDimensions.height / 2 },  .config = { .textElementConfig = &Clay__DebugView_ErrorTextConfig }, .text = CLAY_STRING("Clay Error: Layout elements exceeded Clay__maxElementCount"), .commandType = CLAY_RENDER_COMMAND_TYPE_TEXT });
+    Clay__ResolveMeasureTextBatch();
+    context->layoutUnchanged = false;
+    if (context->booleanWarnings.maxElementsExceeded) {
+        context->previousDeclarationHashValid = false;
+        Clay_String errorText = context->arenaAllocationFailed ? CLAY_STRING("Clay Error: The arena is too small for this frame's layout") : CLAY_STRING("Clay Error: Layout elements exceeded Clay__maxElementCount");
+        Clay__AddRenderCommand(&context->renderCommands, CLAY__INIT(Clay_RenderCommand ) { .boundingBox = { context->layoutDimensions.width / 2 - 59 * 4, context->layoutDimensions.height / 2 },  .config = { .textElementConfig = &Clay__DebugView_ErrorTextConfig }, .text = errorText, .commandType = CLAY_RENDER_COMMAND_TYPE_TEXT });
+    } else if (Clay__LayoutMatchesPreviousFrame()) {
+        // The render commands from the previous frame are still in place, and every config they point to has been stored again at the same address
+        context->layoutUnchanged = true;
+        context->renderCommands.length = context->previousRenderCommandCount;
+        // The roots were declared again in declaration order, and hit testing walks them in zIndex order like the cached commands are drawn
+        Clay__SortLayoutElementTreeRootsByZIndex();
+        // Scroll clamping in Clay_UpdateScrollContainers reads the final dimensions of scroll containers
+        for (int32_t i = 0; i < (int32_t)context->scrollContainerDatas.length; ++i) {
+            Clay__ScrollContainerDataInternal *scrollContainerData = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
+            if (scrollContainerData->openThisFrame) {
+                scrollContainerData->layoutElement->dimensions = CLAY__INIT(Clay_Dimensions) { scrollContainerData->boundingBox.width, scrollContainerData->boundingBox.height };
+            }
+        }
     } else {
+        if (context->textMeasurementDeferred) {
+            Clay__UpdateDeferredTextDimensions(0);
+        }
         Clay__CalculateFinalLayout();
     }
-    return Clay__renderCommands;
+    if (context->renderCommandDeltasEnabled && context->renderCommandFingerprints.capacity > 0 && !context->layoutUnchanged) {
+        Clay__CalculateRenderCommandDeltas();
+    }
+    context->previousRenderCommandCount = context->renderCommands.length;
+    if (context->compactRenderCommandsEnabled) {
+        Clay__BuildCompactRenderCommands();
+    }
+    Clay__UpdateMemoryStats();
+    if (context->arenaCommitHandler.commitFunction) {
+        // Grow before the next frame if this one ran out of capacity, or came close to it
+        uint32_t growthThreshold = context->maxElementCount - context->maxElementCount / 4;
+        if (context->booleanWarnings.maxElementsExceeded || context->booleanWarnings.maxRenderCommandsExceeded || context->layoutElements.length > growthThreshold || context->renderCommands.length > growthThreshold) {
+            uint32_t newMaxElementCount = context->maxElementCount * 2;
+            // Elements dropped after running out of space are counted, so a single resize can fit the whole layout
+            while (newMaxElementCount - newMaxElementCount / 4 < context->layoutElements.length + context->droppedElementCount) {
+                newMaxElementCount *= 2;
+            }
+            context->pendingMaxElementCount = CLAY__MAX(context->pendingMaxElementCount, newMaxElementCount);
+        }
+    }
+    return context->renderCommands;
 }
 
 CLAY_WASM_EXPORT("Clay_GetElementId")
@@ -3791,7 +6811,8 @@ Clay_ElementId Clay_GetElementIdWithIndex(Clay_String idString, uint32_t index)
 }
 
 bool Clay_Hovered(void) {
-    if (Clay__booleanWarnings.maxElementsExceeded) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->booleanWarnings.maxElementsExceeded) {
         return false;
     }
     Clay_LayoutElement *openLayoutElement = Clay__GetOpenLayoutElement();
@@ -3799,16 +6820,12 @@ bool Clay_Hovered(void) {
     if (openLayoutElement->id == 0) {
         Clay__GenerateIdForAnonymousElement(openLayoutElement);
     }
-    for (int i = 0; i < Clay__pointerOverIds.length; ++i) {
-        if (Clay__ElementIdArray_Get(&Clay__pointerOverIds, i)->id == openLayoutElement->id) {
-            return true;
-        }
-    }
-    return false;
+    return Clay__PointerIsOver(openLayoutElement->id);
 }
 
 void Clay_OnHover(void (*onHoverFunction)(Clay_ElementId elementId, Clay_PointerData pointerInfo, intptr_t userData), intptr_t userData) {
-    if (Clay__booleanWarnings.maxElementsExceeded) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->booleanWarnings.maxElementsExceeded) {
         return;
     }
     Clay_LayoutElement *openLayoutElement = Clay__GetOpenLayoutElement();
@@ -3821,55 +6838,379 @@ void Clay_OnHover(void (*onHoverFunction)(Clay_ElementId elementId, Clay_Pointer
 }
 
 CLAY_WASM_EXPORT("Clay_PointerOver")
-bool Clay_PointerOver(Clay_ElementId elementId) { // TODO return priority for separating multiple results
-    for (int i = 0; i < Clay__pointerOverIds.length; ++i) {
-        if (Clay__ElementIdArray_Get(&Clay__pointerOverIds, i)->id == elementId.id) {
-            return true;
-        }
-    }
-    return false;
+bool Clay_PointerOver(Clay_ElementId elementId) {
+    return Clay__PointerIsOver(elementId.id);
+}
+
+CLAY_WASM_EXPORT("Clay_GetPointerOverIds")
+Clay_ElementIdArraySlice Clay_GetPointerOverIds(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    return CLAY__INIT(Clay_ElementIdArraySlice) { .length = context->pointerOverIds.length, .internalArray = context->pointerOverIds.internalArray };
 }
 
 CLAY_WASM_EXPORT("Clay_GetScrollContainerData")
 Clay_ScrollContainerData Clay_GetScrollContainerData(Clay_ElementId id) {
-    for (int i = 0; i < Clay__scrollContainerDatas.length; ++i) {
-        Clay__ScrollContainerDataInternal *scrollContainerData = Clay__ScrollContainerDataInternalArray_Get(&Clay__scrollContainerDatas, i);
-        if (scrollContainerData->elementId == id.id) {
-            return CLAY__INIT(Clay_ScrollContainerData) {
-                .scrollPosition = &scrollContainerData->scrollPosition,
-                .scrollContainerDimensions = CLAY__INIT(Clay_Dimensions) { scrollContainerData->boundingBox.width, scrollContainerData->boundingBox.height },
-                .contentDimensions = scrollContainerData->contentSize,
-                .config = *Clay__FindElementConfigWithType(scrollContainerData->layoutElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER).scrollElementConfig,
-                .found = true
-            };
-        }
+    Clay__ScrollContainerDataInternal *scrollContainerData = Clay__GetScrollContainerDataInternal(id.id);
+    if (scrollContainerData) {
+        return CLAY__INIT(Clay_ScrollContainerData) {
+            .scrollPosition = &scrollContainerData->scrollPosition,
+            .scrollContainerDimensions = CLAY__INIT(Clay_Dimensions) { scrollContainerData->boundingBox.width, scrollContainerData->boundingBox.height },
+            .contentDimensions = scrollContainerData->contentSize,
+            .config = *Clay__FindElementConfigWithType(scrollContainerData->layoutElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER).scrollElementConfig,
+            .found = true
+        };
     }
     return CLAY__INIT(Clay_ScrollContainerData) {};
 }
 
+float Clay__VirtualListItemStride(Clay_VirtualListConfig *config, uint32_t itemIndex, float childGap) {
+    return (config->itemExtentFunction ? config->itemExtentFunction(itemIndex, config->userData) : config->itemExtent) + childGap;
+}
+
+Clay_VirtualListRange Clay_VirtualList(Clay_VirtualListConfig config) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_VirtualListRange range = CLAY__INIT(Clay_VirtualListRange) {};
+    if (context->booleanWarnings.maxElementsExceeded) {
+        return range;
+    }
+    Clay_LayoutElement *openLayoutElement = Clay__GetOpenLayoutElement();
+    Clay_LayoutConfig *layoutConfig = openLayoutElement->layoutConfig;
+    bool vertical = layoutConfig->layoutDirection == CLAY_TOP_TO_BOTTOM;
+    Clay__ScrollContainerDataInternal *scrollData = CLAY__NULL;
+    if (Clay__ElementHasConfig(openLayoutElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER)) {
+        Clay_ScrollElementConfig *scrollConfig = Clay__FindElementConfigWithType(openLayoutElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER).scrollElementConfig;
+        if (vertical ? scrollConfig->vertical : scrollConfig->horizontal) {
+            scrollData = Clay__GetScrollContainerDataInternal(openLayoutElement->id);
+        }
+    }
+    if (!scrollData || scrollData->layoutElement != openLayoutElement) {
+        context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+            .errorType = CLAY_ERROR_TYPE_VIRTUAL_LIST_PARENT_NOT_SCROLLING,
+            .errorText = CLAY_STRING("Clay_VirtualList was called inside an element that doesn't scroll along its layout direction."),
+            .userData = context->errorHandler.userData });
+        return range;
+    }
+    if (config.itemCount == 0) {
+        return range;
+    }
+
+    // The visible part of the content is known from the previous layout, which is as up to date as the scroll position itself
+    float childGap = (float)layoutConfig->childGap;
+    float estimatedStride = config.itemExtent + childGap;
+    float viewportExtent = vertical ? scrollData->boundingBox.height : scrollData->boundingBox.width;
+    if (viewportExtent <= 0) {
+        viewportExtent = vertical ? context->layoutDimensions.height : context->layoutDimensions.width;
+    }
+    float contentStart = -(vertical ? scrollData->scrollPosition.y : scrollData->scrollPosition.x) - (vertical ? layoutConfig->padding.y : layoutConfig->padding.x);
+    float contentEnd = contentStart + viewportExtent;
+
+    // Find the first visible item. Fixed extents give its index directly, otherwise the search starts from the previous frame's
+    // first visible item, so that scrolling only visits the items that were scrolled past.
+    uint32_t firstIndex = 0;
+    float firstOffset = 0;
+    if (contentStart > 0 && !config.itemExtentFunction) {
+        if (estimatedStride > 0) {
+            firstIndex = (uint32_t)CLAY__MIN(contentStart / estimatedStride, (float)(config.itemCount - 1));
+            firstOffset = (float)firstIndex * estimatedStride;
+        }
+    } else if (contentStart > 0) {
+        firstIndex = scrollData->virtualListAnchorIndex;
+        firstOffset = scrollData->virtualListAnchorOffset;
+        if (firstIndex >= config.itemCount) {
+            firstIndex = 0;
+            firstOffset = 0;
+        }
+        // Jumps of more than a screen, such as dragging a scroll bar, move by the estimated extent rather than measuring every item in between
+        if (estimatedStride > 0 && (contentStart - firstOffset > viewportExtent || firstOffset - contentStart > viewportExtent)) {
+            float targetIndex = CLAY__MIN(CLAY__MAX((float)firstIndex + (contentStart - firstOffset) / estimatedStride, 0), (float)(config.itemCount - 1));
+            firstOffset += (float)((int64_t)targetIndex - (int64_t)firstIndex) * estimatedStride;
+            firstIndex = (uint32_t)targetIndex;
+        }
+        while (firstIndex > 0 && firstOffset > contentStart) {
+            firstIndex--;
+            firstOffset -= Clay__VirtualListItemStride(&config, firstIndex, childGap);
+        }
+        float stride = Clay__VirtualListItemStride(&config, firstIndex, childGap);
+        while (firstIndex + 1 < config.itemCount && firstOffset + stride <= contentStart) {
+            firstOffset += stride;
+            firstIndex++;
+            stride = Clay__VirtualListItemStride(&config, firstIndex, childGap);
+        }
+    }
+    range.startIndex = firstIndex;
+    float startOffset = firstOffset;
+    for (uint32_t i = 0; i < config.overscan && range.startIndex > 0; ++i) {
+        range.startIndex--;
+        startOffset -= Clay__VirtualListItemStride(&config, range.startIndex, childGap);
+    }
+    if (contentStart > 0 && config.itemExtentFunction) {
+        // The items before the range are always estimated, so that estimates don't build up as the list is scrolled back towards its start.
+        // The scroll position moves by the same amount, so the first visible item stays where it was measured to be on screen.
+        float correction = CLAY__MAX((float)range.startIndex * estimatedStride - startOffset, -contentStart);
+        startOffset += correction;
+        firstOffset += correction;
+        contentEnd += correction;
+        if (vertical) {
+            scrollData->scrollPosition.y -= correction;
+            scrollData->scrollOrigin.y -= scrollData->pointerScrollActive ? correction : 0;
+        } else {
+            scrollData->scrollPosition.x -= correction;
+            scrollData->scrollOrigin.x -= scrollData->pointerScrollActive ? correction : 0;
+        }
+    }
+    range.endIndex = firstIndex;
+    float endOffset = firstOffset;
+    while (range.endIndex < config.itemCount && endOffset < contentEnd) {
+        endOffset += Clay__VirtualListItemStride(&config, range.endIndex, childGap);
+        range.endIndex++;
+    }
+    range.endIndex = (uint32_t)CLAY__MIN((uint64_t)range.endIndex + config.overscan, (uint64_t)config.itemCount);
+
+    // The items outside the range are replaced by spacers, so the content keeps its full size for scrolling and momentum
+    scrollData->virtualListAnchorIndex = firstIndex;
+    scrollData->virtualListAnchorOffset = firstOffset;
+    scrollData->virtualListFirstChildIndex = range.startIndex;
+    if (range.startIndex > 0) {
+        Clay__DeclareVirtualListSpacer(CLAY_STRING("Clay__VirtualListLeadingSpacer"), startOffset, childGap, vertical);
+        scrollData->virtualListFirstChildIndex--;
+    }
+    scrollData->virtualListTrailingExtent = (float)(config.itemCount - range.endIndex) * estimatedStride;
+    scrollData->virtualListOpen = true;
+    return range;
+}
+
 CLAY_WASM_EXPORT("Clay_SetDebugModeEnabled")
 void Clay_SetDebugModeEnabled(bool enabled) {
-    Clay__debugModeEnabled = enabled;
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->debugModeEnabled = enabled;
 }
 
 CLAY_WASM_EXPORT("Clay_SetCullingEnabled")
 void Clay_SetCullingEnabled(bool enabled) {
-    Clay__disableCulling = !enabled;
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->disableCulling = !enabled;
+}
+
+CLAY_WASM_EXPORT("Clay_SetRenderCommandDeltasEnabled")
+void Clay_SetRenderCommandDeltasEnabled(bool enabled) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (!context) {
+        Clay__defaultRenderCommandDeltasEnabled = enabled;
+        return;
+    }
+    if (enabled && !context->renderCommandDeltasEnabled && context->renderCommandFingerprints.capacity == 0) {
+        // The fingerprints are allocated at the start of the next frame, in front of its ephemeral memory
+        Clay_Context settings = *context;
+        settings.renderCommandDeltasEnabled = true;
+        settings.internalArena = CLAY__INIT(Clay_Arena) { .nextAllocation = context->arenaResetOffset, .capacity = SIZE_MAX, .memory = context->internalArena.memory };
+        Clay_SetCurrentContext(&settings);
+        Clay__InitializeRenderCommandFingerprintMemory(&settings.internalArena);
+        Clay_SetCurrentContext(context);
+        settings.arenaResetOffset = settings.internalArena.nextAllocation;
+        if (!Clay__EphemeralMemoryFits(&settings, CLAY_STRING("Clay couldn't enable render command deltas, since the arena doesn't have room for them. Enable them before calling Clay_MinMemorySize() and Clay_Initialize(), or pass a larger arena."))) {
+            return;
+        }
+    }
+    if (enabled && !context->renderCommandDeltasEnabled) {
+        // Fingerprints from before deltas were disabled are stale, so report everything in the next frame as added
+        Clay__ResetRenderCommandFingerprints(&context->renderCommandFingerprints, &context->renderCommandFingerprintsHashMap);
+    }
+    context->renderCommandDeltasEnabled = enabled;
+}
+
+CLAY_WASM_EXPORT("Clay_SetCompactRenderCommandsEnabled")
+void Clay_SetCompactRenderCommandsEnabled(bool enabled) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (!context) {
+        Clay__defaultCompactRenderCommandsEnabled = enabled;
+        return;
+    }
+    if (enabled && !context->compactRenderCommandsEnabled) {
+        Clay_Context settings = *context;
+        settings.compactRenderCommandsEnabled = true;
+        if (!Clay__EphemeralMemoryFits(&settings, CLAY_STRING("Clay couldn't enable compact render commands, since the arena doesn't have room for them. Enable them before calling Clay_MinMemorySize() and Clay_Initialize(), or pass a larger arena."))) {
+            return;
+        }
+    }
+    context->compactRenderCommandsEnabled = enabled;
+}
+
+CLAY_WASM_EXPORT("Clay_SetPointerHitGridEnabled")
+void Clay_SetPointerHitGridEnabled(bool enabled) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (!context) {
+        Clay__defaultPointerHitGridEnabled = enabled;
+        return;
+    }
+    if (enabled && !context->pointerHitGridEnabled) {
+        Clay_Context settings = *context;
+        settings.pointerHitGridEnabled = true;
+        if (!Clay__EphemeralMemoryFits(&settings, CLAY_STRING("Clay couldn't enable the pointer hit grid, since the arena doesn't have room for it. Enable it before calling Clay_MinMemorySize() and Clay_Initialize(), or pass a larger arena."))) {
+            return;
+        }
+    }
+    context->pointerHitGridEnabled = enabled;
+    context->pointerHitRecordsValid = false;
+    context->pointerHitGridValid = false;
+}
+
+CLAY_WASM_EXPORT("Clay_GetCompactRenderCommands")
+Clay_CompactRenderCommands Clay_GetCompactRenderCommands(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    return CLAY__INIT(Clay_CompactRenderCommands) { .commands = context->compactRenderCommands, .texts = context->compactRenderCommandTexts };
+}
+
+CLAY_WASM_EXPORT("Clay_GetRenderCommandDeltas")
+Clay_RenderCommandDeltaArray Clay_GetRenderCommandDeltas(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    return context->renderCommandDeltas;
+}
+
+CLAY_WASM_EXPORT("Clay_SetIdleFrameSkippingEnabled")
+void Clay_SetIdleFrameSkippingEnabled(bool enabled) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->idleFrameSkippingEnabled = enabled;
+    context->previousDeclarationHashValid = false;
+}
+
+CLAY_WASM_EXPORT("Clay_LayoutUnchanged")
+bool Clay_LayoutUnchanged(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    return context->layoutUnchanged;
+}
+
+CLAY_WASM_EXPORT("Clay_GetDamageRects")
+Clay_DamageRectArray Clay_GetDamageRects(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    return context->damageRects;
+}
+
+CLAY_WASM_EXPORT("Clay_GetMeasureWordCacheStats")
+Clay_MeasureWordCacheStats Clay_GetMeasureWordCacheStats(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    return context->measureWordCacheStats;
+}
+
+#ifndef CLAY_WASM
+void Clay_SetParallelLayoutHandler(Clay_ParallelLayoutHandler handler) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->parallelLayoutHandler = handler;
+}
+#endif
+
+// Walks every chain in a hash map. nextIndexOffset is the offset of the int32_t nextIndex field within each item.
+Clay_HashMapMemoryStats Clay__GetHashMapMemoryStats(Clay__int32_tArray buckets, int32_t emptyBucket, void *items, uint32_t itemSize, uint32_t nextIndexOffset) {
+    Clay_HashMapMemoryStats stats = CLAY__INIT(Clay_HashMapMemoryStats) { .bucketCount = buckets.capacity };
+    for (int32_t i = 0; i < (int32_t)buckets.capacity; ++i) {
+        uint32_t chainLength = 0;
+        for (int32_t itemIndex = buckets.internalArray[i]; itemIndex != emptyBucket; ++chainLength) {
+            itemIndex = *(int32_t *)((char *)items + (uintptr_t)itemIndex * itemSize + nextIndexOffset);
+        }
+        if (chainLength > 0) {
+            stats.usedBucketCount++;
+            stats.itemCount += chainLength;
+            stats.maxChainLength = CLAY__MAX(stats.maxChainLength, chainLength);
+        }
+    }
+    stats.averageChainLength = stats.usedBucketCount > 0 ? (float)stats.itemCount / (float)stats.usedBucketCount : 0;
+    return stats;
+}
+
+// The element hash map is open addressed, so its chains are the probe sequences - the number of slots read to find each item
+Clay_HashMapMemoryStats Clay__GetLayoutElementHashMapMemoryStats(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_HashMapMemoryStats stats = CLAY__INIT(Clay_HashMapMemoryStats) { .bucketCount = context->layoutElementsHashMap.capacity };
+    uint32_t slotMask = context->layoutElementsHashMap.capacity - 1;
+    uint32_t totalProbeLength = 0;
+    for (uint32_t i = 0; i < context->layoutElementsHashMap.capacity; ++i) {
+        Clay__LayoutElementHashMapSlot slot = context->layoutElementsHashMap.internalArray[i];
+        if (slot.itemIndex != -1) {
+            uint32_t probeLength = ((i - (slot.id & slotMask)) & slotMask) + 1;
+            stats.usedBucketCount++;
+            stats.itemCount++;
+            stats.maxChainLength = CLAY__MAX(stats.maxChainLength, probeLength);
+            totalProbeLength += probeLength;
+        }
+    }
+    stats.averageChainLength = stats.itemCount > 0 ? (float)totalProbeLength / (float)stats.itemCount : 0;
+    return stats;
+}
+
+CLAY_WASM_EXPORT("Clay_GetMemoryStats")
+Clay_MemoryStats Clay_GetMemoryStats(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_MemoryStats stats = context->memoryStats;
+    stats.layoutElementsHashMap = Clay__GetLayoutElementHashMapMemoryStats();
+    stats.measureTextHashMap = Clay__GetHashMapMemoryStats(context->measureTextHashMap, 0, context->measureTextHashMapInternal.internalArray, sizeof(Clay__MeasureTextCacheItem), offsetof(Clay__MeasureTextCacheItem, nextIndex));
+    stats.measureWordHashMap = Clay__GetHashMapMemoryStats(context->measureWordHashMap, 0, context->measureWordHashMapInternal.internalArray, sizeof(Clay__MeasureWordCacheItem), offsetof(Clay__MeasureWordCacheItem, nextIndex));
+    // Include the words measured so far this frame
+    stats.measureWordCache.hitCount += context->measureWordCacheStats.hitCount;
+    stats.measureWordCache.missCount += context->measureWordCacheStats.missCount;
+    return stats;
+}
+
+#ifndef CLAY_WASM
+void Clay_SetArenaCommitHandler(Clay_ArenaCommitHandler handler) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context) {
+        context->arenaCommitHandler = handler;
+    } else {
+        Clay__defaultArenaCommitHandler = handler;
+    }
 }
+#endif
 
 CLAY_WASM_EXPORT("Clay_SetExternalScrollHandlingEnabled")
 void Clay_SetExternalScrollHandlingEnabled(bool enabled) {
-    Clay__externalScrollHandlingEnabled = enabled;
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->externalScrollHandlingEnabled = enabled;
+}
+
+CLAY_WASM_EXPORT("Clay_GetMaxElementCount")
+uint32_t Clay_GetMaxElementCount(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    return context ? context->maxElementCount : Clay__defaultMaxElementCount;
 }
 
 CLAY_WASM_EXPORT("Clay_SetMaxElementCount")
 void Clay_SetMaxElementCount(uint32_t maxElementCount) {
-    Clay__maxElementCount = maxElementCount;
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context && context->arenaCommitHandler.commitFunction) {
+        // Contexts with an arena commit handler can grow in place at the start of the next frame
+        context->pendingMaxElementCount = maxElementCount;
+    } else if (context) {
+        context->maxElementCount = maxElementCount;
+    } else {
+        Clay__defaultMaxElementCount = maxElementCount;
+    }
+}
+
+CLAY_WASM_EXPORT("Clay_SetEphemeralCapacities")
+void Clay_SetEphemeralCapacities(Clay_EphemeralCapacities capacities) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context) {
+        context->ephemeralCapacities = capacities;
+        context->adaptiveEphemeralCapacities = capacities;
+        context->adaptiveEphemeralHighWaterMarks = CLAY__INIT(Clay_EphemeralCapacities) {};
+    } else {
+        Clay__defaultEphemeralCapacities = capacities;
+    }
+}
+
+CLAY_WASM_EXPORT("Clay_GetMaxMeasureTextCacheWordCount")
+uint32_t Clay_GetMaxMeasureTextCacheWordCount(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    return context ? context->maxMeasureTextCacheWordCount : Clay__defaultMaxMeasureTextCacheWordCount;
 }
 
 CLAY_WASM_EXPORT("Clay_SetMaxMeasureTextCacheWordCount")
 void Clay_SetMaxMeasureTextCacheWordCount(uint32_t maxMeasureTextCacheWordCount) {
-    Clay__maxMeasureTextCacheWordCount = maxMeasureTextCacheWordCount;
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context) {
+        context->maxMeasureTextCacheWordCount = maxMeasureTextCacheWordCount;
+    } else {
+        Clay__defaultMaxMeasureTextCacheWordCount = maxMeasureTextCacheWordCount;
+    }
 }
 
 #endif //CLAY_IMPLEMENTATION
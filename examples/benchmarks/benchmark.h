@@ -0,0 +1,26 @@
+// Timing helpers shared by the benchmarks. Each benchmark prints one line per configuration, so runs can be compared with diff.
+#pragma once
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static double Benchmark_NowSeconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+// Runs frameFunction until at least a quarter of a second has passed and returns the fastest single run, in seconds,
+// which is less affected by other processes than the mean
+static double Benchmark_FastestRun(void (*frameFunction)(void *userData), void *userData) {
+    double fastest = 1e30;
+    double start = Benchmark_NowSeconds();
+    for (int runs = 0; runs < 5 || Benchmark_NowSeconds() - start < 0.25; ++runs) {
+        double runStart = Benchmark_NowSeconds();
+        frameFunction(userData);
+        double elapsed = Benchmark_NowSeconds() - runStart;
+        fastest = elapsed < fastest ? elapsed : fastest;
+    }
+    return fastest;
+}
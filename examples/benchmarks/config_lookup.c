@@ -0,0 +1,61 @@
+// Lays out a table of about 50k elements with text, images, borders, scroll containers and floating tooltips, then looks up every
+// element's configs by type the way the layout passes do. With each type's slot recorded, a lookup shouldn't depend on the config count.
+#include "benchmark.h"
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+
+#define ROW_COUNT 9600
+
+Clay_Dimensions MeasureText(Clay_String *text, Clay_TextElementConfig *config) {
+    return (Clay_Dimensions) { (float)text->length * 6, 12 };
+}
+
+void LayoutFrame(void *userData) {
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("Table"), CLAY_LAYOUT({ .layoutDirection = CLAY_TOP_TO_BOTTOM })) {
+        for (int i = 0; i < ROW_COUNT; ++i) {
+            CLAY(CLAY_IDI("Row", i), CLAY_LAYOUT({ .childGap = 4 }), CLAY_SCROLL({ .horizontal = true }), CLAY_BORDER({ .bottom = { 1, { 200, 200, 200, 255 } } })) {
+                CLAY(CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIXED(24), CLAY_SIZING_FIXED(24) } }), CLAY_IMAGE({ .sourceDimensions = { 24, 24 } })) {}
+                CLAY(CLAY_LAYOUT({ .padding = { 4, 4 } }), CLAY_RECTANGLE({ .color = { 240, 240, 240, 255 } })) {
+                    CLAY_TEXT(CLAY_STRING("Cell text"), CLAY_TEXT_CONFIG({ .fontSize = 12 }));
+                }
+                CLAY(CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIXED(60), CLAY_SIZING_FIXED(20) } }), CLAY_BORDER_OUTSIDE({ 1, { 0, 0, 0, 255 } })) {
+                    if (i % 10 == 0) {
+                        CLAY(CLAY_FLOATING({ .attachment = { .element = CLAY_ATTACH_POINT_LEFT_BOTTOM, .parent = CLAY_ATTACH_POINT_LEFT_TOP } }), CLAY_RECTANGLE({ .color = { 40, 40, 40, 255 } })) {
+                            CLAY_TEXT(CLAY_STRING("Tooltip"), CLAY_TEXT_CONFIG({ .fontSize = 12 }));
+                        }
+                    }
+                }
+            }
+        }
+    }
+    Clay_EndLayout();
+}
+
+uintptr_t checksum;
+
+void LookupConfigs(void *userData) {
+    Clay_LayoutElementArray *layoutElements = &Clay_GetCurrentContext()->layoutElements;
+    for (int32_t i = 0; i < layoutElements->length; ++i) {
+        Clay_LayoutElement *element = &layoutElements->internalArray[i];
+        for (int32_t type = CLAY__ELEMENT_CONFIG_TYPE_RECTANGLE; type <= CLAY__ELEMENT_CONFIG_TYPE_CUSTOM; type <<= 1) {
+            if (Clay__ElementHasConfig(element, (Clay__ElementConfigType)type)) {
+                checksum += (uintptr_t)Clay__FindElementConfigWithType(element, (Clay__ElementConfigType)type).rectangleElementConfig;
+            }
+        }
+    }
+}
+
+int main(void) {
+    Clay_SetMaxElementCount(65536);
+    uint64_t totalMemorySize = Clay_MinMemorySize();
+    void *memory = malloc(totalMemorySize);
+    Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, memory), (Clay_Dimensions) { 1024, 768 }, (Clay_ErrorHandler) {});
+    Clay_SetMeasureTextFunction(MeasureText);
+    LayoutFrame(NULL);
+    double layoutSeconds = Benchmark_FastestRun(LayoutFrame, NULL);
+    double lookupSeconds = Benchmark_FastestRun(LookupConfigs, NULL);
+    printf("%d elements: %.3f ms per layout, %.3f ms to look up every config type on every element\n", Clay_GetCurrentContext()->layoutElements.length, layoutSeconds * 1e3, lookupSeconds * 1e3);
+    free(memory);
+    return checksum == 0;
+}
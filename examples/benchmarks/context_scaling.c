@@ -0,0 +1,75 @@
+// Runs Clay_BeginLayout -> Clay_EndLayout on one context per thread at the same time, and reports how the total number of frames
+// per second scales with the number of threads. Contexts don't share any state, so this should be close to linear up to the
+// number of cores.
+#define _DEFAULT_SOURCE
+#include "benchmark.h"
+#include <pthread.h>
+#include <unistd.h>
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+
+#define FRAME_COUNT 200
+
+Clay_Dimensions MeasureText(Clay_String *text, Clay_TextElementConfig *config) {
+    return (Clay_Dimensions) { (float)text->length * config->fontSize * 0.5f, (float)config->fontSize };
+}
+
+// A dashboard of cards with wrapped text, which exercises sizing, text measurement and wrapping
+void LayoutFrame(void) {
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("Dashboard"), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_GROW({}), CLAY_SIZING_GROW({}) }, .layoutDirection = CLAY_TOP_TO_BOTTOM, .childGap = 8 })) {
+        for (int row = 0; row < 40; ++row) {
+            CLAY(CLAY_IDI("Row", row), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_GROW({}) }, .childGap = 8 })) {
+                for (int column = 0; column < 10; ++column) {
+                    CLAY(CLAY_IDI("Card", row * 10 + column), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_GROW({}) }, .padding = { 8, 8 } }), CLAY_RECTANGLE({ .color = { 200, 200, 200, 255 } })) {
+                        CLAY_TEXT(CLAY_STRING("Quarterly revenue grew in every region except the one we forgot to measure"), CLAY_TEXT_CONFIG({ .fontSize = 12 }));
+                    }
+                }
+            }
+        }
+    }
+    Clay_EndLayout();
+}
+
+void *RunContext(void *userData) {
+    // The current context is thread local, so each thread starts without one and creates its own
+    uint64_t totalMemorySize = Clay_MinMemorySize();
+    void *memory = malloc(totalMemorySize);
+    Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, memory), (Clay_Dimensions) { 1920, 1080 }, (Clay_ErrorHandler) {});
+    Clay_SetMeasureTextFunction(MeasureText);
+    for (int frame = 0; frame < FRAME_COUNT; ++frame) {
+        LayoutFrame();
+    }
+    Clay_SetCurrentContext(NULL);
+    free(memory);
+    return NULL;
+}
+
+// The time for every thread to lay out FRAME_COUNT frames with its own context
+void RunThreads(void *userData) {
+    int threadCount = *(int *)userData;
+    pthread_t threads[256];
+    for (int i = 0; i < threadCount; ++i) {
+        pthread_create(&threads[i], NULL, RunContext, NULL);
+    }
+    for (int i = 0; i < threadCount; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+int main(void) {
+    int coreCount = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    coreCount = coreCount < 1 ? 1 : coreCount > 256 ? 256 : coreCount;
+    double singleThreadRate = 0;
+    // Doubles the thread count each time, finishing with one thread per core
+    for (int threadCount = 1; ; threadCount = CLAY__MIN(threadCount * 2, coreCount)) {
+        double seconds = Benchmark_FastestRun(RunThreads, &threadCount);
+        double rate = (double)threadCount * FRAME_COUNT / seconds;
+        singleThreadRate = threadCount == 1 ? rate : singleThreadRate;
+        printf("%3d threads: %8.0f frames per second, %5.2fx the single thread rate (%3.0f%% efficiency)\n", threadCount, rate, rate / singleThreadRate, 100 * rate / singleThreadRate / threadCount);
+        if (threadCount == coreCount) {
+            break;
+        }
+    }
+    return 0;
+}
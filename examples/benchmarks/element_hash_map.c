@@ -0,0 +1,53 @@
+// Looks up random element ids in the element hash map after laying out a flat list of elements, both ids that were declared and ids
+// that weren't, as pointer handling and scroll lookups do. With an open-addressing slot table, a lookup should stay near one cache miss.
+#include "benchmark.h"
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+
+#define LOOKUP_COUNT 1000000
+
+int elementCount;
+uint32_t lookupIds[LOOKUP_COUNT];
+uintptr_t checksum;
+
+void LayoutFrame(void) {
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("List"), CLAY_LAYOUT({ .layoutDirection = CLAY_TOP_TO_BOTTOM })) {
+        for (int i = 0; i < elementCount; ++i) {
+            CLAY(CLAY_IDI("Item", i), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIXED(100), CLAY_SIZING_FIXED(20) } })) {}
+        }
+    }
+    Clay_EndLayout();
+}
+
+void LookupElements(void *userData) {
+    for (int i = 0; i < LOOKUP_COUNT; ++i) {
+        checksum += (uintptr_t)Clay__GetHashMapItem(lookupIds[i]);
+    }
+}
+
+// Ids of declared elements are looked up under the label they were declared with, and missing ones under a label that was never used
+double TimeLookups(const char *label, int labelLength) {
+    for (int i = 0; i < LOOKUP_COUNT; ++i) {
+        lookupIds[i] = Clay_GetElementIdWithIndex(CLAY__INIT(Clay_String) { .length = labelLength, .chars = label }, (uint32_t)(rand() % elementCount)).id;
+    }
+    return Benchmark_FastestRun(LookupElements, NULL);
+}
+
+int main(void) {
+    int counts[] = { 10000, 100000 };
+    Clay_SetMaxElementCount(131072);
+    uint64_t totalMemorySize = Clay_MinMemorySize();
+    void *memory = malloc(totalMemorySize);
+    srand(1);
+    for (int i = 0; i < (int)(sizeof(counts) / sizeof(counts[0])); ++i) {
+        elementCount = counts[i];
+        Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, memory), (Clay_Dimensions) { 1024, 768 }, (Clay_ErrorHandler) {});
+        LayoutFrame();
+        double hitSeconds = TimeLookups("Item", 4);
+        double missSeconds = TimeLookups("Missing", 7);
+        printf("%6d elements: %5.1f ns per hit, %5.1f ns per miss\n", elementCount, hitSeconds * 1e9 / LOOKUP_COUNT, missSeconds * 1e9 / LOOKUP_COUNT);
+    }
+    free(memory);
+    return checksum == 0;
+}
@@ -0,0 +1,98 @@
+// Compares walking Clay_RenderCommand with walking the compact render command stream from Clay_GetCompactRenderCommands, on a frame
+// of 100k commands split evenly between rectangles and text, and measures what building the compact stream costs.
+#include "benchmark.h"
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+
+#define ELEMENT_PAIR_COUNT 50000
+
+Clay_Dimensions MeasureText(Clay_String *text, Clay_TextElementConfig *config) {
+    return (Clay_Dimensions) { (float)text->length * 6, 12 };
+}
+
+void LayoutFrame(void *userData) {
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("Grid"), CLAY_LAYOUT({ .layoutDirection = CLAY_TOP_TO_BOTTOM })) {
+        for (int i = 0; i < ELEMENT_PAIR_COUNT; ++i) {
+            CLAY(CLAY_IDI("Cell", i), CLAY_RECTANGLE({ .color = { (float)(i % 255), 0, 0, 255 } })) {
+                CLAY_TEXT(CLAY_STRING("Cell"), CLAY_TEXT_CONFIG({ .fontSize = 12 }));
+            }
+        }
+    }
+    Clay_EndLayout();
+}
+
+Clay_RenderCommandArray renderCommands;
+Clay_CompactRenderCommands compactRenderCommands;
+float checksum;
+
+// What a renderer does with every command: switch on the type and read the config or text
+void WalkRenderCommands(void *userData) {
+    for (int i = 0; i < renderCommands.length; ++i) {
+        Clay_RenderCommand *renderCommand = &renderCommands.internalArray[i];
+        switch (renderCommand->commandType) {
+            case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: checksum += renderCommand->config.rectangleElementConfig->color.r + renderCommand->boundingBox.x; break;
+            case CLAY_RENDER_COMMAND_TYPE_TEXT: checksum += (float)renderCommand->text.length + renderCommand->config.textElementConfig->fontSize; break;
+            default: break;
+        }
+    }
+}
+
+void WalkCompactRenderCommands(void *userData) {
+    for (int i = 0; i < compactRenderCommands.commands.length; ++i) {
+        Clay_CompactRenderCommand *renderCommand = &compactRenderCommands.commands.internalArray[i];
+        switch (renderCommand->commandType) {
+            case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: checksum += renderCommand->payload.config.rectangleElementConfig->color.r + renderCommand->boundingBox.x; break;
+            case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+                Clay_CompactRenderCommandText *text = &compactRenderCommands.texts.internalArray[renderCommand->payload.textIndex];
+                checksum += (float)text->text.length + text->config->fontSize;
+                break;
+            }
+            default: break;
+        }
+    }
+}
+
+// A pass that only needs the bounding boxes of some commands, such as culling or batching rectangles
+void WalkRectangles(void *userData) {
+    for (int i = 0; i < renderCommands.length; ++i) {
+        if (renderCommands.internalArray[i].commandType == CLAY_RENDER_COMMAND_TYPE_RECTANGLE) {
+            checksum += renderCommands.internalArray[i].boundingBox.y;
+        }
+    }
+}
+
+void WalkCompactRectangles(void *userData) {
+    for (int i = 0; i < compactRenderCommands.commands.length; ++i) {
+        if (compactRenderCommands.commands.internalArray[i].commandType == CLAY_RENDER_COMMAND_TYPE_RECTANGLE) {
+            checksum += compactRenderCommands.commands.internalArray[i].boundingBox.y;
+        }
+    }
+}
+
+int main(void) {
+    Clay_SetMaxElementCount(ELEMENT_PAIR_COUNT * 2 + 16);
+    Clay_SetCompactRenderCommandsEnabled(true);
+    uint64_t totalMemorySize = Clay_MinMemorySize();
+    void *memory = malloc(totalMemorySize);
+    Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, memory), (Clay_Dimensions) { 1024, 768 }, (Clay_ErrorHandler) {});
+    Clay_SetMeasureTextFunction(MeasureText);
+    // Every command is kept, even though most of the grid is off screen
+    Clay_SetCullingEnabled(false);
+
+    Clay_SetCompactRenderCommandsEnabled(false);
+    LayoutFrame(NULL);
+    double layoutSeconds = Benchmark_FastestRun(LayoutFrame, NULL);
+    Clay_SetCompactRenderCommandsEnabled(true);
+    LayoutFrame(NULL);
+    double compactLayoutSeconds = Benchmark_FastestRun(LayoutFrame, NULL);
+    renderCommands = Clay_GetCurrentContext()->renderCommands;
+    compactRenderCommands = Clay_GetCompactRenderCommands();
+
+    printf("%d render commands, %d bytes each, compact commands %d bytes each\n", renderCommands.length, (int)sizeof(Clay_RenderCommand), (int)sizeof(Clay_CompactRenderCommand));
+    printf("Walking every command:     %.3f ms, compact %.3f ms\n", Benchmark_FastestRun(WalkRenderCommands, NULL) * 1e3, Benchmark_FastestRun(WalkCompactRenderCommands, NULL) * 1e3);
+    printf("Walking rectangles only:   %.3f ms, compact %.3f ms\n", Benchmark_FastestRun(WalkRectangles, NULL) * 1e3, Benchmark_FastestRun(WalkCompactRectangles, NULL) * 1e3);
+    printf("Building the compact stream adds %.3f ms to a %.3f ms layout\n", (compactLayoutSeconds - layoutSeconds) * 1e3, layoutSeconds * 1e3);
+    free(memory);
+    return checksum == 0;
+}
@@ -0,0 +1,42 @@
+// Lays out a grid of cells that are all scroll containers, as a data grid with scrollable cell editors does, and looks up each
+// one's scroll data. With scroll containers indexed by element id, the time per scroll container should stay flat as the count grows.
+#include "benchmark.h"
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+
+int scrollContainerCount;
+
+void LayoutFrame(void *userData) {
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("Grid"), CLAY_LAYOUT({ .layoutDirection = CLAY_TOP_TO_BOTTOM })) {
+        for (int i = 0; i < scrollContainerCount; ++i) {
+            CLAY(CLAY_IDI("Cell", i), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIXED(100), CLAY_SIZING_FIXED(20) } }), CLAY_SCROLL({ .vertical = true })) {
+                CLAY(CLAY_IDI("CellContent", i), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIXED(100), CLAY_SIZING_FIXED(60) } })) {}
+            }
+        }
+    }
+    Clay_EndLayout();
+    Clay_UpdateScrollContainers(false, (Clay_Vector2) { 0, -1 }, 0.016f);
+    for (int i = 0; i < scrollContainerCount; ++i) {
+        Clay_GetScrollContainerData(Clay_GetElementIdWithIndex(CLAY_STRING("Cell"), i));
+    }
+}
+
+int main(void) {
+    int counts[] = { 10, 100, 1000, 4000, 8000 };
+    Clay_SetMaxElementCount(32768);
+    // Leave room for the scroll container capacity to grow
+    uint64_t totalMemorySize = Clay_MinMemorySize() * 2;
+    void *memory = malloc(totalMemorySize);
+    for (int i = 0; i < (int)(sizeof(counts) / sizeof(counts[0])); ++i) {
+        scrollContainerCount = counts[i];
+        Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, memory), (Clay_Dimensions) { 1024, 768 }, (Clay_ErrorHandler) {});
+        // The first frames grow the scroll container capacity
+        LayoutFrame(NULL);
+        LayoutFrame(NULL);
+        double seconds = Benchmark_FastestRun(LayoutFrame, NULL);
+        printf("%5d scroll containers: %8.3f ms per frame, %6.1f ns per scroll container\n", scrollContainerCount, seconds * 1e3, seconds * 1e9 / scrollContainerCount);
+    }
+    free(memory);
+    return 0;
+}
@@ -0,0 +1,52 @@
+// Lays out overflowing toolbars that have to shrink their children and table rows that have to grow theirs, with a mix of min and max
+// sizes so that children clamp at different points. With the even share found directly, the time per child should stay flat.
+#include "benchmark.h"
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+
+#define ROW_COUNT 20
+
+int childCount;
+
+Clay_SizingAxis GrowBetween(float min, float max) {
+    return (Clay_SizingAxis) { .size = { .minMax = { min, max } }, .type = CLAY__SIZING_TYPE_GROW };
+}
+
+void LayoutFrame(void *userData) {
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("Rows"), CLAY_LAYOUT({ .layoutDirection = CLAY_TOP_TO_BOTTOM })) {
+        for (int row = 0; row < ROW_COUNT; ++row) {
+            // Toolbar buttons want 40px each but only get 20px on average, so most of them shrink towards their min size
+            CLAY(CLAY_IDI("Toolbar", row), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIXED((float)childCount * 20), CLAY_SIZING_FIXED(24) } })) {
+                for (int i = 0; i < childCount; ++i) {
+                    CLAY(CLAY_LAYOUT({ .sizing = { GrowBetween((float)(i % 7) * 4, 40), CLAY_SIZING_GROW({}) } })) {
+                        CLAY(CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIXED(40), CLAY_SIZING_FIXED(16) } })) {}
+                    }
+                }
+            }
+            // Table cells have room to spare, and the ones with a low max size stop growing before the rest
+            CLAY(CLAY_IDI("TableRow", row), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIXED((float)childCount * 60), CLAY_SIZING_FIXED(24) } })) {
+                for (int i = 0; i < childCount; ++i) {
+                    CLAY(CLAY_LAYOUT({ .sizing = { GrowBetween((float)(i % 5) * 10, (float)(i % 11) * 15 + 20), CLAY_SIZING_GROW({}) } })) {}
+                }
+            }
+        }
+    }
+    Clay_EndLayout();
+}
+
+int main(void) {
+    int counts[] = { 10, 100, 1000 };
+    Clay_SetMaxElementCount(65536);
+    uint64_t totalMemorySize = Clay_MinMemorySize();
+    void *memory = malloc(totalMemorySize);
+    for (int i = 0; i < (int)(sizeof(counts) / sizeof(counts[0])); ++i) {
+        childCount = counts[i];
+        Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, memory), (Clay_Dimensions) { 1024, 768 }, (Clay_ErrorHandler) {});
+        LayoutFrame(NULL);
+        double seconds = Benchmark_FastestRun(LayoutFrame, NULL);
+        printf("%4d children per row: %8.3f ms per frame, %6.1f ns per child\n", childCount, seconds * 1e3, seconds * 1e9 / (ROW_COUNT * childCount * 3));
+    }
+    free(memory);
+    return 0;
+}
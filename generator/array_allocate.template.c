@@ -1,3 +1,7 @@
 $NAME$ $NAME$_Allocate_Arena(uint32_t capacity, Clay_Arena *arena) {
-    return CLAY__INIT($NAME$){.capacity = capacity, .length = 0, .internalArray = ($TYPE$ *)Clay__Array_Allocate_Arena(capacity, sizeof($TYPE$), CLAY__ALIGNMENT($TYPE$), arena)};
+    $NAME$ array = CLAY__INIT($NAME$){.capacity = capacity, .length = 0, .internalArray = ($TYPE$ *)Clay__Array_Allocate_Arena(capacity, sizeof($TYPE$), CLAY__ALIGNMENT($TYPE$), arena)};
+    if (!array.internalArray) {
+        array.capacity = 0;
+    }
+    return array;
 }
\ No newline at end of file
@@ -33,8 +33,9 @@ for (const file of files) {
             if (matchingEndingLine !== -1) {
                 i++;
                 lines.splice(i, matchingEndingLine - (i));
-                lines.splice(i, 0, ['#pragma region generated']);
-                i++;
+                // Region pragmas are only understood by MSVC, other compilers warn about them with -Wunknown-pragmas
+                lines.splice(i, 0, '#ifdef _MSC_VER', '#pragma region generated', '#endif');
+                i += 3;
                 for (const templateName of templateNames.split(',')) {
                     var matchingTemplate = templates.find(t => t.endsWith(`${templateName}.template.c`));
                     if (matchingTemplate) {
@@ -57,8 +58,8 @@ for (const file of files) {
                         process.exit();
                     }
                 }
-                lines.splice(i, 0, ['#pragma endregion']);
-                i++;
+                lines.splice(i, 0, '#ifdef _MSC_VER', '#pragma endregion', '#endif');
+                i += 3;
             } else {
                 console.log(`Error at ${file}:${i + 1}: template was opened and not closed again.`);
                 process.exit();
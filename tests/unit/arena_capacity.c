@@ -0,0 +1,105 @@
+// Checks that running out of arena memory is reported as an error rather than crashing, whether the arena is too small to begin with,
+// a feature is enabled that the arena has no room for, or the max element count is raised without reinitializing.
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+int failures = 0;
+int arenaErrorCount = 0;
+
+void HandleClayErrors(Clay_ErrorData errorData) {
+    if (errorData.errorType == CLAY_ERROR_TYPE_ARENA_CAPACITY_EXCEEDED) {
+        arenaErrorCount++;
+    }
+}
+
+Clay_Dimensions MeasureText(Clay_String *text, Clay_TextElementConfig *config) {
+    return (Clay_Dimensions) { (float)text->length * 7, 16 };
+}
+
+void MeasureTextBatch(Clay_String *words, Clay_TextElementConfig **configs, Clay_Dimensions *outDimensions, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        outDimensions[i] = MeasureText(&words[i], configs[i]);
+    }
+}
+
+void Check(bool condition, const char *message) {
+    if (!condition) {
+        printf("%s\n", message);
+        failures++;
+    }
+}
+
+Clay_RenderCommandArray LayoutFrame(void) {
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("Outer"), CLAY_LAYOUT({ .layoutDirection = CLAY_TOP_TO_BOTTOM }), CLAY_RECTANGLE({ .color = { 255, 0, 0, 255 } })) {
+        for (int i = 0; i < 20; ++i) {
+            CLAY(CLAY_IDI("Item", i), CLAY_LAYOUT({ .padding = { 4, 4 } })) {
+                CLAY_TEXT(CLAY_STRING("Some words to measure"), CLAY_TEXT_CONFIG({ .fontSize = 16 }));
+            }
+        }
+    }
+    return Clay_EndLayout();
+}
+
+int main(void) {
+    uint64_t totalMemorySize = Clay_MinMemorySize();
+    void *memory = malloc(totalMemorySize);
+
+    // An arena that is slightly too small doesn't produce a context
+    arenaErrorCount = 0;
+    Clay_Context *tooSmall = Clay_CreateContext(Clay_CreateArenaWithCapacityAndMemory(totalMemorySize - 64, memory), (Clay_Dimensions) { 1024, 768 }, (Clay_ErrorHandler) { HandleClayErrors });
+    Check(tooSmall == NULL, "A context was created in an arena that is too small");
+    Check(arenaErrorCount > 0, "No error was reported for an arena that is too small");
+
+    Clay_Context *context = Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, memory), (Clay_Dimensions) { 1024, 768 }, (Clay_ErrorHandler) { HandleClayErrors });
+    Check(context != NULL, "No context was created in an arena of Clay_MinMemorySize()");
+    Clay_SetMeasureTextFunction(MeasureText);
+    Check(LayoutFrame().length > 20, "The layout was missing render commands");
+
+    // The arena is exactly the minimum size, so there's no room for a batch and text is still measured one word at a time
+    arenaErrorCount = 0;
+    Clay_SetMeasureTextBatchFunction(MeasureTextBatch);
+    Check(arenaErrorCount == 1, "Setting a batch measure text function without room in the arena wasn't reported");
+    Check(LayoutFrame().length > 20, "The layout was missing render commands after failing to measure text in batches");
+    Clay_SetMeasureTextBatchFunction(NULL);
+
+    // The arena is exactly the minimum size, so there's no room for the compact commands and they stay disabled
+    arenaErrorCount = 0;
+    Clay_SetCompactRenderCommandsEnabled(true);
+    Check(arenaErrorCount == 1, "Enabling compact render commands without room in the arena wasn't reported");
+    Check(LayoutFrame().length > 20, "The layout was missing render commands after failing to enable compact render commands");
+    Check(Clay_GetCompactRenderCommands().commands.length == 0, "Compact render commands were built without room in the arena");
+
+    // Raising the max element count without reinitializing leaves the next frame without enough memory
+    arenaErrorCount = 0;
+    Clay_SetMaxElementCount(Clay_GetMaxElementCount() * 2);
+    Clay_RenderCommandArray renderCommands = LayoutFrame();
+    Check(arenaErrorCount > 0, "Running out of memory during Clay_BeginLayout wasn't reported");
+    Check(renderCommands.length <= 1, "A layout was produced without enough memory for it");
+
+    // Enabled before Clay_MinMemorySize(), the compact commands and the batch are included in the arena
+    Clay_SetCurrentContext(NULL);
+    uint64_t sizeWithoutCompactCommands = Clay_MinMemorySize();
+    Clay_SetCompactRenderCommandsEnabled(true);
+    free(memory);
+    totalMemorySize = Clay_MinMemorySize();
+    Check(totalMemorySize > sizeWithoutCompactCommands, "Clay_MinMemorySize() didn't include the compact render commands");
+    Clay_SetMeasureTextBatchFunction(MeasureTextBatch);
+    Check(Clay_MinMemorySize() > totalMemorySize, "Clay_MinMemorySize() didn't include the measure text batch");
+    totalMemorySize = Clay_MinMemorySize();
+    memory = malloc(totalMemorySize);
+    arenaErrorCount = 0;
+    Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, memory), (Clay_Dimensions) { 1024, 768 }, (Clay_ErrorHandler) { HandleClayErrors });
+    renderCommands = LayoutFrame();
+    Check(arenaErrorCount == 0, "Errors were reported in an arena of Clay_MinMemorySize()");
+    Check(Clay_GetCompactRenderCommands().commands.length == renderCommands.length, "Compact render commands weren't built");
+
+    free(memory);
+    if (failures > 0) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+    return 0;
+}
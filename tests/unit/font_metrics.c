@@ -0,0 +1,73 @@
+// Checks that registering new metrics for a font is picked up by the next layout, rather than reusing widths that were measured and
+// cached with the font's previous metrics, including when the layout is otherwise identical and idle frames are being skipped.
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+int failures = 0;
+
+void HandleClayErrors(Clay_ErrorData errorData) {
+    printf("%.*s\n", errorData.errorText.length, errorData.errorText.chars);
+    failures++;
+}
+
+float narrowAdvances[128];
+float wideAdvances[128];
+
+Clay_FontMetrics MetricsWithAdvances(const float *advances) {
+    return (Clay_FontMetrics) { .baseSize = 16, .lineHeight = 16, .advances = advances, .advanceCount = 128, .fallbackAdvance = 8 };
+}
+
+// Lays out a wrapping and a non wrapping label, then compares their widths with the expected width of every character
+void CheckLayout(float characterWidth, const char *label) {
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("Labels"), CLAY_LAYOUT({ .layoutDirection = CLAY_TOP_TO_BOTTOM })) {
+        CLAY(CLAY_ID("Single"), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIT({}) } })) {
+            CLAY_TEXT(CLAY_STRING("Hello"), CLAY_TEXT_CONFIG({ .fontSize = 16, .wrapMode = CLAY_TEXT_WRAP_NONE }));
+        }
+        CLAY(CLAY_ID("Words"), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIT({}) } })) {
+            CLAY_TEXT(CLAY_STRING("Hello world"), CLAY_TEXT_CONFIG({ .fontSize = 16 }));
+        }
+    }
+    Clay_EndLayout();
+    float singleWidth = Clay__GetHashMapItem(Clay_GetElementId(CLAY_STRING("Single")).id)->boundingBox.width;
+    float wordsWidth = Clay__GetHashMapItem(Clay_GetElementId(CLAY_STRING("Words")).id)->boundingBox.width;
+    if (singleWidth != characterWidth * 5 || wordsWidth != characterWidth * 11) {
+        printf("%s: labels are %.2f and %.2f wide, expected %.2f and %.2f\n", label, singleWidth, wordsWidth, characterWidth * 5, characterWidth * 11);
+        failures++;
+    }
+}
+
+void RunChecks(const char *label) {
+    Clay_RegisterFontMetrics(0, MetricsWithAdvances(narrowAdvances));
+    CheckLayout(6, label);
+    CheckLayout(6, label);
+    Clay_RegisterFontMetrics(0, MetricsWithAdvances(wideAdvances));
+    CheckLayout(10, label);
+    CheckLayout(10, label);
+    Clay_RegisterFontMetrics(0, MetricsWithAdvances(narrowAdvances));
+    CheckLayout(6, label);
+}
+
+int main(void) {
+    for (int i = 0; i < 128; ++i) {
+        narrowAdvances[i] = 6;
+        wideAdvances[i] = 10;
+    }
+    uint64_t totalMemorySize = Clay_MinMemorySize();
+    void *memory = malloc(totalMemorySize);
+    Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, memory), (Clay_Dimensions) { 1024, 768 }, (Clay_ErrorHandler) { HandleClayErrors });
+    RunChecks("Every frame laid out");
+
+    Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, memory), (Clay_Dimensions) { 1024, 768 }, (Clay_ErrorHandler) { HandleClayErrors });
+    Clay_SetIdleFrameSkippingEnabled(true);
+    RunChecks("Idle frames skipped");
+
+    free(memory);
+    if (failures > 0) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,160 @@
+// Checks that idle frame skipping returns exactly the render commands of the frame it skips, that any change to text, configs, scroll
+// positions or layout dimensions makes the next frame lay out again, and that hit testing and scrolling don't depend on whether frames
+// were skipped, by running the same frames in a second context with skipping turned off.
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int failures = 0;
+
+void HandleClayErrors(Clay_ErrorData errorData) {
+    printf("%s\n", errorData.errorText.chars);
+    failures++;
+}
+
+void Check(bool condition, const char *message) {
+    if (!condition) {
+        printf("%s\n", message);
+        failures++;
+    }
+}
+
+Clay_Dimensions MeasureText(Clay_String *text, Clay_TextElementConfig *config) {
+    return (Clay_Dimensions) { (float)text->length * 10, 20 };
+}
+
+// Everything the declarations read, so that each input can be changed on its own
+char label[] = "Label";
+Clay_Color panelColor = { 200, 200, 200, 255 };
+
+// A scroll container taller than its content area, a hovered row that changes color, and two overlapping floating elements over the list
+Clay_RenderCommandArray LayoutFrame(void) {
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("Page"), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_GROW({}), CLAY_SIZING_GROW({}) }, .layoutDirection = CLAY_TOP_TO_BOTTOM }), CLAY_RECTANGLE({ .color = panelColor })) {
+        CLAY_TEXT(((Clay_String) { .length = sizeof(label) - 1, .chars = label }), CLAY_TEXT_CONFIG({ .fontSize = 16 }));
+        CLAY(CLAY_ID("List"), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIXED(300), CLAY_SIZING_FIXED(200) }, .layoutDirection = CLAY_TOP_TO_BOTTOM }), CLAY_SCROLL({ .vertical = true })) {
+            for (int i = 0; i < 20; ++i) {
+                CLAY(CLAY_IDI("Row", i), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_GROW({}), CLAY_SIZING_FIXED(40) } }), CLAY_RECTANGLE({ .color = Clay_Hovered() ? (Clay_Color) { 255, 0, 0, 255 } : (Clay_Color) { 0, 0, 255, 255 } })) {}
+            }
+            CLAY(CLAY_ID("Overlay"), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIXED(50), CLAY_SIZING_FIXED(50) } }), CLAY_FLOATING({ .zIndex = 2 }), CLAY_RECTANGLE({ .color = { 0, 255, 0, 255 } })) {}
+            // Declared after the overlay but drawn below it, so hit testing has to follow zIndex rather than declaration order
+            CLAY(CLAY_ID("Badge"), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIXED(30), CLAY_SIZING_FIXED(30) } }), CLAY_FLOATING({ .zIndex = 1 }), CLAY_RECTANGLE({ .color = { 255, 255, 0, 255 } })) {}
+        }
+    }
+    return Clay_EndLayout();
+}
+
+Clay_RenderCommand previousCommands[256];
+int32_t previousCommandCount;
+
+void SaveCommands(Clay_RenderCommandArray renderCommands) {
+    previousCommandCount = (int32_t)renderCommands.length;
+    memcpy(previousCommands, renderCommands.internalArray, renderCommands.length * sizeof(Clay_RenderCommand));
+}
+
+bool MatchesSavedCommands(Clay_RenderCommandArray renderCommands) {
+    return (int32_t)renderCommands.length == previousCommandCount && memcmp(previousCommands, renderCommands.internalArray, renderCommands.length * sizeof(Clay_RenderCommand)) == 0;
+}
+
+// Lays out a frame that must not be skipped, then checks that the same frame declared again is skipped and returns the same bytes
+void CheckChangeDefeatsSkip(const char *message) {
+    Clay_RenderCommandArray renderCommands = LayoutFrame();
+    Check(!Clay_LayoutUnchanged(), message);
+    SaveCommands(renderCommands);
+    renderCommands = LayoutFrame();
+    Check(Clay_LayoutUnchanged(), "An unchanged frame wasn't skipped");
+    Check(MatchesSavedCommands(renderCommands), "A skipped frame's render commands differ from the frame it skipped");
+}
+
+Clay_ScrollContainerData ListScrollData(void) {
+    return Clay_GetScrollContainerData(Clay_GetElementId(CLAY_STRING("List")));
+}
+
+bool SameRenderCommands(Clay_RenderCommandArray a, Clay_RenderCommandArray b) {
+    if (a.length != b.length) {
+        return false;
+    }
+    for (int32_t i = 0; i < (int32_t)a.length; ++i) {
+        Clay_RenderCommand *first = &a.internalArray[i], *second = &b.internalArray[i];
+        if (first->id != second->id || first->commandType != second->commandType || memcmp(&first->boundingBox, &second->boundingBox, sizeof(Clay_BoundingBox)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SamePointerOverIds(Clay_ElementIdArraySlice a, Clay_ElementIdArraySlice b) {
+    if (a.length != b.length) {
+        return false;
+    }
+    for (int32_t i = 0; i < (int32_t)a.length; ++i) {
+        if (a.internalArray[i].id != b.internalArray[i].id) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(void) {
+    uint64_t totalMemorySize = Clay_MinMemorySize();
+    void *memory = malloc(totalMemorySize);
+    void *referenceMemory = malloc(totalMemorySize);
+    Clay_Dimensions dimensions = { 1024, 768 };
+
+    Clay_Context *context = Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, memory), dimensions, (Clay_ErrorHandler) { HandleClayErrors });
+    Clay_SetMeasureTextFunction(MeasureText);
+    Clay_SetIdleFrameSkippingEnabled(true);
+    Clay_SetPointerState((Clay_Vector2) { -100, -100 }, false);
+    CheckChangeDefeatsSkip("The first frame was skipped");
+
+    label[0] = 'X';
+    CheckChangeDefeatsSkip("Changing the bytes of a text element didn't lay the frame out again");
+    panelColor.r = 100;
+    CheckChangeDefeatsSkip("Changing a config didn't lay the frame out again");
+    ListScrollData().scrollPosition->y = -40;
+    CheckChangeDefeatsSkip("Changing a scroll position didn't lay the frame out again");
+    dimensions.width = 800;
+    Clay_SetLayoutDimensions(dimensions);
+    CheckChangeDefeatsSkip("Changing the layout dimensions didn't lay the frame out again");
+    ListScrollData().scrollPosition->y = 0;
+
+    // The same frames in a context without skipping should hover the same elements, scroll the same way and produce the same layout
+    Clay_Context *referenceContext = Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, referenceMemory), dimensions, (Clay_ErrorHandler) { HandleClayErrors });
+    Clay_SetMeasureTextFunction(MeasureText);
+    LayoutFrame();
+    Clay_Context *contexts[2] = { context, referenceContext };
+    Clay_RenderCommandArray renderCommands[2];
+    int skippedFrames = 0;
+    for (int frame = 0; frame < 40; ++frame) {
+        // The pointer rests over both floating elements and then over rows, and scrolling only happens on some frames, so that most frames can be skipped
+        Clay_Vector2 pointerPosition = frame < 20 ? (Clay_Vector2) { 15, 35 } : (Clay_Vector2) { 150, 100 };
+        Clay_Vector2 scrollDelta = frame % 10 == 5 ? (Clay_Vector2) { 0, -1 } : (Clay_Vector2) { 0, 0 };
+        Clay_ElementIdArraySlice pointerOverIds[2];
+        float scrollPositions[2];
+        for (int i = 0; i < 2; ++i) {
+            Clay_SetCurrentContext(contexts[i]);
+            Clay_SetPointerState(pointerPosition, false);
+            Clay_UpdateScrollContainers(false, scrollDelta, 0.016f);
+            renderCommands[i] = LayoutFrame();
+            pointerOverIds[i] = Clay_GetPointerOverIds();
+            scrollPositions[i] = ListScrollData().scrollPosition->y;
+        }
+        Clay_SetCurrentContext(context);
+        skippedFrames += Clay_LayoutUnchanged();
+        Check(SamePointerOverIds(pointerOverIds[0], pointerOverIds[1]), "Hit testing differed with idle frame skipping");
+        Check(scrollPositions[0] == scrollPositions[1], "Scrolling differed with idle frame skipping");
+        Check(SameRenderCommands(renderCommands[0], renderCommands[1]), "The layout differed with idle frame skipping");
+    }
+    Check(skippedFrames > 20, "Too few frames were skipped for the comparison to mean anything");
+    Check(ListScrollData().scrollPosition->y < 0, "The list never scrolled");
+
+    free(memory);
+    free(referenceMemory);
+    if (failures > 0) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,57 @@
+// Checks that sibling elements declared with the same CLAY_ID_LOCAL label, as in a loop, get different ids rather than reporting
+// duplicate id errors.
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ROW_COUNT 3
+
+int failures = 0;
+
+void HandleClayErrors(Clay_ErrorData errorData) {
+    printf("%s\n", errorData.errorText.chars);
+    failures++;
+}
+
+void Check(bool condition, const char *message) {
+    if (!condition) {
+        printf("%s\n", message);
+        failures++;
+    }
+}
+
+int main(void) {
+    uint64_t totalMemorySize = Clay_MinMemorySize();
+    void *memory = malloc(totalMemorySize);
+    Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, memory), (Clay_Dimensions) { 1024, 768 }, (Clay_ErrorHandler) { HandleClayErrors });
+
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("List"), CLAY_LAYOUT({ .layoutDirection = CLAY_TOP_TO_BOTTOM })) {
+        for (int i = 0; i < ROW_COUNT; ++i) {
+            CLAY(CLAY_ID_LOCAL("Row"), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIXED(100), CLAY_SIZING_FIXED(20) } }), CLAY_RECTANGLE({ .color = { 255, 255, 255, 255 } })) {}
+        }
+    }
+    Clay_RenderCommandArray renderCommands = Clay_EndLayout();
+
+    uint32_t rowIds[ROW_COUNT];
+    int rowCount = 0;
+    for (int i = 0; i < renderCommands.length; ++i) {
+        if (renderCommands.internalArray[i].commandType == CLAY_RENDER_COMMAND_TYPE_RECTANGLE && rowCount < ROW_COUNT) {
+            rowIds[rowCount++] = renderCommands.internalArray[i].id;
+        }
+    }
+    Check(rowCount == ROW_COUNT, "Not every row was rendered");
+    for (int i = 0; i < rowCount; ++i) {
+        for (int j = i + 1; j < rowCount; ++j) {
+            Check(rowIds[i] != rowIds[j], "Sibling rows with the same local label got the same id");
+        }
+    }
+
+    free(memory);
+    if (failures > 0) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+    return 0;
+}
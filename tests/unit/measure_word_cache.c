@@ -0,0 +1,151 @@
+// Checks that words measured through the shared word cache always get the measurement for their own font, including words and fonts
+// whose hashes used to collide, such as '/' in font 3 and the space in font 2.
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define FONT_COUNT 8
+
+int failures = 0;
+uint32_t measureCallCount = 0;
+
+void HandleClayErrors(Clay_ErrorData errorData) {
+    printf("%.*s\n", errorData.errorText.length, errorData.errorText.chars);
+    failures++;
+}
+
+// Every character has a different width in every font, so a measurement returned for the wrong word or font shows up in the layout
+float CharacterWidth(char character, Clay_TextElementConfig *config) {
+    return (float)((unsigned char)character % 13 + 1) * (float)(config->fontId + 1) + (float)config->fontSize * 0.25f + (float)config->letterSpacing;
+}
+
+Clay_Dimensions MeasureText(Clay_String *text, Clay_TextElementConfig *config) {
+    measureCallCount++;
+    float width = 0;
+    for (int i = 0; i < text->length; ++i) {
+        width += CharacterWidth(text->chars[i], config);
+    }
+    return (Clay_Dimensions) { width, config->fontSize };
+}
+
+void MeasureTextBatch(Clay_String *words, Clay_TextElementConfig **configs, Clay_Dimensions *outDimensions, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        outDimensions[i] = MeasureText(&words[i], configs[i]);
+    }
+}
+
+typedef struct {
+    char chars[32];
+    Clay_String text;
+    Clay_TextElementConfig config;
+} TestText;
+
+uint32_t randomState = 1;
+uint32_t RandomInt(uint32_t range) {
+    randomState = randomState * 1103515245u + 12345u;
+    return (randomState >> 8) % range;
+}
+
+// Lays out every text in its own container, and compares each container's width with measuring the whole text directly
+void CheckTexts(TestText *texts, int count, const char *label) {
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("Texts"), CLAY_LAYOUT({ .layoutDirection = CLAY_TOP_TO_BOTTOM })) {
+        for (int i = 0; i < count; ++i) {
+            CLAY(CLAY_IDI("Text", i), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIT({}) } })) {
+                CLAY_TEXT(texts[i].text, &texts[i].config);
+            }
+        }
+    }
+    Clay_EndLayout();
+    for (int i = 0; i < count; ++i) {
+        float width = Clay__GetHashMapItem(Clay_GetElementIdWithIndex(CLAY_STRING("Text"), (uint32_t)i).id)->boundingBox.width;
+        float expected = MeasureText(&texts[i].text, &texts[i].config).width;
+        if (width - expected > 0.001f || expected - width > 0.001f) {
+            printf("%s: \"%.*s\" in font %u size %u spacing %u is %.2f wide, expected %.2f\n", label, texts[i].text.length, texts[i].text.chars,
+                texts[i].config.fontId, texts[i].config.fontSize, texts[i].config.letterSpacing, width, expected);
+            failures++;
+        }
+    }
+}
+
+void SetText(TestText *text, const char *chars, uint16_t fontId, uint16_t fontSize, uint16_t letterSpacing) {
+    int length = 0;
+    while (chars[length] && length < 31) {
+        text->chars[length] = chars[length];
+        length++;
+    }
+    text->text = (Clay_String) { .length = length, .chars = text->chars };
+    text->config = (Clay_TextElementConfig) { .fontId = fontId, .fontSize = fontSize, .letterSpacing = letterSpacing, .wrapMode = CLAY_TEXT_WRAP_NONE, .hashStringContents = true };
+}
+
+void RunChecks(const char *label) {
+    static TestText texts[512];
+    // '/' in font 3 used to share a hash with the space in font 2, so whichever was measured first was used for both
+    SetText(&texts[0], "a b", 2, 16, 0);
+    SetText(&texts[1], "/", 3, 16, 0);
+    SetText(&texts[2], "High performance", 2, 16, 0);
+    SetText(&texts[3], "High/performance", 3, 16, 0);
+    CheckTexts(texts, 4, label);
+    CheckTexts(texts, 4, label);
+
+    // Every single character in every font, with a space either side so that the space width of every font is cached too
+    int count = 0;
+    for (int character = 33; character < 127; ++character) {
+        for (uint16_t fontId = 0; fontId < FONT_COUNT; ++fontId) {
+            char chars[4] = { ' ', (char)character, ' ', 0 };
+            SetText(&texts[count++], chars, fontId, (uint16_t)(12 + RandomInt(3) * 4), (uint16_t)RandomInt(2));
+            if (count == 512) {
+                CheckTexts(texts, count, label);
+                count = 0;
+            }
+        }
+    }
+    CheckTexts(texts, count, label);
+
+    // Random short phrases in random fonts, including words too long to be cached
+    for (int frame = 0; frame < 20; ++frame) {
+        for (int i = 0; i < 512; ++i) {
+            char chars[32];
+            int length = 1 + (int)RandomInt(30);
+            for (int c = 0; c < length; ++c) {
+                chars[c] = RandomInt(5) == 0 ? ' ' : (char)(33 + RandomInt(8));
+            }
+            chars[length] = 0;
+            SetText(&texts[i], chars, (uint16_t)RandomInt(FONT_COUNT), 16, (uint16_t)RandomInt(2));
+        }
+        CheckTexts(texts, 512, label);
+    }
+}
+
+int main(void) {
+    // Wide enough that no text gets clipped to the layout
+    Clay_Dimensions layoutDimensions = { 100000, 100000 };
+    // Leave room in the arena for the batch used by the second run
+    Clay_SetMeasureTextBatchFunction(MeasureTextBatch);
+    uint64_t totalMemorySize = Clay_MinMemorySize();
+    Clay_SetMeasureTextBatchFunction(NULL);
+    void *memory = malloc(totalMemorySize);
+    Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, memory), layoutDimensions, (Clay_ErrorHandler) { HandleClayErrors });
+
+    Clay_SetMeasureTextFunction(MeasureText);
+    RunChecks("Measured one word at a time");
+    uint32_t directCallCount = measureCallCount;
+
+    // Start again with an empty cache, measuring in batches
+    Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, memory), layoutDimensions, (Clay_ErrorHandler) { HandleClayErrors });
+    Clay_SetMeasureTextBatchFunction(MeasureTextBatch);
+    randomState = 1;
+    RunChecks("Measured in batches");
+
+    if (directCallCount == 0) {
+        printf("The measure text function was never called\n");
+        failures++;
+    }
+    free(memory);
+    if (failures > 0) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+    return 0;
+}
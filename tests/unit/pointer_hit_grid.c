@@ -0,0 +1,159 @@
+// Checks that pointer queries find the same elements in the same order whether they walk the layout or use the pointer hit grid,
+// and that Clay_HitTestPoints reports an error rather than using memory that isn't there when the grid is disabled.
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define POINT_COUNT 64
+#define MAX_HIT_COUNT 64
+
+int failures = 0;
+int errorCount = 0;
+
+void HandleClayErrors(Clay_ErrorData errorData) {
+    errorCount++;
+}
+
+void Check(bool condition, const char *message) {
+    if (!condition) {
+        printf("%s\n", message);
+        failures++;
+    }
+}
+
+typedef struct {
+    uint32_t ids[MAX_HIT_COUNT];
+    int32_t length;
+} HitList;
+
+uint32_t randomState = 1;
+uint32_t RandomInt(uint32_t range) {
+    randomState = randomState * 1103515245u + 12345u;
+    return (randomState >> 8) % range;
+}
+
+// A grid of cards, some with a floating badge, and a floating menu on top that captures the pointer
+void LayoutFrame(void) {
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("Grid"), CLAY_LAYOUT({ .layoutDirection = CLAY_TOP_TO_BOTTOM, .childGap = 4 })) {
+        for (int row = 0; row < 12; ++row) {
+            CLAY(CLAY_IDI("Row", row), CLAY_LAYOUT({ .childGap = 4 })) {
+                for (int column = 0; column < 12; ++column) {
+                    int index = row * 12 + column;
+                    CLAY(CLAY_IDI("Card", index), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIXED(60), CLAY_SIZING_FIXED(40) }, .padding = { 8, 8 } })) {
+                        CLAY(CLAY_IDI("CardInner", index), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_GROW({}), CLAY_SIZING_GROW({}) } })) {}
+                        if (index % 7 == 0) {
+                            CLAY(CLAY_IDI("Badge", index), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIXED(20), CLAY_SIZING_FIXED(20) } }), CLAY_FLOATING({ .offset = { 50, -10 }, .zIndex = (uint16_t)(index % 3) })) {}
+                        }
+                    }
+                }
+            }
+        }
+    }
+    CLAY(CLAY_ID("Menu"), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIXED(200), CLAY_SIZING_FIXED(150) } }), CLAY_FLOATING({ .offset = { 100, 100 }, .zIndex = 10 })) {
+        CLAY(CLAY_ID("MenuItem"), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_GROW({}), CLAY_SIZING_FIXED(30) } })) {}
+    }
+    Clay_EndLayout();
+}
+
+void CopyHits(HitList *list, Clay_ElementIdArraySlice ids) {
+    list->length = 0;
+    for (int i = 0; i < ids.length && i < MAX_HIT_COUNT; ++i) {
+        list->ids[list->length++] = ids.internalArray[i].id;
+    }
+}
+
+// Clay_HitTestPoints lists hits in the order they're found rather than by priority, so its results are compared after sorting
+void SortHits(HitList *list) {
+    for (int i = 1; i < list->length; ++i) {
+        for (int j = i; j > 0 && list->ids[j - 1] > list->ids[j]; --j) {
+            uint32_t id = list->ids[j];
+            list->ids[j] = list->ids[j - 1];
+            list->ids[j - 1] = id;
+        }
+    }
+}
+
+bool HitsMatch(HitList *a, HitList *b) {
+    if (a->length != b->length) {
+        return false;
+    }
+    for (int i = 0; i < a->length; ++i) {
+        if (a->ids[i] != b->ids[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The ids found by Clay_SetPointerState for each point, which walks the whole layout for every point while the grid is disabled
+void CollectPointerOverIds(Clay_Vector2 *points, HitList *hits) {
+    for (int i = 0; i < POINT_COUNT; ++i) {
+        Clay_SetPointerState(points[i], false);
+        CopyHits(&hits[i], Clay_GetPointerOverIds());
+    }
+}
+
+int main(void) {
+    Clay_Dimensions layoutDimensions = { 1024, 768 };
+    uint64_t sizeWithoutGrid = Clay_MinMemorySize();
+    Clay_SetPointerHitGridEnabled(true);
+    uint64_t sizeWithGrid = Clay_MinMemorySize();
+    Clay_SetPointerHitGridEnabled(false);
+    Check(sizeWithGrid > sizeWithoutGrid, "Clay_MinMemorySize() didn't include the pointer hit grid");
+
+    void *memory = malloc(sizeWithGrid + 64);
+    Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(sizeWithoutGrid, memory), layoutDimensions, (Clay_ErrorHandler) { HandleClayErrors });
+    static Clay_Vector2 points[POINT_COUNT];
+    static HitList walked[POINT_COUNT], gridded[POINT_COUNT];
+    for (int i = 0; i < POINT_COUNT; ++i) {
+        points[i] = (Clay_Vector2) { (float)RandomInt(800), (float)RandomInt(600) };
+    }
+    LayoutFrame();
+    CollectPointerOverIds(points, walked);
+
+    // Without the grid, there's nowhere to put the results of Clay_HitTestPoints
+    static Clay_PointHitTestResult results[POINT_COUNT];
+    errorCount = 0;
+    Clay_HitTestPoints(points, POINT_COUNT, results);
+    Check(errorCount == 1, "Clay_HitTestPoints() without the pointer hit grid wasn't reported");
+    bool empty = true;
+    for (int i = 0; i < POINT_COUNT; ++i) {
+        empty = empty && results[i].pointerOverIds.length == 0;
+    }
+    Check(empty, "Clay_HitTestPoints() returned hits without the pointer hit grid");
+
+    // The arena is exactly the minimum size, so there's no room for the grid and it stays disabled
+    errorCount = 0;
+    Clay_SetPointerHitGridEnabled(true);
+    Check(errorCount == 1, "Enabling the pointer hit grid without room in the arena wasn't reported");
+
+    // With room in the arena, the grid gives the same hits as walking the layout
+    Clay_SetCurrentContext(NULL);
+    errorCount = 0;
+    Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(sizeWithGrid + 64, memory), layoutDimensions, (Clay_ErrorHandler) { HandleClayErrors });
+    Clay_SetPointerHitGridEnabled(true);
+    LayoutFrame();
+    CollectPointerOverIds(points, gridded);
+    Clay_HitTestPoints(points, POINT_COUNT, results);
+    Check(errorCount == 0, "Errors were reported using the pointer hit grid");
+    for (int i = 0; i < POINT_COUNT; ++i) {
+        HitList pointHits, sortedWalked = walked[i];
+        CopyHits(&pointHits, results[i].pointerOverIds);
+        SortHits(&pointHits);
+        SortHits(&sortedWalked);
+        if (!HitsMatch(&walked[i], &gridded[i]) || !HitsMatch(&sortedWalked, &pointHits)) {
+            printf("Point %d (%.0f, %.0f) found %d elements walking the layout, %d with Clay_SetPointerState and the grid, %d with Clay_HitTestPoints\n",
+                i, points[i].x, points[i].y, walked[i].length, gridded[i].length, pointHits.length);
+            failures++;
+        }
+    }
+
+    free(memory);
+    if (failures > 0) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,150 @@
+// Checks that render command deltas only take up space in the arena once they're enabled, and that they report the right changes
+// whether they were enabled before Clay_Initialize or between frames.
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+int failures = 0;
+int arenaErrorCount = 0;
+
+void HandleClayErrors(Clay_ErrorData errorData) {
+    if (errorData.errorType == CLAY_ERROR_TYPE_ARENA_CAPACITY_EXCEEDED) {
+        arenaErrorCount++;
+    }
+}
+
+Clay_Dimensions MeasureText(Clay_String *text, Clay_TextElementConfig *config) {
+    return (Clay_Dimensions) { (float)text->length * 7, 16 };
+}
+
+void Check(bool condition, const char *message) {
+    if (!condition) {
+        printf("%s\n", message);
+        failures++;
+    }
+}
+
+Clay_RenderCommandArray LayoutFrame(float itemColor) {
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("Outer"), CLAY_LAYOUT({ .layoutDirection = CLAY_TOP_TO_BOTTOM }), CLAY_RECTANGLE({ .color = { 255, 0, 0, 255 } })) {
+        for (int i = 0; i < 20; ++i) {
+            CLAY(CLAY_IDI("Item", i), CLAY_LAYOUT({ .padding = { 4, 4 } }), CLAY_RECTANGLE({ .color = { i == 3 ? itemColor : 0, 0, 0, 255 } })) {
+                CLAY_TEXT(CLAY_STRING("Some words to measure"), CLAY_TEXT_CONFIG({ .fontSize = 16 }));
+            }
+        }
+    }
+    return Clay_EndLayout();
+}
+
+int CountDeltas(Clay_RenderCommandDeltaType type) {
+    Clay_RenderCommandDeltaArray deltas = Clay_GetRenderCommandDeltas();
+    int count = 0;
+    for (int i = 0; i < deltas.length; ++i) {
+        count += deltas.internalArray[i].deltaType == type;
+    }
+    return count;
+}
+
+// The first frame reports everything as added, an identical frame reports nothing, and changing one item's color modifies it
+void CheckDeltas(const char *label) {
+    Clay_RenderCommandArray renderCommands = LayoutFrame(0);
+    if (CountDeltas(CLAY_RENDER_COMMAND_DELTA_ADDED) != renderCommands.length) {
+        printf("%s: %d of %d render commands were added in the first frame\n", label, CountDeltas(CLAY_RENDER_COMMAND_DELTA_ADDED), renderCommands.length);
+        failures++;
+    }
+    LayoutFrame(0);
+    if (Clay_GetRenderCommandDeltas().length != 0) {
+        printf("%s: an unchanged frame had %d deltas\n", label, Clay_GetRenderCommandDeltas().length);
+        failures++;
+    }
+    LayoutFrame(100);
+    if (Clay_GetRenderCommandDeltas().length != 1 || CountDeltas(CLAY_RENDER_COMMAND_DELTA_MODIFIED) != 1) {
+        printf("%s: changing one color gave %d deltas, expected 1 modified\n", label, Clay_GetRenderCommandDeltas().length);
+        failures++;
+    }
+}
+
+// Elements that accidentally share an id produce render commands with the same id and type
+void LayoutRepeatedElements(int count, float lastColor) {
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("Column"), CLAY_LAYOUT({ .layoutDirection = CLAY_TOP_TO_BOTTOM })) {
+        for (int i = 0; i < count; ++i) {
+            CLAY(CLAY_ID("Repeated"), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIXED(50), CLAY_SIZING_FIXED(10) } }), CLAY_RECTANGLE({ .color = { i == count - 1 ? lastColor : 0, 0, 0, 255 } })) {}
+        }
+    }
+    Clay_EndLayout();
+}
+
+// Render commands with the same id and type are matched by the order they appear in
+void CheckRepeatedIdDeltas(void) {
+    LayoutRepeatedElements(3, 0);
+    LayoutRepeatedElements(3, 0);
+    Check(Clay_GetRenderCommandDeltas().length == 0, "Unchanged render commands with a repeated id were reported as changed");
+    LayoutRepeatedElements(3, 100);
+    Clay_DamageRectArray damageRects = Clay_GetDamageRects();
+    Check(Clay_GetRenderCommandDeltas().length == 1 && CountDeltas(CLAY_RENDER_COMMAND_DELTA_MODIFIED) == 1, "Changing one of the render commands with a repeated id didn't modify only that one");
+    Check(damageRects.length == 1 && damageRects.internalArray[0].y == 20 && damageRects.internalArray[0].height == 10, "Changing one of the render commands with a repeated id damaged more than that command");
+    // Every removed command is damaged where it used to be, not just the first one with the repeated id
+    LayoutRepeatedElements(1, 0);
+    Check(Clay_GetRenderCommandDeltas().length == 2 && CountDeltas(CLAY_RENDER_COMMAND_DELTA_REMOVED) == 2, "Removing render commands with a repeated id gave the wrong deltas");
+    damageRects = Clay_GetDamageRects();
+    float damagedTop = 30, damagedBottom = 0;
+    for (int i = 0; i < damageRects.length; ++i) {
+        damagedTop = CLAY__MIN(damagedTop, damageRects.internalArray[i].y);
+        damagedBottom = CLAY__MAX(damagedBottom, damageRects.internalArray[i].y + damageRects.internalArray[i].height);
+    }
+    Check(damagedTop == 10 && damagedBottom == 30, "The removed render commands with a repeated id weren't all damaged");
+}
+
+int main(void) {
+    Clay_Dimensions layoutDimensions = { 1024, 768 };
+    uint64_t sizeWithoutDeltas = Clay_MinMemorySize();
+    Clay_SetRenderCommandDeltasEnabled(true);
+    uint64_t sizeWithDeltas = Clay_MinMemorySize();
+    Clay_SetRenderCommandDeltasEnabled(false);
+    Check(sizeWithDeltas > sizeWithoutDeltas, "Clay_MinMemorySize() didn't include the render command fingerprints");
+
+    // Without deltas, an arena of the minimum size has no room to enable them later
+    // Enabled between frames, the fingerprints are allocated after the rest of persistent memory, which can need a little more alignment padding
+    uint64_t totalMemorySize = sizeWithDeltas + 64;
+    void *memory = malloc(totalMemorySize);
+    Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(sizeWithoutDeltas, memory), layoutDimensions, (Clay_ErrorHandler) { HandleClayErrors });
+    Clay_SetMeasureTextFunction(MeasureText);
+    LayoutFrame(0);
+    Check(Clay_GetRenderCommandDeltas().length == 0, "Deltas were reported while disabled");
+    Clay_SetRenderCommandDeltasEnabled(true);
+    Check(arenaErrorCount == 1, "Enabling render command deltas without room in the arena wasn't reported");
+    Check(LayoutFrame(0).length > 20 && Clay_GetRenderCommandDeltas().length == 0, "Deltas were reported after failing to enable them");
+
+    // With room in the arena, deltas can be enabled between frames
+    arenaErrorCount = 0;
+    Clay_SetCurrentContext(NULL);
+    Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, memory), layoutDimensions, (Clay_ErrorHandler) { HandleClayErrors });
+    Clay_SetMeasureTextFunction(MeasureText);
+    LayoutFrame(0);
+    Clay_SetRenderCommandDeltasEnabled(true);
+    CheckDeltas("Enabled between frames");
+    // Disabling and enabling them again doesn't need any more memory
+    Clay_SetRenderCommandDeltasEnabled(false);
+    LayoutFrame(0);
+    Clay_SetRenderCommandDeltasEnabled(true);
+    CheckDeltas("Enabled again");
+    Check(arenaErrorCount == 0, "Errors were reported enabling deltas with room in the arena");
+
+    // Enabled before Clay_Initialize, the fingerprints are part of the arena from the start
+    Clay_SetCurrentContext(NULL);
+    Clay_SetRenderCommandDeltasEnabled(true);
+    Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(sizeWithDeltas, memory), layoutDimensions, (Clay_ErrorHandler) { HandleClayErrors });
+    Clay_SetMeasureTextFunction(MeasureText);
+    CheckDeltas("Enabled before Clay_Initialize");
+    CheckRepeatedIdDeltas();
+    Check(arenaErrorCount == 0, "Errors were reported in an arena of Clay_MinMemorySize() with deltas enabled");
+
+    free(memory);
+    if (failures > 0) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+    return 0;
+}
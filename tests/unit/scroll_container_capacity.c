@@ -0,0 +1,82 @@
+// Checks that the scroll container capacity grows to fit however many scroll containers are declared, keeping the scroll positions
+// of existing ones, and that running out of arena memory while growing it is reported once rather than every frame.
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SCROLL_CONTAINER_COUNT 1000
+
+int failures = 0;
+int errorCount = 0;
+int arenaErrorCount = 0;
+
+void HandleClayErrors(Clay_ErrorData errorData) {
+    errorCount++;
+    if (errorData.errorType == CLAY_ERROR_TYPE_ARENA_CAPACITY_EXCEEDED) {
+        arenaErrorCount++;
+    }
+}
+
+void Check(bool condition, const char *message) {
+    if (!condition) {
+        printf("%s\n", message);
+        failures++;
+    }
+}
+
+// A column of scroll containers, each with content taller than itself
+void LayoutFrame(int scrollContainerCount) {
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("Column"), CLAY_LAYOUT({ .layoutDirection = CLAY_TOP_TO_BOTTOM })) {
+        for (int i = 0; i < scrollContainerCount; ++i) {
+            CLAY(CLAY_IDI("Scroll", i), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIXED(100), CLAY_SIZING_FIXED(20) } }), CLAY_SCROLL({ .vertical = true })) {
+                CLAY(CLAY_IDI("Content", i), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIXED(100), CLAY_SIZING_FIXED(200) } })) {}
+            }
+        }
+    }
+    Clay_EndLayout();
+}
+
+int CountFoundScrollContainers(int scrollContainerCount) {
+    int found = 0;
+    for (int i = 0; i < scrollContainerCount; ++i) {
+        found += Clay_GetScrollContainerData(Clay_GetElementIdWithIndex(CLAY_STRING("Scroll"), i)).found;
+    }
+    return found;
+}
+
+int main(void) {
+    Clay_Dimensions layoutDimensions = { 1024, 768 };
+    uint64_t initialSize = Clay_MinMemorySize();
+    uint64_t totalMemorySize = initialSize * 2;
+    void *memory = malloc(totalMemorySize);
+
+    // Scroll containers that don't fit are picked up from the next frame, without any errors
+    Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, memory), layoutDimensions, (Clay_ErrorHandler) { HandleClayErrors });
+    LayoutFrame(10);
+    Clay_GetScrollContainerData(Clay_GetElementIdWithIndex(CLAY_STRING("Scroll"), 5)).scrollPosition->y = -30;
+    LayoutFrame(SCROLL_CONTAINER_COUNT);
+    LayoutFrame(SCROLL_CONTAINER_COUNT);
+    Check(CountFoundScrollContainers(SCROLL_CONTAINER_COUNT) == SCROLL_CONTAINER_COUNT, "Not every scroll container was found after the capacity grew");
+    Check(Clay_GetScrollContainerData(Clay_GetElementIdWithIndex(CLAY_STRING("Scroll"), 5)).scrollPosition->y == -30, "A scroll position was lost when the capacity grew");
+    Check(errorCount == 0, "Errors were reported growing the scroll container capacity with room in the arena");
+    Check(Clay_MinMemorySize() > initialSize, "Clay_MinMemorySize() didn't include the grown scroll container capacity");
+
+    // Without room in the arena, the capacity stays as it was and the error is only reported once
+    Clay_SetCurrentContext(NULL);
+    Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(initialSize, memory), layoutDimensions, (Clay_ErrorHandler) { HandleClayErrors });
+    LayoutFrame(10);
+    for (int frame = 0; frame < 4; ++frame) {
+        LayoutFrame(SCROLL_CONTAINER_COUNT);
+    }
+    Check(arenaErrorCount == 1, "Running out of room to grow the scroll container capacity wasn't reported exactly once");
+    Check(CountFoundScrollContainers(10) == 10, "Scroll containers that fit before the arena ran out of room weren't kept");
+
+    free(memory);
+    if (failures > 0) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+    return 0;
+}
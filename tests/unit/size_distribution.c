@@ -0,0 +1,171 @@
+// Checks that Clay__DistributeSizeAmongChildren matches the iterative loop it replaced, which split the remaining size evenly between
+// the children over and over, clamping each child to its min and max size every pass.
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CHILD_COUNT 24
+
+int failures = 0;
+
+void HandleClayErrors(Clay_ErrorData errorData) {
+    printf("%.*s\n", errorData.errorText.length, errorData.errorText.chars);
+    failures++;
+}
+
+// Characters are 7px wide and 16px tall, so a one character label has a min width (its height) wider than the label itself
+Clay_Dimensions MeasureText(Clay_String *text, Clay_TextElementConfig *config) {
+    return (Clay_Dimensions) { (float)text->length * 7, 16 };
+}
+
+// The distribution loop as it was before it was replaced
+float Reference_DistributeSizeAmongChildren(bool xAxis, float sizeToDistribute, Clay__int32_tArray resizableContainerBuffer, Clay__SizeDistributionType distributionType) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    int32_t remainingElementsStorage[CHILD_COUNT];
+    Clay__int32_tArray remainingElements = { .capacity = CHILD_COUNT, .internalArray = remainingElementsStorage };
+    for (int i = 0; i < resizableContainerBuffer.length; ++i) {
+        Clay__int32_tArray_Add(&remainingElements, Clay__int32_tArray_Get(&resizableContainerBuffer, i));
+    }
+    while (sizeToDistribute != 0 && remainingElements.length > 0) {
+        float dividedSize = sizeToDistribute / (float)remainingElements.length;
+        for (int childOffset = 0; childOffset < remainingElements.length; childOffset++) {
+            Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_Get(&remainingElements, childOffset));
+            Clay_SizingAxis childSizing = xAxis ? childElement->layoutConfig->sizing.width : childElement->layoutConfig->sizing.height;
+            float *childSize = xAxis ? &childElement->dimensions.width : &childElement->dimensions.height;
+            float childMinSize = xAxis ? childElement->minDimensions.width : childElement->minDimensions.height;
+            bool canDistribute = true;
+            if ((sizeToDistribute < 0 && *childSize == childSizing.size.minMax.min) || (sizeToDistribute > 0 && *childSize == childSizing.size.minMax.max)) {
+                canDistribute = false;
+            } else if (distributionType == CLAY__SIZE_DISTRIBUTION_TYPE_GROW_CONTAINER && childSizing.type != CLAY__SIZING_TYPE_GROW) {
+                canDistribute = false;
+            } else if (distributionType == CLAY__SIZE_DISTRIBUTION_TYPE_SCROLL_CONTAINER && Clay__ElementHasConfig(childElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER)) {
+                Clay_ScrollElementConfig *scrollConfig = Clay__FindElementConfigWithType(childElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL_CONTAINER).scrollElementConfig;
+                canDistribute = xAxis ? scrollConfig->horizontal : scrollConfig->vertical;
+            }
+            if (!canDistribute) {
+                Clay__int32_tArray_RemoveSwapback(&remainingElements, childOffset);
+                childOffset--;
+                continue;
+            }
+            float oldChildSize = *childSize;
+            *childSize = CLAY__MAX(CLAY__MAX(CLAY__MIN(childSizing.size.minMax.max, *childSize + dividedSize), childSizing.size.minMax.min), childMinSize);
+            float diff = *childSize - oldChildSize;
+            if (diff > -0.01 && diff < 0.01) {
+                Clay__int32_tArray_RemoveSwapback(&remainingElements, childOffset);
+                childOffset--;
+                continue;
+            }
+            sizeToDistribute -= diff;
+        }
+    }
+    return (sizeToDistribute > -0.01 && sizeToDistribute < 0.01) ? 0 : sizeToDistribute;
+}
+
+uint32_t randomState = 1;
+uint32_t RandomInt(uint32_t range) {
+    randomState = randomState * 1103515245u + 12345u;
+    return (randomState >> 8) % range;
+}
+
+// Lays out a row of children with random sizing, then runs both distributions from the same random starting sizes
+void CompareRandomRow(int trial) {
+    Clay_SizingAxis sizings[CHILD_COUNT];
+    bool scrolls[CHILD_COUNT];
+    int childCount = 1 + (int)RandomInt(CHILD_COUNT);
+    for (int i = 0; i < childCount; ++i) {
+        float min = (float)RandomInt(30);
+        float max = RandomInt(3) == 0 ? min + (float)RandomInt(60) : CLAY__MAXFLOAT;
+        sizings[i] = (Clay_SizingAxis) { .size = { .minMax = { min, max } }, .type = RandomInt(2) ? CLAY__SIZING_TYPE_FIT : CLAY__SIZING_TYPE_GROW };
+        scrolls[i] = RandomInt(4) == 0;
+    }
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("Row"), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIXED(100) } })) {
+        for (int i = 0; i < childCount; ++i) {
+            if (scrolls[i]) {
+                CLAY(CLAY_IDI("Child", i), CLAY_LAYOUT({ .sizing = { sizings[i] } }), CLAY_SCROLL({ .horizontal = RandomInt(2) == 0 })) {}
+            } else {
+                CLAY(CLAY_IDI("Child", i), CLAY_LAYOUT({ .sizing = { sizings[i] } })) {}
+            }
+        }
+    }
+    Clay_EndLayout();
+
+    Clay_Context *context = Clay_GetCurrentContext();
+    int32_t childIndexes[CHILD_COUNT];
+    Clay__int32_tArray resizableContainerBuffer = { .capacity = CHILD_COUNT, .length = (uint32_t)childCount, .internalArray = childIndexes };
+    float startSizes[CHILD_COUNT], expectedSizes[CHILD_COUNT];
+    float totalSize = 0;
+    for (int i = 0; i < childCount; ++i) {
+        childIndexes[i] = (int32_t)(Clay__GetHashMapItem(Clay_GetElementIdWithIndex(CLAY_STRING("Child"), (uint32_t)i).id)->layoutElement - context->layoutElements.internalArray);
+        Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, childIndexes[i]);
+        // Sizes always start within the sizing's min and max, but some children start below their min size, as a one character label does
+        float contentSize = sizings[i].size.minMax.min + (float)RandomInt(80);
+        startSizes[i] = CLAY__MIN(contentSize, sizings[i].size.minMax.max);
+        child->minDimensions.width = RandomInt(5) == 0 ? startSizes[i] + (float)RandomInt(20) : (float)RandomInt((uint32_t)startSizes[i] + 1);
+        totalSize += startSizes[i];
+    }
+    float sizeToDistribute = -(float)(1 + RandomInt((uint32_t)totalSize + 1));
+    Clay__SizeDistributionType distributionType = RandomInt(2) ? CLAY__SIZE_DISTRIBUTION_TYPE_RESIZEABLE_CONTAINER : CLAY__SIZE_DISTRIBUTION_TYPE_SCROLL_CONTAINER;
+
+    for (int i = 0; i < childCount; ++i) {
+        Clay_LayoutElementArray_Get(&context->layoutElements, childIndexes[i])->dimensions.width = startSizes[i];
+    }
+    float expectedRemaining = Reference_DistributeSizeAmongChildren(true, sizeToDistribute, resizableContainerBuffer, distributionType);
+    for (int i = 0; i < childCount; ++i) {
+        Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, childIndexes[i]);
+        expectedSizes[i] = child->dimensions.width;
+        child->dimensions.width = startSizes[i];
+    }
+    float remaining = Clay__DistributeSizeAmongChildren(true, sizeToDistribute, resizableContainerBuffer, distributionType);
+
+    // The old loop stopped once a pass moved a child by less than 0.01, so allow for the size it left undistributed
+    float tolerance = 0.01f * (float)childCount + 0.001f;
+    bool matches = remaining - expectedRemaining < tolerance && expectedRemaining - remaining < tolerance;
+    for (int i = 0; i < childCount; ++i) {
+        float size = Clay_LayoutElementArray_Get(&context->layoutElements, childIndexes[i])->dimensions.width;
+        matches = matches && size - expectedSizes[i] < tolerance && expectedSizes[i] - size < tolerance;
+    }
+    if (!matches) {
+        printf("Trial %d: distributing %.2f among %d children left %.3f, expected %.3f\n", trial, sizeToDistribute, childCount, remaining, expectedRemaining);
+        for (int i = 0; i < childCount; ++i) {
+            Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, childIndexes[i]);
+            printf("    child %d: start %.2f min %.2f sizing %.0f-%.0f, got %.3f expected %.3f\n", i, startSizes[i], child->minDimensions.width, sizings[i].size.minMax.min, sizings[i].size.minMax.max, child->dimensions.width, expectedSizes[i]);
+        }
+        failures++;
+    }
+}
+
+// A single character label's min width is the text height, so it's wider than the label and has to be clamped up rather than shrunk
+void CheckLabelInOverflowingRow(void) {
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("Row"), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIXED(100) } })) {
+        CLAY_TEXT(CLAY_STRING("Some long label that overflows"), CLAY_TEXT_CONFIG({ .fontSize = 16 }));
+        CLAY(CLAY_ID("Badge"), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIT({}) } })) {
+            CLAY_TEXT(CLAY_STRING("1"), CLAY_TEXT_CONFIG({ .fontSize = 16 }));
+        }
+    }
+    Clay_EndLayout();
+    float badgeWidth = Clay__GetHashMapItem(Clay_GetElementId(CLAY_STRING("Badge")).id)->boundingBox.width;
+    if (badgeWidth != 16) {
+        printf("Badge is %.2fpx wide, expected 16px\n", badgeWidth);
+        failures++;
+    }
+}
+
+int main(void) {
+    uint64_t totalMemorySize = Clay_MinMemorySize();
+    Clay_Arena arena = Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, malloc(totalMemorySize));
+    Clay_Initialize(arena, (Clay_Dimensions) { 1024, 768 }, (Clay_ErrorHandler) { HandleClayErrors });
+    Clay_SetMeasureTextFunction(MeasureText);
+
+    CheckLabelInOverflowingRow();
+    for (int trial = 0; trial < 3000; ++trial) {
+        CompareRandomRow(trial);
+    }
+    if (failures > 0) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+    return 0;
+}
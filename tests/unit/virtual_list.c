@@ -0,0 +1,108 @@
+// Checks that a virtual list with items of different sizes can be scrolled back to its start after a jump without skipping items or
+// moving the visible ones, and that unlabeled items get the same ids as they would if the whole list was declared.
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ITEM_COUNT 2000
+
+int failures = 0;
+
+void HandleClayErrors(Clay_ErrorData errorData) {
+    printf("%s\n", errorData.errorText.chars);
+    failures++;
+}
+
+void Check(bool condition, const char *message) {
+    if (!condition) {
+        printf("%s\n", message);
+        failures++;
+    }
+}
+
+// The estimate of 40 is well below the average extent, so jumps land far from where the items really are
+float ItemExtent(uint32_t itemIndex, uintptr_t userData) {
+    return 20 + (float)((itemIndex * 7919) % 9) * 10;
+}
+
+// Items are unlabeled, and their index is kept in their color so it can be read back from the render commands
+Clay_RenderCommandArray LayoutFrame(bool virtualized) {
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("List"), CLAY_LAYOUT({ .layoutDirection = CLAY_TOP_TO_BOTTOM, .sizing = { CLAY_SIZING_FIXED(300), CLAY_SIZING_FIXED(400) }, .childGap = 4 }), CLAY_SCROLL({ .vertical = true })) {
+        Clay_VirtualListRange range = { 0, ITEM_COUNT };
+        if (virtualized) {
+            range = Clay_VirtualList((Clay_VirtualListConfig) { .itemCount = ITEM_COUNT, .itemExtent = 40, .itemExtentFunction = ItemExtent, .overscan = 2 });
+        }
+        for (uint32_t i = range.startIndex; i < range.endIndex; ++i) {
+            CLAY(CLAY_LAYOUT({ .sizing = { CLAY_SIZING_GROW({}), CLAY_SIZING_FIXED(ItemExtent(i, 0)) } }), CLAY_RECTANGLE({ .color = { (float)(i % 256), (float)(i / 256), 0, 255 } })) {}
+        }
+    }
+    return Clay_EndLayout();
+}
+
+uint32_t ItemIndex(Clay_RenderCommand *renderCommand) {
+    return (uint32_t)renderCommand->config.rectangleElementConfig->color.r + (uint32_t)renderCommand->config.rectangleElementConfig->color.g * 256;
+}
+
+Clay_Vector2 *ScrollPosition(void) {
+    return Clay_GetScrollContainerData(Clay_GetElementId(CLAY_STRING("List"))).scrollPosition;
+}
+
+int main(void) {
+    uint64_t totalMemorySize = Clay_MinMemorySize();
+    void *memory = malloc(totalMemorySize);
+    Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, memory), (Clay_Dimensions) { 1024, 768 }, (Clay_ErrorHandler) { HandleClayErrors });
+
+    // Culling would leave out the render commands of items that are scrolled out of view
+    static uint32_t fullListIds[ITEM_COUNT];
+    Clay_SetCullingEnabled(false);
+    Clay_RenderCommandArray renderCommands = LayoutFrame(false);
+    Clay_SetCullingEnabled(true);
+    for (int i = 0; i < renderCommands.length; ++i) {
+        if (renderCommands.internalArray[i].commandType == CLAY_RENDER_COMMAND_TYPE_RECTANGLE) {
+            fullListIds[ItemIndex(&renderCommands.internalArray[i])] = renderCommands.internalArray[i].id;
+        }
+    }
+
+    LayoutFrame(true);
+    ScrollPosition()->y = -20000;
+    LayoutFrame(true);
+    // Scroll back to the start a little at a time, checking that every item is declared on the way and that items only move with the scroll position
+    static bool declared[ITEM_COUNT];
+    static float previousY[ITEM_COUNT];
+    static bool previouslyDeclared[ITEM_COUNT];
+    uint32_t lowestDeclared = ITEM_COUNT;
+    int idMismatches = 0, movedItems = 0;
+    for (int frame = 0; frame < 2000 && lowestDeclared > 0; ++frame) {
+        ScrollPosition()->y += 30;
+        renderCommands = LayoutFrame(true);
+        for (int i = 0; i < ITEM_COUNT; ++i) {
+            previouslyDeclared[i] = declared[i];
+            declared[i] = false;
+        }
+        for (int i = 0; i < renderCommands.length; ++i) {
+            Clay_RenderCommand *renderCommand = &renderCommands.internalArray[i];
+            if (renderCommand->commandType != CLAY_RENDER_COMMAND_TYPE_RECTANGLE) {
+                continue;
+            }
+            uint32_t itemIndex = ItemIndex(renderCommand);
+            idMismatches += renderCommand->id != fullListIds[itemIndex];
+            movedItems += previouslyDeclared[itemIndex] && renderCommand->boundingBox.y != previousY[itemIndex] + 30;
+            Check(itemIndex + 3 >= lowestDeclared || lowestDeclared == ITEM_COUNT, "Items were skipped while scrolling back");
+            lowestDeclared = CLAY__MIN(lowestDeclared, itemIndex);
+            declared[itemIndex] = true;
+            previousY[itemIndex] = renderCommand->boundingBox.y;
+        }
+    }
+    Check(lowestDeclared == 0, "The first item was never reached while scrolling back");
+    Check(movedItems == 0, "Items that stayed declared didn't move with the scroll position");
+    Check(idMismatches == 0, "Unlabeled items got different ids than they would with the whole list declared");
+
+    free(memory);
+    if (failures > 0) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,53 @@
+// Checks that overlapping floating roots are hit tested in zIndex order rather than declaration order, including on frames where
+// idle frame skipping reuses the previous frame's render commands.
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+int failures = 0;
+
+void HandleClayErrors(Clay_ErrorData errorData) {
+    printf("%s\n", errorData.errorText.chars);
+    failures++;
+}
+
+void Check(bool condition, const char *message) {
+    if (!condition) {
+        printf("%s\n", message);
+        failures++;
+    }
+}
+
+// The root declared first has the higher zIndex, so it's drawn on top of the one declared after it
+void LayoutFrame(void) {
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("Page"), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_GROW({}), CLAY_SIZING_GROW({}) } })) {
+        CLAY(CLAY_ID("Top"), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIXED(100), CLAY_SIZING_FIXED(100) } }), CLAY_FLOATING({ .zIndex = 5 }), CLAY_RECTANGLE({ .color = { 255, 0, 0, 255 } })) {}
+        CLAY(CLAY_ID("Bottom"), CLAY_LAYOUT({ .sizing = { CLAY_SIZING_FIXED(100), CLAY_SIZING_FIXED(100) } }), CLAY_FLOATING({ .zIndex = 1 }), CLAY_RECTANGLE({ .color = { 0, 0, 255, 255 } })) {}
+    }
+    Clay_EndLayout();
+}
+
+int main(void) {
+    uint64_t totalMemorySize = Clay_MinMemorySize();
+    void *memory = malloc(totalMemorySize);
+    Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, memory), (Clay_Dimensions) { 1024, 768 }, (Clay_ErrorHandler) { HandleClayErrors });
+    Clay_SetIdleFrameSkippingEnabled(true);
+
+    Clay_ElementId topId = Clay_GetElementId(CLAY_STRING("Top"));
+    for (int frame = 0; frame < 3; ++frame) {
+        LayoutFrame();
+        Check(Clay_LayoutUnchanged() == (frame > 0), "Only the frames after the first were skipped");
+        Clay_SetPointerState((Clay_Vector2) { 50, 50 }, false);
+        Clay_ElementIdArraySlice pointerOverIds = Clay_GetPointerOverIds();
+        Check(pointerOverIds.length > 0 && pointerOverIds.internalArray[0].id == topId.id, "The root with the highest zIndex wasn't hit first");
+    }
+
+    free(memory);
+    if (failures > 0) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+    return 0;
+}